@@ -9,6 +9,7 @@
 */
 # pragma	once
 # include	<gtk/gtk.h>
+# include	<Filter.h>
 
 //****************************************************************************//
 //      Analyze list constants                                                //
@@ -42,7 +43,7 @@
 //****************************************************************************//
 //      Function prototypes                                                   //
 //****************************************************************************//
-gboolean AnalyzeQuotesDialog (GtkWindow *parent, GtkTreeModel *model, const gchar *fname, gint count, gfloat liquidity, gfloat volatility, gfloat price);
+gboolean AnalyzeQuotesDialog (GtkWindow *parent, GtkTreeModel *model, const gchar *fname, gint count, Filter *filter);
 /*
 ################################################################################
 #                                 END OF FILE                                  #
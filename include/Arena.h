@@ -0,0 +1,69 @@
+/*                                                                       Arena.h
+################################################################################
+# Encoding: UTF-8                                                  Tab size: 4 #
+#                                                                              #
+#                                 ARENA CLASS                                  #
+#                                                                              #
+# License: LGPLv3+                               Copyleft (Ɔ) 2014, Jack Black #
+################################################################################
+*/
+# pragma	once
+# include	<gtk/gtk.h>
+
+//****************************************************************************//
+//      Arena constants                                                       //
+//****************************************************************************//
+# define	ARENA_BLOCK_SIZE	0x40000		// Min size of arena block
+# define	ARENA_ALIGN			16			// Alignment of arena allocations
+
+//****************************************************************************//
+//      Arena block structure                                                 //
+//****************************************************************************//
+struct ArenaBlock
+{
+	ArenaBlock	*next;			// Previous arena block
+	gsize		size;			// Size of block data
+	gsize		used;			// Used bytes of block data
+};
+
+//****************************************************************************//
+//      Arena class                                                           //
+//****************************************************************************//
+//
+// Bump allocator for per-ticker batch processing. All memory taken from the
+// arena is released at once by Reset, which also merges all blocks into one
+// block, so after the first few tickers a batch runs without calls to malloc.
+//
+class Arena
+{
+private:
+	ArenaBlock	*blocks;		// Arena blocks, current block is first
+
+	// Add new block to arena
+	void AddBlock (gsize size);
+
+public:
+
+	// Constructor and destructor
+	Arena (void);
+	~Arena (void);
+
+	// Memory allocation
+	gpointer Alloc (gsize size);
+	gchar* Strdup (const gchar *string);
+	gchar* Concat (const gchar *first, ...) G_GNUC_NULL_TERMINATED;
+
+	// Load file content into arena memory
+	gchar* LoadFile (const gchar *fname, gsize *length, GError **error);
+
+	// Release all allocations
+	void Reset (void);
+
+	// Arena properties
+	gsize GetSize (void) const;
+};
+/*
+################################################################################
+#                                 END OF FILE                                  #
+################################################################################
+*/
@@ -14,6 +14,10 @@
 //      Check list constants                                                  //
 //****************************************************************************//
 # define	CHECK_COLUMNS		7				// Count of columns in check list
+# define	CHECK_MAX_THREADS	16				// Max count of check threads
+# define	CHECK_MAPPED		TRUE			// Validate mapped quote files in place (FALSE to copy and sort)
+# define	CHECK_BATCH_SIZE	64				// Max count of results added to list at once
+# define	CHECK_POLL_TIME		50000			// Time to wait for results in microseconds
 
 //============================================================================//
 //      Field ids                                                             //
@@ -40,7 +44,7 @@
 //****************************************************************************//
 //      Function prototypes                                                   //
 //****************************************************************************//
-gboolean CheckQuotesDialog (GtkWindow *parent, GtkTreeModel *model, const gchar *fname);
+gboolean CheckQuotesDialog (GtkWindow *parent, GtkTreeModel *model, const gchar *fname, gboolean mapped);
 /*
 ################################################################################
 #                                 END OF FILE                                  #
@@ -10,17 +10,39 @@
 # pragma	once
 # include	<curl/curl.h>
 # include	<gtk/gtk.h>
-# include	<Time.h>
+# include	<QuoteProvider.h>
+# include	<RateLimiter.h>
+
+//****************************************************************************//
+//      Client constants                                                      //
+//****************************************************************************//
+# define	CLIENT_CACHE_FILE		"Validators.ini"	// Validator cache file name
+# define	CLIENT_ETAG_HEADER		"ETag:"				// Entity tag response header
+# define	CLIENT_START_KEY		"start"				// Request start date cache key
+# define	CLIENT_ETAG_KEY			"etag"				// Entity tag cache key
+# define	CLIENT_MODIFIED_KEY		"modified"			// Modification time cache key
+# define	CLIENT_NOT_MODIFIED		304					// HTTP "Not modified" status
+# define	CLIENT_BAD_REQUEST		400					// First HTTP error status
+# define	CLIENT_TOO_MANY			429					// HTTP "Too many requests" status
+# define	CLIENT_SERVER_ERROR		500					// First HTTP server error status
+# define	CLIENT_BUFFER_SIZE		0x10000				// Initial capacity of reusable buffers
+# define	CLIENT_BUFFER_LIMIT		0x1000000			// Max capacity to keep between requests
 
 //****************************************************************************//
 //      Client class                                                          //
 //****************************************************************************//
-class Client
+class Client : public QuoteProvider
 {
 private:
-	quote_t	*array;			// Quotes array
-	gsize	size;			// Size of quotes array
-	CURL	*handle;		// CURL handle
+	CURL		*handle;		// CURL handle
+	gchar		*cache;			// Validator cache file name
+	GKeyFile	*validators;	// Validators of previous responses
+	RateLimiter	limiter;		// Request rate limiter
+	Accumulator	*received;		// Reusable buffer for server responses
+	Accumulator	*parsed;		// Reusable buffer for parsed quotes
+
+	// Clear reusable buffers and shrink them if they grew too much
+	void ResetBuffers (void);
 
 public:
 
@@ -28,22 +50,30 @@ public:
 	Client (void);
 	~Client (void);
 
+	// Set validator cache file
+	void SetCacheFile (const gchar *fname);
+
 	// Client initialization
 	gboolean Init (GError **error);
 
+	// Batch operations
+	gboolean Begin (const gchar* const tickers[], gsize count, GError **error);
+	gboolean End (GError **error);
+
 	// Check for quote splits
 	gboolean CheckSplits (const gchar *ticker, time_t start, time_t end, GError **error);
 
 	// Request quotes from quote server
 	gboolean GetQuotes (const gchar *ticker, time_t start, time_t end, GError **error);
 
-	// Quote list
-	QuoteList GetQuoteList (void) const;
+	// Request statistics
+	gchar* GetStatistics (void) const;
+
+	// Check if provider requests quotes from quote server
+	gboolean IsRemote (void) const;
 
-	// Quote properties
-	gint GetCount (void) const;
-	time_t GetFirstDate (void) const;
-	time_t GetLastDate (void) const;
+	// Set callback which is called while waiting between requests
+	void SetWaitFunc (GSourceFunc func, gpointer data);
 };
 /*
 ################################################################################
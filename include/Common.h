@@ -9,6 +9,9 @@
 */
 # pragma	once
 # include	<gtk/gtk.h>
+# include	<Results.h>
+# include	<Arena.h>
+# include	<Dates.h>
 
 //****************************************************************************//
 //      Global constants                                                      //
@@ -17,14 +20,15 @@
 # define	LOGO_FILE		"/usr/share/icons/hicolor/scalable/apps/stock-filter.svg"
 # define	STRING_OK		"OK"
 # define	STRING_UNKNOWN	"Unknown"
+# define	PROGRESS_TIME	33333		// Min time between progress updates in microseconds (30 Hz)
 
 //****************************************************************************//
 //      Status list structure                                                 //
 //****************************************************************************//
 struct StatusList
 {
-	GtkTreeModel	*model;			// Stock list
-	GList			*list;			// List of chosen stocks
+	Results			*results;		// Results of processed stocks
+	guint			status;			// Result status of chosen stocks
 };
 
 //****************************************************************************//
@@ -34,6 +38,7 @@ struct ProgressDialog
 {
 	GtkWindow		*window;		// Progress dialog window
 	GtkProgressBar	*progress;		// Progress bar
+	gint64			updated;		// Time of last progress update
 };
 
 //****************************************************************************//
@@ -46,11 +51,13 @@ void CountRenderFunc (GtkTreeViewColumn *column, GtkCellRenderer *cell, GtkTreeM
 void ShowStatusMessage (const gchar *message, guint context);
 void ShowErrorMessage (GtkWindow *window, const gchar *message, GError *error);
 void ShowFileErrorMessage (GtkWindow *window, const gchar *message, GError *error);
-gint GetTotalCount (GtkTreeModel *model);
 gchar* GetQuotesFile (const gchar *path, const gchar *ticker);
+gchar* GetQuotesFile (const gchar *path, const gchar *ticker, Arena *arena);
+gchar* GetQuotesPath (const gchar *path, const gchar *name);
 GtkWidget* CreateStockSummary (const gchar *ticker, const gchar *name, const gchar *country, const gchar *sector, const gchar *industry, const gchar *url, guint box_border, guint action_border);
 ProgressDialog CreateProgressDialog (GtkWindow *parent, const gchar *message, gboolean *flag);
-gboolean CreateReportDialog (GtkWindow *parent, const gchar *title, const gchar *rname, GtkTreeModel *stocks, GtkTreeModel *report, GList *good, GList *bad, GtkWidget* (*CreateList) (GtkTreeModel *model), gboolean (*SaveReport) (const gchar *fname, GtkTreeModel *model, GError **error), gint total, gint errors);
+void UpdateProgress (ProgressDialog *pwin, gint done, gint total);
+gboolean CreateReportDialog (GtkWindow *parent, const gchar *title, const gchar *rname, GtkTreeModel *report, Results *results, GtkWidget* (*CreateList) (GtkTreeModel *model), gboolean (*SaveReport) (const gchar *fname, GtkTreeModel *model, GError **error), gint total, gint errors, const gchar *details);
 /*
 ################################################################################
 #                                 END OF FILE                                  #
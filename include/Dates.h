@@ -0,0 +1,44 @@
+/*                                                                       Dates.h
+################################################################################
+# Encoding: UTF-8                                                  Tab size: 4 #
+#                                                                              #
+#                                  DATE CODEC                                  #
+#                                                                              #
+# License: LGPLv3+                               Copyleft (Ɔ) 2014, Jack Black #
+################################################################################
+*/
+# pragma	once
+# include	<gtk/gtk.h>
+# include	<Time.h>
+
+//****************************************************************************//
+//      Date codec constants                                                  //
+//****************************************************************************//
+# define	DATE_FIRST_YEAR		1900		// First year of calendar table
+# define	DATE_LAST_YEAR		2099		// Last year of calendar table
+# define	DATE_SIZE			11			// Size of ISO date string including terminating null
+
+//****************************************************************************//
+//      Function prototypes                                                   //
+//****************************************************************************//
+//
+// Dates are converted through day numbers and precomputed calendar table, so
+// every conversion takes constant time. Dates out of the table range are
+// passed to Time functions.
+
+// Convert date into time stamp
+time_t MakeDate (gint64 year, guint mon, guint day);
+
+// Extract date from time stamp
+date_struct GetDate (time_t date);
+
+// Parse date in ISO format (YYYY-MM-DD) and return count of parsed symbols
+gsize ParseDate (const gchar *string, time_t *date);
+
+// Format date in ISO format (YYYY-MM-DD) and return length of string
+gsize FormatDate (time_t date, gchar buffer[]);
+/*
+################################################################################
+#                                 END OF FILE                                  #
+################################################################################
+*/
@@ -0,0 +1,92 @@
+/*                                                                      Facets.h
+################################################################################
+# Encoding: UTF-8                                                  Tab size: 4 #
+#                                                                              #
+#                                 FACETS CLASS                                 #
+#                                                                              #
+# License: LGPLv3+                               Copyleft (Ɔ) 2014, Jack Black #
+################################################################################
+*/
+# pragma	once
+# include	<gtk/gtk.h>
+
+//****************************************************************************//
+//      Facets constants                                                      //
+//****************************************************************************//
+# define	FACETS_DATA			"facets"		// Name of facets object data
+
+//============================================================================//
+//      Facet ids                                                             //
+//============================================================================//
+# define	FACET_COLUMNS		3				// Count of facets
+# define	FACET_COUNTRY		0				// Stock country facet
+# define	FACET_SECTOR		1				// Stock sector facet
+# define	FACET_INDUSTRY		2				// Stock industry facet
+
+//****************************************************************************//
+//      Facet value structure                                                 //
+//****************************************************************************//
+struct FacetValue
+{
+	gchar		*name;			// Field value
+	guint64		*bits;			// Bits of stocks which have the value
+	guint		count;			// Count of stocks which have the value
+};
+
+//****************************************************************************//
+//      Facets class                                                          //
+//****************************************************************************//
+//
+// Every distinct country, sector and industry of stock list maps to a bitset
+// of selection indices of stocks which have the value. Stocks which match a
+// combination of facet values are found by intersection of their bitsets,
+// without reading the stock list. Facets are rebuilt lazily by the first
+// query after any change of the stock list.
+//
+class Facets
+{
+private:
+	GtkTreeModel	*model;						// Indexed stock list
+	GHashTable		*tables [FACET_COLUMNS];	// Facet values by name
+	GPtrArray		*values [FACET_COLUMNS];	// Facet values sorted by name
+	guint64			*all;						// Bits of all stocks
+	guint64			*result;					// Bits of found stocks
+	guint			words;						// Count of words in each bitset
+	guint			count;						// Count of found stocks
+	gboolean		dirty;						// Facets should be rebuilt
+
+	// Rebuild facets from stock list
+	void Build (void);
+
+	// Free facets elements
+	void Clear (void);
+
+	// Signal handler
+	static void ListChanged (GtkTreeModel *model, GtkTreePath *path, GtkTreeIter *iter, gpointer data);
+	static void RowDeleted (GtkTreeModel *model, GtkTreePath *path, gpointer data);
+
+public:
+
+	// Constructor and destructor
+	Facets (void);
+	~Facets (void);
+
+	// Attach facets to stock list which takes their ownership
+	void Attach (GtkListStore *list);
+
+	// Get values of facet sorted by name
+	const GPtrArray* GetValues (guint facet);
+
+	// Find stocks which have all required facet values (NULL matches any value)
+	guint Intersect (const gchar *names[]);
+
+	// Found stocks
+	const guint64* GetResult (void) const;
+	guint GetWords (void) const;
+	guint GetCount (void) const;
+};
+/*
+################################################################################
+#                                 END OF FILE                                  #
+################################################################################
+*/
@@ -0,0 +1,120 @@
+/*                                                                      Filter.h
+################################################################################
+# Encoding: UTF-8                                                  Tab size: 4 #
+#                                                                              #
+#                                 FILTER CLASS                                 #
+#                                                                              #
+# License: LGPLv3+                               Copyleft (Ɔ) 2014, Jack Black #
+################################################################################
+*/
+# pragma	once
+# include	<gtk/gtk.h>
+# include	<Quotes.h>
+
+//****************************************************************************//
+//      Filter constants                                                      //
+//****************************************************************************//
+# define	FILTER_STATS_EXT		".filter"	// Extension of filter statistics file
+# define	FILTER_RANKS			3			// Count of cross-sectional ranks (volume, range, change)
+
+//============================================================================//
+//      Metric functions                                                      //
+//============================================================================//
+# define	FILTER_FUNC_MEDIAN_VOL	0		// Median volume
+# define	FILTER_FUNC_VOLATILITY	1		// Median daily range in percents
+# define	FILTER_FUNC_ATR_PCT		2		// Average true range in percents of close price
+# define	FILTER_FUNC_SMA			3		// Simple moving average of close price
+# define	FILTER_FUNC_CHANGE_PCT	4		// Close price change in percents
+
+//****************************************************************************//
+//      Filter code structure                                                 //
+//****************************************************************************//
+struct FilterCode
+{
+	guint		op;				// Operation code
+	guint		arg;			// Variable id, metric slot or jump target
+	gdouble		value;			// Constant value
+};
+
+//****************************************************************************//
+//      Filter metric structure                                               //
+//****************************************************************************//
+struct FilterMetric
+{
+	guint		func;			// Metric function id
+	guint		period;			// Count of quotes to compute metric on
+};
+
+//****************************************************************************//
+//      Filter term structure                                                 //
+//****************************************************************************//
+struct FilterTerm
+{
+	gchar		*text;			// Source text of term
+	guint		start;			// First instruction of term
+	guint		end;			// Instruction after last instruction of term
+	gdouble		cost;			// Estimated evaluation cost
+	guint		checked;		// Count of checked quote lists
+	guint		passed;			// Count of passed quote lists
+	guint		rejects;		// Count of rejected quote lists in current run
+};
+
+//****************************************************************************//
+//      Filter class                                                          //
+//****************************************************************************//
+class Filter
+{
+private:
+	GArray		*code;			// Compiled code of all terms
+	GArray		*terms;			// Terms which must all be true
+	GArray		*metrics;		// Metrics used by terms
+	gdouble		*values;		// Cached metric values
+	guint		*stamps;		// Generation of cached metric values
+	gdouble		*stack;			// Evaluation stack
+	guint		generation;		// Current generation of metric cache
+	guint		evaluations;	// Count of evaluations since last reordering
+	const gdouble	*ranks;		// Cross-sectional ranks of current stock
+
+	// Remove compiled code
+	void Clear (void);
+
+	// Get metric value from cache or compute it
+	gdouble GetMetric (guint slot, QuoteList quotes);
+
+	// Evaluate single term
+	gboolean EvaluateTerm (const FilterTerm *term, QuoteList quotes);
+
+	// Order terms by cost and rejection rate
+	void Reorder (void);
+
+public:
+
+	// Constructor and destructor
+	Filter (void);
+	~Filter (void);
+
+	// Compile filter expression
+	gboolean Compile (const gchar *expression, GError **error);
+
+	// Cross-sectional ranks
+	gboolean UsesRanks (void) const;
+	void SetRanks (const gdouble ranks[]);
+
+	// Check if quotes pass filter
+	gboolean Evaluate (QuoteList quotes, const gchar **reject);
+
+	// Get metric value computed by last evaluation
+	gboolean FindMetric (guint func, guint period, gdouble *value) const;
+
+	// Term statistics loading and saving
+	gboolean LoadStatistics (const gchar *fname, GError **error);
+	gboolean SaveStatistics (const gchar *fname, GError **error) const;
+
+	// Rejection statistics of current run
+	gchar* GetStatistics (void) const;
+};
+/*
+################################################################################
+#                                 END OF FILE                                  #
+################################################################################
+*/
@@ -0,0 +1,64 @@
+/*                                                                  Indicators.h
+################################################################################
+# Encoding: UTF-8                                                  Tab size: 4 #
+#                                                                              #
+#                              ROLLING INDICATORS                              #
+#                                                                              #
+# License: LGPLv3+                               Copyleft (Ɔ) 2014, Jack Black #
+################################################################################
+*/
+# pragma	once
+# include	<gtk/gtk.h>
+# include	<Quotes.h>
+
+//****************************************************************************//
+//      Indicator constants                                                   //
+//****************************************************************************//
+
+//============================================================================//
+//      Quote fields                                                          //
+//============================================================================//
+# define	INDICATOR_OPEN			0		// Quote open price
+# define	INDICATOR_HIGH			1		// Quote high price
+# define	INDICATOR_LOW			2		// Quote low price
+# define	INDICATOR_CLOSE			3		// Quote close price
+# define	INDICATOR_ADJCLOSE		4		// Quote adjusted close price
+# define	INDICATOR_VOLUME		5		// Quote volume
+
+//****************************************************************************//
+//      Function prototypes                                                   //
+//****************************************************************************//
+//
+// All series are ordered like quote arrays: element 0 is the latest bar, and
+// element i of a rolling indicator is computed over bars i ... i + window - 1.
+// Elements which do not have enough history are set to NaN. Every indicator
+// makes a single pass from the oldest bar to the latest one and spends O(1)
+// (O(log window) for the median) per bar.
+
+// Extract quote field into series
+void GetSeries (const quote_t array[], gsize size, guint field, gdouble result[]);
+
+// Moving averages
+void SMA (const gdouble series[], gsize size, gsize window, gdouble result[]);
+void EMA (const gdouble series[], gsize size, gsize window, gdouble result[]);
+
+// Average true range
+void ATR (const quote_t array[], gsize size, gsize window, gdouble result[]);
+
+// Rolling standard deviation
+void StdDev (const gdouble series[], gsize size, gsize window, gdouble result[]);
+
+// Rolling extremes
+void RollingMin (const gdouble series[], gsize size, gsize window, gdouble result[]);
+void RollingMax (const gdouble series[], gsize size, gsize window, gdouble result[]);
+
+// Rolling median
+void RollingMedian (const gdouble series[], gsize size, gsize window, gdouble result[]);
+
+// Rolling correlation of two series
+void Correlation (const gdouble x[], const gdouble y[], gsize size, gsize window, gdouble result[]);
+/*
+################################################################################
+#                                 END OF FILE                                  #
+################################################################################
+*/
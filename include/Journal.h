@@ -0,0 +1,79 @@
+/*                                                                     Journal.h
+################################################################################
+# Encoding: UTF-8                                                  Tab size: 4 #
+#                                                                              #
+#                                 JOURNAL CLASS                                #
+#                                                                              #
+# License: LGPLv3+                               Copyleft (Ɔ) 2014, Jack Black #
+################################################################################
+*/
+# pragma	once
+# include	<gtk/gtk.h>
+
+//****************************************************************************//
+//      Journal constants                                                     //
+//****************************************************************************//
+# define	JOURNAL_FILE_NAME	"sync.journal"	// Journal file name in quotes directory
+# define	JOURNAL_BATCH		100				// Count of staged quote files to commit at once
+
+//============================================================================//
+//      Job states                                                            //
+//============================================================================//
+# define	JOURNAL_DONE		0				// Stock is synced
+# define	JOURNAL_FAILED		1				// Stock sync failed
+
+//****************************************************************************//
+//      Journal entry structure                                               //
+//****************************************************************************//
+struct JournalEntry
+{
+	guint		state;			// Job state
+	guint		attempts;		// Count of sync attempts
+	gint		count;			// Count of new quotes
+	time_t		start;			// Start date of new quotes
+	time_t		end;			// End date of new quotes
+	gchar		*message;		// Status message
+};
+
+//****************************************************************************//
+//      Journal class                                                         //
+//****************************************************************************//
+//
+// Sync jobs of one trading session. Every finished job is appended to the
+// journal file in the quotes directory as a tab separated line: session date,
+// ticker, state, attempts, quotes count, start date, end date and status
+// message. Lines are buffered and written by Flush, which the caller does only
+// after the quote files of the jobs are committed. Lines of other sessions are
+// removed from the file on opening.
+//
+class Journal
+{
+private:
+	gchar		*path;			// Journal file name
+	time_t		session;		// Trading session of journal
+	GHashTable	*entries;		// Latest job entries by ticker
+	GString		*pending;		// Lines which are not written yet
+	guint		queued;			// Count of pending lines
+
+	// Add job entry
+	void Insert (const gchar *ticker, guint state, guint attempts, gint count, time_t start, time_t end, const gchar *message);
+
+public:
+
+	// Constructor and destructor
+	Journal (void);
+	~Journal (void);
+
+	// Journal opening and writing
+	gboolean Open (const gchar *fname, time_t session, GError **error);
+	gboolean Flush (GError **error);
+
+	// Job entries
+	void Add (const gchar *ticker, guint state, guint attempts, gint count, time_t start, time_t end, const gchar *message);
+	const JournalEntry* Find (const gchar *ticker) const;
+};
+/*
+################################################################################
+#                                 END OF FILE                                  #
+################################################################################
+*/
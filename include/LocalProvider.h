@@ -0,0 +1,63 @@
+/*                                                               LocalProvider.h
+################################################################################
+# Encoding: UTF-8                                                  Tab size: 4 #
+#                                                                              #
+#                             LOCAL PROVIDER CLASS                             #
+#                                                                              #
+# License: LGPLv3+                               Copyleft (Ɔ) 2014, Jack Black #
+################################################################################
+*/
+# pragma	once
+# include	<gtk/gtk.h>
+# include	<QuoteProvider.h>
+
+//****************************************************************************//
+//      Local provider constants                                              //
+//****************************************************************************//
+# define	LOCAL_QUOTES_EXT	".csv"			// Extension of quote files
+# define	LOCAL_SPLITS_EXT	".splits"		// Extension of split files
+# define	LOCAL_BUFFER_SIZE	0x100000		// Read buffer size of bulk quotes file
+
+//****************************************************************************//
+//      Local provider class                                                  //
+//****************************************************************************//
+class LocalProvider : public QuoteProvider
+{
+private:
+	gchar		*path;			// Quotes directory or bulk quotes file
+	GHashTable	*files;			// Files found in quotes directory
+	GHashTable	*routes;		// Quotes routed by ticker from bulk quotes file
+
+	// Read bulk quotes file and route its quotes by ticker
+	gboolean RouteQuotes (const gchar* const tickers[], gsize count, GError **error);
+
+	// Get file name of ticker file
+	gchar* GetFileName (const gchar *ticker, const gchar *ext) const;
+
+public:
+
+	// Constructor and destructor
+	LocalProvider (void);
+	~LocalProvider (void);
+
+	// Set quotes directory or bulk quotes file
+	void SetPath (const gchar *name);
+
+	// Provider initialization
+	gboolean Init (GError **error);
+
+	// Batch operations
+	gboolean Begin (const gchar* const tickers[], gsize count, GError **error);
+	gboolean End (GError **error);
+
+	// Check for quote splits
+	gboolean CheckSplits (const gchar *ticker, time_t start, time_t end, GError **error);
+
+	// Read quotes from quotes directory
+	gboolean GetQuotes (const gchar *ticker, time_t start, time_t end, GError **error);
+};
+/*
+################################################################################
+#                                 END OF FILE                                  #
+################################################################################
+*/
@@ -0,0 +1,108 @@
+/*                                                                       Panel.h
+################################################################################
+# Encoding: UTF-8                                                  Tab size: 4 #
+#                                                                              #
+#                                 PANEL CLASS                                  #
+#                                                                              #
+# License: LGPLv3+                               Copyleft (Ɔ) 2014, Jack Black #
+################################################################################
+*/
+# pragma	once
+# include	<gtk/gtk.h>
+# include	<Quotes.h>
+
+//****************************************************************************//
+//      Panel constants                                                       //
+//****************************************************************************//
+# define	PANEL_FILE_NAME		"panel.dat"		// Panel file name in quotes directory
+# define	PANEL_MAGIC			"PANEL001"		// Signature of panel file
+# define	PANEL_TICKER_SIZE	16				// Max ticker size including terminating null
+# define	PANEL_DEPTH			512				// Count of dates to keep on panel rebuild
+
+//============================================================================//
+//      Panel fields                                                          //
+//============================================================================//
+# define	PANEL_FIELDS		3				// Count of fields stored in panel
+# define	PANEL_CLOSE			0				// Close price
+# define	PANEL_VOLUME		1				// Volume
+# define	PANEL_RANGE			2				// Daily range log (high / low)
+# define	PANEL_CHANGE		3				// Close price change (computed field)
+
+//****************************************************************************//
+//      Panel header structure                                                //
+//****************************************************************************//
+struct PanelHeader
+{
+	gchar		magic [8];		// Signature of panel file
+	guint32		tickers;		// Count of tickers
+	guint32		dates;			// Count of dates
+	guint32		fields;			// Count of fields per ticker
+	guint32		reserved;		// Reserved for future use
+};
+
+//****************************************************************************//
+//      Panel class                                                           //
+//****************************************************************************//
+//
+// Panel file keeps daily quotes of all stocks of stock list aligned by date.
+// File starts with the header and the ticker table. Then one row per date
+// follows in ascending date order. Each row is the date followed by columns
+// of all tickers for every field, so a cross section of the whole universe
+// on a date is a contiguous block. New dates are appended at the end, and
+// missing cells of stored dates are filled in place when later syncs bring
+// their quotes. Whole ticker column is rewritten when its quote history was
+// reset by split adjustment. Only the latest PANEL_DEPTH dates are kept.
+//
+class Panel
+{
+private:
+	GMappedFile	*file;			// Mapped panel file
+	PanelHeader	header;			// Panel header
+	const gchar	*names;			// Ticker table
+	const gchar	*rows;			// Date rows
+	gsize		rsize;			// Size of date row
+	GHashTable	*columns;		// Ticker columns
+	GHashTable	*pending;		// New date rows to append
+	GArray		*patches;		// Missing cells of stored rows to fill
+
+	// Close panel file
+	void Close (void);
+
+	// Find stored row of date
+	gint FindRow (gint64 date) const;
+
+	// Get stored cell value
+	gfloat GetCell (guint row, guint field, guint column) const;
+
+	// Get cross section of field on latest date
+	gboolean GetCrossSection (guint field, gdouble result[]) const;
+
+public:
+
+	// Constructor and destructor
+	Panel (void);
+	~Panel (void);
+
+	// Panel opening and building
+	gboolean Open (const gchar *fname, GError **error);
+	gboolean Build (const gchar *fname, const gchar* const tickers[], gsize count, GError **error);
+
+	// Incremental panel extension
+	void AddQuotes (const gchar *ticker, QuoteList quotes, gboolean reset);
+	gboolean Flush (const gchar *fname, GError **error);
+
+	// Panel queries
+	gint FindTicker (const gchar *ticker) const;
+	gboolean HasTickers (const gchar* const tickers[], gsize count) const;
+	gboolean GetRanks (guint field, gdouble result[]) const;
+
+	// Panel properties
+	guint GetTickers (void) const;
+	guint GetDates (void) const;
+	time_t GetLastDate (void) const;
+};
+/*
+################################################################################
+#                                 END OF FILE                                  #
+################################################################################
+*/
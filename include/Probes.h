@@ -0,0 +1,37 @@
+/*                                                                      Probes.h
+################################################################################
+# Encoding: UTF-8                                                  Tab size: 4 #
+#                                                                              #
+#                             STATIC TRACE PROBES                              #
+#                                                                              #
+# License: LGPLv3+                               Copyleft (Ɔ) 2014, Jack Black #
+################################################################################
+*/
+# pragma	once
+
+//****************************************************************************//
+//      Static trace probes                                                   //
+//****************************************************************************//
+//
+// USDT probes of "stockfilter" provider for perf and bpftrace. They are built
+// only if ENABLE_PROBES is defined (make ENABLE_PROBES=1) and otherwise expand
+// to nothing, so their arguments are never evaluated. Double underscore in
+// probe name is shown as dash by tracing tools: "open__start" is "open-start".
+//
+# ifdef	ENABLE_PROBES
+# include	<sys/sdt.h>
+# define	PROBE(name)						DTRACE_PROBE (stockfilter, name)
+# define	PROBE1(name, a)					DTRACE_PROBE1 (stockfilter, name, a)
+# define	PROBE2(name, a, b)				DTRACE_PROBE2 (stockfilter, name, a, b)
+# define	PROBE3(name, a, b, c)			DTRACE_PROBE3 (stockfilter, name, a, b, c)
+# else
+# define	PROBE(name)						do {} while (0)
+# define	PROBE1(name, a)					do {} while (0)
+# define	PROBE2(name, a, b)				do {} while (0)
+# define	PROBE3(name, a, b, c)			do {} while (0)
+# endif
+/*
+################################################################################
+#                                 END OF FILE                                  #
+################################################################################
+*/
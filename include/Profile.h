@@ -0,0 +1,86 @@
+/*                                                                     Profile.h
+################################################################################
+# Encoding: UTF-8                                                  Tab size: 4 #
+#                                                                              #
+#                             PROFILE INSTRUMENTATION                          #
+#                                                                              #
+# License: LGPLv3+                               Copyleft (Ɔ) 2014, Jack Black #
+################################################################################
+*/
+# pragma	once
+# include	<gtk/gtk.h>
+# include	<Writer.h>
+
+//****************************************************************************//
+//      Profile constants                                                     //
+//****************************************************************************//
+# define	PROFILE_FILE_NAME	"profile.json"	// Profile log file name in quotes directory
+# define	PROFILE_OLD_EXT		".old"			// Extension of rotated profile log
+# define	PROFILE_MAX_SIZE	0x100000		// Size of profile log to rotate it at
+
+//============================================================================//
+//      Profile stages                                                        //
+//============================================================================//
+# define	PROFILE_STAGES		7				// Count of profile stages
+# define	PROFILE_READ		0				// File open and read
+# define	PROFILE_WRITE		1				// File write
+# define	PROFILE_TRANSFER	2				// HTTP transfer
+# define	PROFILE_PARSE		3				// Quotes parsing
+# define	PROFILE_VALIDATE	4				// Quotes validation
+# define	PROFILE_STATS		5				// Statistics and filter evaluation
+# define	PROFILE_MODEL		6				// Model updates
+
+//****************************************************************************//
+//      Profile stage structure                                               //
+//****************************************************************************//
+struct ProfileStage
+{
+	gint64		time;			// Total time of stage in microseconds
+	gint64		calls;			// Count of stage calls
+	gint64		bytes;			// Amount of processed bytes
+};
+
+//****************************************************************************//
+//      Profile timer class                                                   //
+//****************************************************************************//
+//
+// Scoped timer which adds the time between its construction and destruction
+// to a profile stage. Stages are process wide and may be updated from any
+// thread, so one run of sync, check or analyze is measured as a whole.
+//
+class ProfileTimer
+{
+private:
+	guint		stage;			// Profile stage
+	gint64		start;			// Start time in microseconds
+	gsize		bytes;			// Amount of processed bytes
+
+public:
+
+	// Constructor and destructor
+	ProfileTimer (guint stage);
+	~ProfileTimer (void);
+
+	// Set amount of processed bytes
+	void SetBytes (gsize amount);
+};
+
+//****************************************************************************//
+//      Function prototypes                                                   //
+//****************************************************************************//
+
+// Stage measurements
+gint64 ProfileStart (void);
+void ProfileStop (guint stage, gint64 start, gsize bytes);
+void ResetProfile (void);
+ProfileStage GetProfileStage (guint stage);
+
+// Profile reports
+gchar* GetProfileSummary (void);
+void WriteProfile (Writer *writer);
+gboolean SaveProfile (const gchar *fname, const gchar *run, GError **error);
+/*
+################################################################################
+#                                 END OF FILE                                  #
+################################################################################
+*/
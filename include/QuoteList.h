@@ -11,11 +11,13 @@
 # include	<gtk/gtk.h>
 # include	<Quotes.h>
 # include	<Time.h>
+# include	<Dates.h>
 
 //****************************************************************************//
 //      Quote list constants                                                  //
 //****************************************************************************//
 # define	QUOTE_COLUMNS			7			// Count of columns in quote list
+# define	QUOTE_STAGE_EXT			".new"		// Extension of staged quote files
 
 //============================================================================//
 //      Field ids                                                             //
@@ -48,6 +50,10 @@ gsize ExtractVolume (const gchar *string, GError **error);
 gboolean IsQuoteCorrect (time_t date, gfloat open, gfloat high, gfloat low, gfloat close, GError **error);
 gboolean OpenQuoteList (Quotes *quotes, const gchar *fname, GError **error);
 gboolean SaveQuoteList (Quotes *quotes, const gchar *fname, GError **error);
+GPtrArray* NewStagedLists (void);
+gboolean StageQuoteList (Quotes *quotes, const gchar *fname, GPtrArray *staged, GError **error);
+gboolean CommitQuoteLists (GPtrArray *staged, GError **error);
+void RemoveStagedLists (const gchar *fname);
 gboolean ViewQuotesDialog (GtkWindow *parent, const gchar *path, const gchar *ticker, const gchar *name, const gchar *country, const gchar *sector, const gchar *industry, const gchar *url);
 gboolean EditQuotesDialog (GtkWindow *parent, const gchar *path, const gchar *ticker, const gchar *name, const gchar *country, const gchar *sector, const gchar *industry, const gchar *url);
 /*
@@ -0,0 +1,73 @@
+/*                                                               QuoteProvider.h
+################################################################################
+# Encoding: UTF-8                                                  Tab size: 4 #
+#                                                                              #
+#                             QUOTE PROVIDER CLASS                             #
+#                                                                              #
+# License: LGPLv3+                               Copyleft (Ɔ) 2014, Jack Black #
+################################################################################
+*/
+# pragma	once
+# include	<gtk/gtk.h>
+# include	<Quotes.h>
+# include	<Time.h>
+
+//****************************************************************************//
+//      Quote provider class                                                  //
+//****************************************************************************//
+class QuoteProvider
+{
+protected:
+	quote_t	*array;			// Quotes array
+	gsize	size;			// Size of quotes array
+	gboolean	unchanged;	// Quotes were not modified since previous request
+
+	// Parse quotes from CSV string buffer and keep quotes from date range
+	gboolean ParseQuotes (const gchar *buffer, time_t start, time_t end, GError **error);
+	gboolean ParseQuotes (const gchar *buffer, Accumulator *accumulator, time_t start, time_t end, GError **error);
+
+	// Check quotes and keep quotes from date range
+	gboolean SetQuotes (const quote_t *quotes, gsize count, time_t start, time_t end, GError **error);
+
+public:
+
+	// Constructor and destructor
+	QuoteProvider (void);
+	virtual ~QuoteProvider (void);
+
+	// Provider initialization
+	virtual gboolean Init (GError **error) = 0;
+
+	// Batch operations
+	virtual gboolean Begin (const gchar* const tickers[], gsize count, GError **error);
+	virtual gboolean End (GError **error);
+
+	// Check for quote splits and dividends
+	virtual gboolean CheckSplits (const gchar *ticker, time_t start, time_t end, GError **error) = 0;
+
+	// Request quotes for date range
+	virtual gboolean GetQuotes (const gchar *ticker, time_t start, time_t end, GError **error) = 0;
+
+	// Request statistics
+	virtual gchar* GetStatistics (void) const;
+
+	// Check if provider requests quotes from quote server
+	virtual gboolean IsRemote (void) const;
+
+	// Set callback which is called while waiting between requests
+	virtual void SetWaitFunc (GSourceFunc func, gpointer data);
+
+	// Quote list
+	QuoteList GetQuoteList (void) const;
+
+	// Quote properties
+	gint GetCount (void) const;
+	gboolean IsUnchanged (void) const;
+	time_t GetFirstDate (void) const;
+	time_t GetLastDate (void) const;
+};
+/*
+################################################################################
+#                                 END OF FILE                                  #
+################################################################################
+*/
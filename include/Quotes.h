@@ -11,11 +11,13 @@
 # include	<gtk/gtk.h>
 # include	<Time.h>
 # include	<Accumulator.h>
+# include	<Arena.h>
 
 //****************************************************************************//
 //      Quote constants                                                       //
 //****************************************************************************//
 # define	MIN_DATE	0x386D4380		// Min quote date to retrieve
+# define	CHECK_BLOCK	8				// Count of quotes validated at once
 
 //****************************************************************************//
 //      Stock quote structure                                                 //
@@ -40,6 +42,17 @@ struct QuoteList
 	gsize	size;			// Size of quotes array
 };
 
+//****************************************************************************//
+//      Quote summary structure                                               //
+//****************************************************************************//
+struct QuoteSummary
+{
+	gsize	count;			// Count of working day quotes
+	time_t	first;			// First quote date
+	time_t	last;			// Last quote date
+	gfloat	price;			// Last quote price
+};
+
 //****************************************************************************//
 //      Quotes class                                                          //
 //****************************************************************************//
@@ -49,6 +62,11 @@ private:
 	quote_t	*array;			// Quotes array
 	gsize	size;			// Size of quotes array
 	time_t	synctime;		// Quotes sync time
+	Arena	*arena;			// Arena for quotes memory or NULL for heap
+
+	// Quotes memory management
+	quote_t* Allocate (gsize count);
+	void Release (void);
 
 public:
 
@@ -56,12 +74,16 @@ public:
 	Quotes (void);
 	~Quotes (void);
 
+	// Take quotes memory from arena (must be set before quotes are loaded)
+	void SetArena (Arena *arena);
+
 	// Create new quote list
 	void NewList (time_t stime);
 
 	// Quote list opening and saving
 	gboolean OpenList (const gchar *fname, GError **error);
 	gboolean SaveList (const gchar *fname, GError **error);
+	gboolean WriteList (gint fd, GError **error);
 
 	// Quote list importing and exporting
 	gboolean ImportList (const gchar *fname, GError **error);
@@ -77,6 +99,7 @@ public:
 
 	// Quote properties
 	gint GetCount (void) const;
+	void SetSyncTime (time_t stime);
 	time_t GetSyncTime (void) const;
 	time_t GetFirstDate (void) const;
 	time_t GetLastDate (void) const;
@@ -90,6 +113,8 @@ public:
 //****************************************************************************//
 gsize ExtractQuotes (const gchar *buffer, Accumulator *accumulator, GError **error);
 QuoteList CheckQuotes (const quote_t *array, gsize size, GError **error);
+QuoteList CheckQuotes (const quote_t *array, gsize size, Arena *arena, GError **error);
+gboolean VerifyQuotes (const quote_t *array, gsize size, QuoteSummary *summary, GError **error);
 /*
 ################################################################################
 #                                 END OF FILE                                  #
@@ -0,0 +1,67 @@
+/*                                                                 RateLimiter.h
+################################################################################
+# Encoding: UTF-8                                                  Tab size: 4 #
+#                                                                              #
+#                              RATE LIMITER CLASS                              #
+#                                                                              #
+# License: LGPLv3+                               Copyleft (Ɔ) 2014, Jack Black #
+################################################################################
+*/
+# pragma	once
+# include	<gtk/gtk.h>
+
+//****************************************************************************//
+//      Rate limiter constants                                                //
+//****************************************************************************//
+# define	RATE_START			4.0			// Initial request rate (requests per second)
+# define	RATE_MIN			0.25		// Minimal request rate
+# define	RATE_MAX			20.0		// Maximal request rate
+# define	RATE_STEP			0.1			// Rate increment after successful request
+# define	RATE_BURST			4.0			// Maximal count of requests in a burst
+# define	RATE_BACKOFF_MIN	1.0			// Minimal backoff delay after throttling (seconds)
+# define	RATE_BACKOFF_MAX	32.0		// Maximal backoff delay after throttling (seconds)
+# define	RATE_WAIT_SLICE		50000		// Wait time slice between wait callback calls (microseconds)
+
+//****************************************************************************//
+//      Rate limiter class                                                    //
+//****************************************************************************//
+class RateLimiter
+{
+private:
+	gdouble		rate;			// Current request rate
+	gdouble		tokens;			// Available request tokens
+	gdouble		backoff;		// Current backoff delay
+	gint64		stamp;			// Time of last tokens refill
+	gint64		pause;			// Time when requests may be resumed
+	gint64		start;			// Time of first request
+	guint		requests;		// Count of sent requests
+	guint		throttled;		// Count of throttled requests
+	guint64		bytes;			// Count of received bytes
+	GSourceFunc	func;			// Callback which is called while waiting
+	gpointer	data;			// Data of wait callback
+
+public:
+
+	// Constructor
+	RateLimiter (void);
+
+	// Reset limiter state and statistics
+	void Reset (void);
+
+	// Set callback which is called while waiting and may cancel waiting
+	void SetWaitFunc (GSourceFunc func, gpointer data);
+
+	// Wait until next request is allowed
+	gboolean Wait (void);
+
+	// Adjust request rate by result of request
+	void Update (gboolean throttle, guint64 size);
+
+	// Request statistics
+	gchar* GetStatistics (void) const;
+};
+/*
+################################################################################
+#                                 END OF FILE                                  #
+################################################################################
+*/
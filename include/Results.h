@@ -0,0 +1,56 @@
+/*                                                                     Results.h
+################################################################################
+# Encoding: UTF-8                                                  Tab size: 4 #
+#                                                                              #
+#                                RESULTS CLASS                                 #
+#                                                                              #
+# License: LGPLv3+                               Copyleft (Ɔ) 2014, Jack Black #
+################################################################################
+*/
+# pragma	once
+# include	<gtk/gtk.h>
+
+//****************************************************************************//
+//      Result status codes                                                   //
+//****************************************************************************//
+# define	RESULT_GOOD		0				// Stock was processed successfully
+# define	RESULT_BAD		1				// Stock was processed with errors
+
+//****************************************************************************//
+//      Result structure                                                      //
+//****************************************************************************//
+struct Result
+{
+	guint		index;			// Selection index of stock
+	guint		status;			// Result status code
+};
+
+//****************************************************************************//
+//      Results class                                                         //
+//****************************************************************************//
+class Results
+{
+private:
+	GArray		*array;			// Array of results
+
+public:
+
+	// Constructor and destructor
+	Results (void);
+	~Results (void);
+
+	// Add new result
+	void Add (guint index, guint status);
+
+	// Remove all results
+	void Clear (void);
+
+	// Result properties
+	guint GetSize (void) const;
+	const Result* GetResult (guint number) const;
+};
+/*
+################################################################################
+#                                 END OF FILE                                  #
+################################################################################
+*/
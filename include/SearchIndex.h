@@ -0,0 +1,79 @@
+/*                                                                 SearchIndex.h
+################################################################################
+# Encoding: UTF-8                                                  Tab size: 4 #
+#                                                                              #
+#                               SEARCH INDEX CLASS                             #
+#                                                                              #
+# License: LGPLv3+                               Copyleft (Ɔ) 2014, Jack Black #
+################################################################################
+*/
+# pragma	once
+# include	<gtk/gtk.h>
+
+//****************************************************************************//
+//      Search index constants                                                //
+//****************************************************************************//
+# define	SEARCH_COLUMNS		5				// Count of searchable columns
+# define	SEARCH_INDEX_DATA	"search-index"	// Name of search index object data
+
+//****************************************************************************//
+//      Search entry structure                                                //
+//****************************************************************************//
+struct SearchEntry
+{
+	const gchar	*value;			// Case folded field value
+	guint		index;			// Selection index of stock
+};
+
+//****************************************************************************//
+//      Search index class                                                    //
+//****************************************************************************//
+//
+// Case folded values of searchable stock fields, sorted by value for every
+// column. Patterns without wildcards and patterns with the only trailing '*'
+// are found by binary search of prefix range. Other glob-style patterns are
+// matched against folded values without reading the stock list. Index is
+// rebuilt lazily by the first search after any change of the stock list.
+//
+class SearchIndex
+{
+private:
+	GtkTreeModel	*model;						// Indexed stock list
+	GStringChunk	*strings;					// Storage of folded values
+	GArray			*entries [SEARCH_COLUMNS];	// Sorted search entries of columns
+	GArray			*matches;					// Selection indices of found stocks
+	GByteArray		*flags;						// Match flags by selection index
+	gboolean		dirty;						// Index should be rebuilt
+
+	// Rebuild index from stock list
+	void Build (void);
+
+	// Add found stock
+	void AddMatch (guint index);
+
+	// Signal handler
+	static void ListChanged (GtkTreeModel *model, GtkTreePath *path, GtkTreeIter *iter, gpointer data);
+	static void RowDeleted (GtkTreeModel *model, GtkTreePath *path, gpointer data);
+
+public:
+
+	// Constructor and destructor
+	SearchIndex (void);
+	~SearchIndex (void);
+
+	// Attach search index to stock list which takes its ownership
+	void Attach (GtkListStore *list);
+
+	// Find stocks by glob-style pattern and return count of found stocks
+	guint Find (guint column, const gchar *pattern);
+	void Clear (void);
+
+	// Found stocks
+	const GArray* GetMatches (void) const;
+	gboolean IsMatch (guint index) const;
+};
+/*
+################################################################################
+#                                 END OF FILE                                  #
+################################################################################
+*/
@@ -0,0 +1,64 @@
+/*                                                                   Selection.h
+################################################################################
+# Encoding: UTF-8                                                  Tab size: 4 #
+#                                                                              #
+#                               SELECTION CLASS                                #
+#                                                                              #
+# License: LGPLv3+                               Copyleft (Ɔ) 2014, Jack Black #
+################################################################################
+*/
+# pragma	once
+# include	<gtk/gtk.h>
+
+//****************************************************************************//
+//      Selection class                                                       //
+//****************************************************************************//
+class Selection
+{
+private:
+	guint64		*marks;			// Bits of selected rows
+	guint64		*rows;			// Bits of existing rows
+	guint		size;			// Count of row indices
+	guint		words;			// Count of allocated words in each bitset
+	guint		count;			// Count of selected rows
+
+	// Reserve space for row indices
+	void Reserve (guint capacity);
+
+	// Count selected rows
+	void Recount (void);
+
+public:
+
+	// Constructor and destructor
+	Selection (void);
+	~Selection (void);
+
+	// Set count of rows and clear selection
+	void Resize (guint rcount);
+
+	// Add new unselected row and get its index
+	guint Append (void);
+
+	// Remove row from selection
+	void Remove (guint index);
+
+	// Row state
+	gboolean Get (guint index) const;
+	void Set (guint index, gboolean state);
+
+	// Batch operations
+	void SelectAll (void);
+	void UnselectAll (void);
+	void Invert (void);
+	void Assign (const guint64 bits[], guint bwords);
+
+	// Selection properties
+	guint GetCount (void) const;
+	guint GetSize (void) const;
+};
+/*
+################################################################################
+#                                 END OF FILE                                  #
+################################################################################
+*/
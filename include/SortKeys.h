@@ -0,0 +1,76 @@
+/*                                                                    SortKeys.h
+################################################################################
+# Encoding: UTF-8                                                  Tab size: 4 #
+#                                                                              #
+#                                SORT KEYS CLASS                               #
+#                                                                              #
+# License: LGPLv3+                               Copyleft (Ɔ) 2014, Jack Black #
+################################################################################
+*/
+# pragma	once
+# include	<gtk/gtk.h>
+
+//****************************************************************************//
+//      Sort keys constants                                                   //
+//****************************************************************************//
+# define	SORT_COLUMNS		6				// Count of text columns with sort keys
+# define	SORT_NONE			-1				// No secondary sort column
+# define	SORT_KEYS_DATA		"sort-keys"		// Name of sort keys object data
+
+//****************************************************************************//
+//      Sort column structure                                                 //
+//****************************************************************************//
+class SortKeys;
+struct SortColumn
+{
+	SortKeys	*keys;			// Sort keys object
+	guint		column;			// Sort column id
+};
+
+//****************************************************************************//
+//      Sort keys class                                                       //
+//****************************************************************************//
+//
+// Collation keys of text columns of stock list. Keys are made lazily by first
+// sort by a column and are kept by row selection index, so sort compares keys
+// by strcmp instead of collating strings again on every comparison. Row keys
+// should be dropped before the row is changed, because sorted list moves the
+// changed row before it emits "row-changed" signal. Equal keys are ordered by
+// secondary column and then by row index, so sort results do not depend on
+// previous row order.
+//
+class SortKeys
+{
+private:
+	GPtrArray	*keys [SORT_COLUMNS];		// Collation keys by row index
+	SortColumn	columns [SORT_COLUMNS];		// Sort function data of columns
+	gint		secondary;					// Secondary sort column
+
+	// Get collation key of row
+	const gchar* GetKey (GtkTreeModel *model, GtkTreeIter *iter, guint index, guint column);
+
+	// Sort function and signal handler
+	static gint Compare (GtkTreeModel *model, GtkTreeIter *a, GtkTreeIter *b, gpointer data);
+	static void RowChanged (GtkTreeModel *model, GtkTreePath *path, GtkTreeIter *iter, gpointer data);
+
+public:
+
+	// Constructor and destructor
+	SortKeys (void);
+	~SortKeys (void);
+
+	// Attach sort keys to stock list which takes their ownership
+	void Attach (GtkListStore *list);
+
+	// Drop keys of changed row
+	void Invalidate (guint index);
+	static void Invalidate (GtkTreeModel *model, GtkTreeIter *iter);
+
+	// Set secondary sort column
+	void SetSecondary (gint column);
+};
+/*
+################################################################################
+#                                 END OF FILE                                  #
+################################################################################
+*/
@@ -36,6 +36,7 @@
 # define	MENU_EDIT_INVERT_SELECTION	"I_nvert selection"	// "Invert selection" menu button
 # define	MENU_EDIT_UNSELECT_ALL		"_Unselect All"		// "Unselect All" menu button
 # define	MENU_EDIT_FIND				"_Find"				// "Find" menu button
+# define	MENU_EDIT_FACETS			"Fa_cets"			// "Facets" menu button
 # define	MENU_EDIT_SORT				"_Sort"				// "Sort" menu button
 
 //============================================================================//
@@ -44,6 +45,8 @@
 # define	MENU_STOCKS_INFO			"_Info"				// "Info" menu button
 # define	MENU_STOCKS_CHECK			"_Check"			// "Check" menu button
 # define	MENU_STOCKS_SYNC			"_Sync"				// "Sync" menu button
+# define	MENU_STOCKS_SYNC_LOCAL		"Sync from _folder"	// "Sync from folder" menu button
+# define	MENU_STOCKS_BULK_IMPORT		"_Bulk import"		// "Bulk import" menu button
 # define	MENU_STOCKS_ANALYZE			"Analy_ze"			// "Analyze" menu button
 
 //============================================================================//
@@ -91,7 +94,7 @@
 # define	STOCK_SECTOR_ID			3			// Stock sector field id
 # define	STOCK_INDUSTRY_ID		4			// Stock industry field id
 # define	STOCK_URL_ID			5			// Stock URL field id
-# define	STOCK_CHECK_ID			6			// Check button field id
+# define	STOCK_INDEX_ID			6			// Selection index field id
 
 //============================================================================//
 //      Field names                                                           //
@@ -109,6 +112,12 @@
 //****************************************************************************//
 gboolean CheckField (const gchar *string, const gchar *field, GError **error);
 gboolean UnselectAllStocks (void);
+gboolean GetStockState (GtkTreeModel *model, GtkTreeIter *iter);
+void SetStockState (GtkTreeModel *model, GtkTreeIter *iter, gboolean state);
+gboolean IsStockMarked (guint index);
+void MarkStock (guint index, gboolean state);
+gint GetSelectedCount (void);
+void RedrawStocks (void);
 /*
 ################################################################################
 #                                 END OF FILE                                  #
@@ -9,6 +9,7 @@
 */
 # pragma	once
 # include	<gtk/gtk.h>
+# include	<Selection.h>
 
 //****************************************************************************//
 //      Stocks class                                                          //
@@ -18,6 +19,7 @@ class Stocks
 private:
 	GtkListStore	*list;			// Stock list
 	gchar			*timezone;		// Stock time zone
+	Selection		selection;		// Selected stocks
 
 public:
 
@@ -42,6 +44,7 @@ public:
 	// Stock properties
 	GtkListStore* GetStockList (void) const;
 	gchar* GetTimeZone (void) const;
+	Selection* GetSelection (void);
 };
 /*
 ################################################################################
@@ -9,11 +9,13 @@
 */
 # pragma	once
 # include	<gtk/gtk.h>
+# include	<QuoteProvider.h>
 
 //****************************************************************************//
 //      Sync list constants                                                   //
 //****************************************************************************//
 # define	SYNC_COLUMNS		5				// Count of columns in sync list
+# define	SYNC_ATTEMPTS		4				// Maximal count of sync attempts per stock
 
 //============================================================================//
 //      Field ids                                                             //
@@ -36,7 +38,7 @@
 //****************************************************************************//
 //      Function prototypes                                                   //
 //****************************************************************************//
-gboolean SyncQuotesDialog (GtkWindow *parent, GtkTreeModel *model, const gchar *fname, const gchar *tzone);
+gboolean SyncQuotesDialog (GtkWindow *parent, GtkTreeModel *model, const gchar *fname, const gchar *tzone, QuoteProvider *provider);
 /*
 ################################################################################
 #                                 END OF FILE                                  #
@@ -0,0 +1,61 @@
+/*                                                             TradingCalendar.h
+################################################################################
+# Encoding: UTF-8                                                  Tab size: 4 #
+#                                                                              #
+#                            TRADING CALENDAR CLASS                            #
+#                                                                              #
+# License: LGPLv3+                               Copyleft (Ɔ) 2014, Jack Black #
+################################################################################
+*/
+# pragma	once
+# include	<gtk/gtk.h>
+# include	<Time.h>
+
+//****************************************************************************//
+//      Trading calendar constants                                            //
+//****************************************************************************//
+# define	CALENDAR_CLOSE_TIME		57600		// Session close time (16:00) from midnight
+# define	CALENDAR_SETTLE_TIME	7200		// Delay for end of day quotes to be published
+# define	CALENDAR_HOLIDAYS		10			// Max count of exchange holidays in a year
+
+//****************************************************************************//
+//      Trading calendar class                                                //
+//****************************************************************************//
+//
+// Trading days of the exchange for the stock list time zone. US Eastern time
+// zones get NYSE holiday rules (observed fixed holidays, Monday holidays, Good
+// Friday and Thanksgiving), other time zones get week ends only. Holidays are
+// computed for one year at a time and cached. All time stamps are local time
+// of the time zone, like TimeZone::GetCurrentTime returns.
+//
+class TradingCalendar
+{
+private:
+	gboolean	exchange;		// Exchange holidays are known for time zone
+	gint64		year;			// Year of holiday table
+	guint		count;			// Count of holidays in table
+	time_t		holidays [CALENDAR_HOLIDAYS];	// Holiday dates of year
+
+	// Compute holidays of year
+	void SetYear (gint64 year);
+
+public:
+
+	// Constructor
+	TradingCalendar (void);
+
+	// Select exchange rules by time zone file name
+	void Init (const gchar *tzone);
+
+	// Trading days
+	gboolean IsTradingDay (time_t date);
+	time_t GetLatestSession (time_t time);
+
+	// Check if stored quotes already have latest session
+	gboolean IsCovered (time_t last, time_t synctime, time_t time);
+};
+/*
+################################################################################
+#                                 END OF FILE                                  #
+################################################################################
+*/
@@ -0,0 +1,94 @@
+/*                                                                      Writer.h
+################################################################################
+# Encoding: UTF-8                                                  Tab size: 4 #
+#                                                                              #
+#                                 WRITER CLASS                                 #
+#                                                                              #
+# License: LGPLv3+                               Copyleft (Ɔ) 2014, Jack Black #
+################################################################################
+*/
+# pragma	once
+# include	<gtk/gtk.h>
+
+//****************************************************************************//
+//      Writer constants                                                      //
+//****************************************************************************//
+# define	WRITER_BUFFER_SIZE	0x10000		// Size of writer buffer
+# define	WRITER_FIELD_SIZE	64			// Max size of formatted number or date
+# define	WRITER_TEMP_EXT		".tmp"		// Extension of temporary file
+# define	WRITER_MAX_DIGITS	9			// Max count of fraction digits
+# define	WRITER_EXACT_LIMIT	4503599627370496.0	// Max scaled number formatted without printf (2^52)
+
+//============================================================================//
+//      Writer formats                                                        //
+//============================================================================//
+# define	WRITER_TSV			0			// Tab separated values
+# define	WRITER_CSV			1			// Comma separated values
+# define	WRITER_BINARY		2			// Raw binary records
+
+//****************************************************************************//
+//      Writer class                                                          //
+//****************************************************************************//
+//
+// Streaming writer for exports and reports. Rows are formatted into a fixed
+// buffer, which is flushed to the file descriptor when it is full. Data goes
+// to temporary file, which replaces target file only when it is closed without
+// errors. Write errors are kept and reported by Close.
+//
+class Writer
+{
+private:
+	gchar		*fname;			// Target file name
+	gchar		*temp;			// Temporary file name
+	gint		fd;				// Temporary file descriptor
+	gint		errnum;			// Error number of first failed write
+	guint		format;			// Writer format
+	gboolean	first;			// Next field is first field of row
+	gsize		size;			// Used bytes of buffer
+	gchar		buffer [WRITER_BUFFER_SIZE];	// Writer buffer
+
+	// Flush buffer into file
+	void Flush (void);
+
+	// Reserve space into buffer
+	gchar* Reserve (gsize bytes);
+
+	// Start new field
+	void StartField (void);
+
+	// Free writer elements
+	void Free (void);
+
+public:
+
+	// Constructor and destructor
+	Writer (void);
+	~Writer (void);
+
+	// Get writer format from file extension
+	static guint GetFormat (const gchar *fname);
+	static guint GetTextFormat (const gchar *fname);
+
+	// File opening and closing
+	gboolean Open (const gchar *fname, guint format, GError **error);
+	gboolean Close (GError **error);
+
+	// Text fields
+	void AddString (const gchar *string);
+	void AddDate (time_t date);
+
+	// Number fields
+	void AddInt (gint64 value);
+	void AddNumber (gdouble value, guint digits);
+
+	// Raw binary data
+	void AddData (gconstpointer data, gsize bytes);
+
+	// End of row
+	void EndRow (void);
+};
+/*
+################################################################################
+#                                 END OF FILE                                  #
+################################################################################
+*/
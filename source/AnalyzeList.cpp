@@ -8,9 +8,14 @@
 ################################################################################
 */
 # include	<Common.h>
+# include	<Writer.h>
+# include	<Profile.h>
+# include	<Probes.h>
 # include	<Quotes.h>
 # include	<StockList.h>
 # include	<AnalyzeList.h>
+# include	<Panel.h>
+# include	<Math.h>
 
 //****************************************************************************//
 //      Analyze result structure                                              //
@@ -29,8 +34,11 @@ struct AnalyzeResult
 //****************************************************************************//
 //      Analyze stock quotes for trading                                      //
 //****************************************************************************//
-static AnalyzeResult AnalyzeQuotes (const gchar *fname, const gchar* ticker, gint min_count, gsize min_liquidity, gfloat min_volatility, gfloat min_price, GError **error)
+static AnalyzeResult AnalyzeQuotes (const gchar *fname, const gchar* ticker, gint min_count, Filter *filter, Arena *arena, GError **error)
 {
+	// Trace start of stock analysis
+	PROBE1 (analyze__start, ticker);
+
 	// Init result structure
 	AnalyzeResult result = {
 		static_cast <gboolean> (FALSE),
@@ -43,64 +51,48 @@ static AnalyzeResult AnalyzeQuotes (const gchar *fname, const gchar* ticker, gin
 	};
 
 	// Get quotes file name
-	gchar* path = GetQuotesFile (fname, ticker);
+	gchar* path = GetQuotesFile (fname, ticker, arena);
 
-	// Create quotes object
+	// Create quotes object which takes memory from arena
 	Quotes quotes;
+	quotes.SetArena (arena);
 
 	// Try to open quotes
 	if (quotes.OpenList (path, error))
 	{
-		// Get stock details
+		// Get cheap stock details
 		result.date = quotes.GetLastDate ();
 		result.sync = quotes.GetSyncTime ();
 		result.count = quotes.GetCount ();
-		result.liquidity = quotes.GetLiquidity (min_count);
-		result.volatility = quotes.GetVolatility (min_count);
 		result.price = quotes.GetLastPrice ();
 
-		// Check quotes count
-		if (result.count >= min_count)
+		// Measure filter evaluation time
+		ProfileTimer timer (PROFILE_STATS);
+		timer.SetBytes (result.count * sizeof (quote_t));
+
+		// Check stock quotes with compiled filter
+		const gchar *reject = NULL;
+		if (filter -> Evaluate (quotes.GetQuoteList (), &reject))
 		{
-			// Check stock liquidity
-			if (result.liquidity >= min_liquidity)
-			{
-				// Check stock volatility
-				if (result.volatility >= min_volatility)
-				{
-					// Check stock price
-					if (result.price >= min_price)
-					{
-						// Set result status
-						result.status = TRUE;
-					}
-					else
-					{
-						// Set error message
-						g_set_error (error, G_FILE_ERROR, G_FILE_ERROR_IO, "Filtered out by stock price");
-					}
-				}
-				else
-				{
-					// Set error message
-					g_set_error (error, G_FILE_ERROR, G_FILE_ERROR_IO, "Filtered out by stock volatility");
-				}
-			}
-			else
-			{
-				// Set error message
-				g_set_error (error, G_FILE_ERROR, G_FILE_ERROR_IO, "Filtered out by stock liquidity");
-			}
+			// Set result status
+			result.status = TRUE;
 		}
 		else
 		{
 			// Set error message
-			g_set_error (error, G_FILE_ERROR, G_FILE_ERROR_IO, "Filtered out by quotes count");
+			g_set_error (error, G_FILE_ERROR, G_FILE_ERROR_IO, "Filtered out by %s", reject);
 		}
+
+		// Get expensive stock details only if filter computed them
+		gdouble value;
+		if (filter -> FindMetric (FILTER_FUNC_MEDIAN_VOL, min_count, &value))
+			result.liquidity = value;
+		if (filter -> FindMetric (FILTER_FUNC_VOLATILITY, min_count, &value))
+			result.volatility = value * 0.01;
 	}
 
-	// Free temporary string buffer
-	g_free (path);
+	// Trace end of stock analysis
+	PROBE3 (analyze__done, ticker, result.status, result.count);
 
 	// Normal exit
 	return result;
@@ -111,14 +103,24 @@ static AnalyzeResult AnalyzeQuotes (const gchar *fname, const gchar* ticker, gin
 //****************************************************************************//
 static gboolean SaveAnalyzeReport (const gchar *fname, GtkTreeModel *model, GError **error)
 {
-	// Create string buffer
-	GString *string = g_string_new (NULL);
+	// Try to open report file
+	Writer writer;
+	if (!writer.Open (fname, Writer::GetTextFormat (fname), error))
+		return FALSE;
 
 	// Check if report is set
 	if (model)
 	{
 		// Append report header
-		g_string_append_printf (string, ANALYZE_TICKER_LABEL "\t" ANALYZE_DATE_LABEL "\t" ANALYZE_SYNC_LABEL "\t" ANALYZE_QUOTES_LABEL "\t" ANALYZE_LIQUIDITY_LABEL "\t" ANALYZE_VOLATILITY_LABEL "\t" ANALYZE_PRICE_LABEL "\t" ANALYZE_STATUS_LABEL "\n");
+		writer.AddString (ANALYZE_TICKER_LABEL);
+		writer.AddString (ANALYZE_DATE_LABEL);
+		writer.AddString (ANALYZE_SYNC_LABEL);
+		writer.AddString (ANALYZE_QUOTES_LABEL);
+		writer.AddString (ANALYZE_LIQUIDITY_LABEL);
+		writer.AddString (ANALYZE_VOLATILITY_LABEL);
+		writer.AddString (ANALYZE_PRICE_LABEL);
+		writer.AddString (ANALYZE_STATUS_LABEL);
+		writer.EndRow ();
 
 		// Get iterator position
 		GtkTreeIter iter;
@@ -134,24 +136,41 @@ static gboolean SaveAnalyzeReport (const gchar *fname, GtkTreeModel *model, GErr
 				gfloat volatility, price;
 				gtk_tree_model_get (GTK_TREE_MODEL (model), &iter, ANALYZE_TICKER_ID, &ticker, ANALYZE_DATE_ID, &date, ANALYZE_SYNC_ID, &sync, ANALYZE_QUOTES_ID, &count, ANALYZE_LIQUIDITY_ID, &liquidity, ANALYZE_VOLATILITY_ID, &volatility, ANALYZE_PRICE_ID, &price, ANALYZE_STATUS_ID, &status, -1);
 
-				// Append quote information into string buffer
-				date_struct ldate = Time::ExtractDate (date);
-				date_struct sdate = Time::ExtractDate (sync);
-				g_string_append_printf (string, "%s\t%.4i-%.2d-%.2d\t%.4i-%.2d-%.2d\t%i\t%lli\t%.6f\t%.2f\t%s\n", ticker, ldate.year, ldate.mon, ldate.day, sdate.year, sdate.mon, sdate.day, count, liquidity, volatility, price, status);
+				// Append quote information into report
+				writer.AddString (ticker);
+				writer.AddDate (date);
+				writer.AddDate (sync);
+				writer.AddInt (count);
+
+				// Leave metrics blank if filter did not compute them
+				if (liquidity == static_cast <gsize> (-1))
+					writer.AddString ("");
+				else
+					writer.AddInt (liquidity);
+				if (volatility < 0)
+					writer.AddString ("");
+				else
+					writer.AddNumber (volatility, 6);
+
+				// Append rest of quote information into report
+				writer.AddNumber (price, 2);
+				writer.AddString (status);
+				writer.EndRow ();
+
+				// Free temporary string buffers
+				g_free (ticker);
+				g_free (status);
 
 				// Change iterator position to next element
 			} while (gtk_tree_model_iter_next (GTK_TREE_MODEL (model), &iter));
 		}
-	}
 
-	// Try to save string buffer into file
-	gboolean status = g_file_set_contents (fname, string -> str, string -> len, error);
-
-	// Relase string buffer
-	g_string_free (string, TRUE);
+		// Append stage measurements of run
+		WriteProfile (&writer);
+	}
 
-	// Return file operation status
-	return status;
+	// Close report file
+	return writer.Close (error);
 }
 
 //****************************************************************************//
@@ -283,7 +302,7 @@ static GtkWidget* CreateAnalyzeList (GtkTreeModel *model)
 //****************************************************************************//
 //      Analyze quotes dialog                                                 //
 //****************************************************************************//
-gboolean AnalyzeQuotesDialog (GtkWindow *parent, GtkTreeModel *model, const gchar *fname, gint count, gfloat liquidity, gfloat volatility, gfloat price)
+gboolean AnalyzeQuotesDialog (GtkWindow *parent, GtkTreeModel *model, const gchar *fname, gint count, Filter *filter)
 {
 	// Operation status
 	gboolean status = FALSE;
@@ -295,15 +314,70 @@ gboolean AnalyzeQuotesDialog (GtkWindow *parent, GtkTreeModel *model, const gcha
 		// Create new analyze list
 		GtkListStore *list = gtk_list_store_new (ANALYZE_COLUMNS, G_TYPE_STRING, G_TYPE_INT64, G_TYPE_INT64, G_TYPE_INT, G_TYPE_UINT64, G_TYPE_FLOAT, G_TYPE_FLOAT, G_TYPE_STRING);
 
-		// Create good and bad lists
-		GList *good = NULL;
-		GList *bad = NULL;
+		// Create results of processed stocks
+		Results results;
+
+		// Create arena for per-stock memory
+		Arena arena;
+
+		// Clear stage measurements of previous run
+		ResetProfile ();
+
+		// Load term statistics of previous runs to check selective terms first
+		gchar *sname = g_strconcat (fname, FILTER_STATS_EXT, NULL);
+		filter -> LoadStatistics (sname, NULL);
+
+		// Create cross-sectional ranks of all stocks
+		Panel panel;
+		gdouble *franks [FILTER_RANKS] = {NULL};
+
+		// Load ranks from stock panel if filter uses them
+		if (filter -> UsesRanks ())
+		{
+			// Create error object
+			GError *error = NULL;
+
+			// Copy tickers of all stocks, so panel is built without stock model
+			GPtrArray *tickers = g_ptr_array_new_with_free_func (g_free);
+			do {
+				gchar *ticker;
+				gtk_tree_model_get (GTK_TREE_MODEL (model), &iter, STOCK_TICKER_ID, &ticker, -1);
+				g_ptr_array_add (tickers, ticker);
+			} while (gtk_tree_model_iter_next (GTK_TREE_MODEL (model), &iter));
+
+			// Restore iterator position
+			gtk_tree_model_get_iter_first (GTK_TREE_MODEL (model), &iter);
+
+			// Open stock panel or rebuild it from quote files if set of tickers was changed
+			const gchar* const *names = reinterpret_cast <const gchar* const*> (tickers -> pdata);
+			gboolean ready = panel.Open (fname, NULL) && panel.HasTickers (names, tickers -> len);
+			ready = ready || panel.Build (fname, names, tickers -> len, &error);
+
+			// Release array of tickers
+			g_ptr_array_free (tickers, TRUE);
+
+			// Check if stock panel is ready
+			if (!ready)
+				ShowErrorMessage (parent, "Can not build stock panel", error);
+			else
+			{
+				// Compute ranks of all stocks in single pass per field
+				static const guint fields [FILTER_RANKS] = {PANEL_VOLUME, PANEL_RANGE, PANEL_CHANGE};
+				for (gint k = 0; k < FILTER_RANKS; k++)
+				{
+					franks[k] = g_new (gdouble, panel.GetTickers () + 1);
+					if (!panel.GetRanks (fields[k], franks[k]))
+						for (guint j = 0; j < panel.GetTickers (); j++)
+							franks[k][j] = M_NAN;
+				}
+			}
+		}
 
 		// Get stocks count
 		gint records = 0;
 		gint errors = 0;
 		gint i = 0;
-		gint size = GetTotalCount (GTK_TREE_MODEL (model));
+		gint size = GetSelectedCount ();
 
 		// Create progress dialog
 		gboolean terminate = FALSE;
@@ -312,25 +386,32 @@ gboolean AnalyzeQuotesDialog (GtkWindow *parent, GtkTreeModel *model, const gcha
 		// Iterate through all elements
 		do {
 			// Get stock details
-			gboolean state;
+			guint index;
 			gchar *ticker, *status = NULL;
-			gtk_tree_model_get (GTK_TREE_MODEL (model), &iter, STOCK_CHECK_ID, &state, STOCK_TICKER_ID, &ticker, -1);
+			gtk_tree_model_get (GTK_TREE_MODEL (model), &iter, STOCK_TICKER_ID, &ticker, STOCK_INDEX_ID, &index, -1);
 
 			// Check if stock is marked
-			if (state)
+			if (IsStockMarked (index))
 			{
 				// Create error object
 				GError *error = NULL;
 
+				// Set cross-sectional ranks of stock
+				gdouble ranks [FILTER_RANKS];
+				gint column = panel.FindTicker (ticker);
+				for (gint k = 0; k < FILTER_RANKS; k++)
+					ranks[k] = (column >= 0 && franks[k]) ? franks[k][column] : M_NAN;
+				filter -> SetRanks (ranks);
+
 				// Analyze quotes
-				AnalyzeResult result = AnalyzeQuotes (fname, ticker, count, liquidity, volatility, price, &error);
+				AnalyzeResult result = AnalyzeQuotes (fname, ticker, count, filter, &arena, &error);
 				if (!result.status)
 				{
 					// Set status message
 					status = g_strdup (error -> message);
 
-					// Append new element to reference list
-					bad = g_list_append (bad, gtk_tree_row_reference_new (GTK_TREE_MODEL (model), gtk_tree_model_get_path (GTK_TREE_MODEL (model), &iter)));
+					// Add stock to results
+					results.Add (index, RESULT_BAD);
 
 					// Release error object
 					g_error_free (error);
@@ -343,23 +424,23 @@ gboolean AnalyzeQuotesDialog (GtkWindow *parent, GtkTreeModel *model, const gcha
 					// Set status message
 					status = g_strdup (STRING_OK);
 
-					// Append new element to reference list
-					good = g_list_append (good, gtk_tree_row_reference_new (GTK_TREE_MODEL (model), gtk_tree_model_get_path (GTK_TREE_MODEL (model), &iter)));
+					// Add stock to results
+					results.Add (index, RESULT_GOOD);
 				}
 
+				// Release per-stock memory
+				arena.Reset ();
+
 				// Increment records count
 				records++;
 
 				// Add new element to list store object
-				GtkTreeIter liter;
-				gtk_list_store_append (GTK_LIST_STORE (list), &liter);
-				gtk_list_store_set (GTK_LIST_STORE (list), &liter, ANALYZE_TICKER_ID, ticker, ANALYZE_DATE_ID, result.date, ANALYZE_SYNC_ID, result.sync, ANALYZE_QUOTES_ID, result.count, ANALYZE_LIQUIDITY_ID, result.liquidity, ANALYZE_VOLATILITY_ID, result.volatility, ANALYZE_PRICE_ID, result.price, ANALYZE_STATUS_ID, status, -1);
+				gint64 start = ProfileStart ();
+				gtk_list_store_insert_with_values (GTK_LIST_STORE (list), NULL, -1, ANALYZE_TICKER_ID, ticker, ANALYZE_DATE_ID, result.date, ANALYZE_SYNC_ID, result.sync, ANALYZE_QUOTES_ID, result.count, ANALYZE_LIQUIDITY_ID, result.liquidity, ANALYZE_VOLATILITY_ID, result.volatility, ANALYZE_PRICE_ID, result.price, ANALYZE_STATUS_ID, status, -1);
+				ProfileStop (PROFILE_MODEL, start, 0);
 
-				// Set current progress
+				// Increment processed stocks count
 				i++;
-				gdouble fraction = static_cast <gdouble> (i) / size;
-				if (GTK_IS_PROGRESS_BAR (pwin.progress))
-					gtk_progress_bar_set_fraction (GTK_PROGRESS_BAR (pwin.progress), fraction);
 
 				// Check if termination flag is set
 				if (terminate)
@@ -370,13 +451,15 @@ gboolean AnalyzeQuotesDialog (GtkWindow *parent, GtkTreeModel *model, const gcha
 					// Decrement reference count to analyze list
 					g_object_unref (GTK_LIST_STORE (list));
 
-					// Release lists of references
-					g_list_free_full (good, reinterpret_cast <GDestroyNotify> (gtk_tree_row_reference_free));
-					g_list_free_full (bad, reinterpret_cast <GDestroyNotify> (gtk_tree_row_reference_free));
-
 					// Free temporary string buffers
 					g_free (ticker);
 					g_free (status);
+					g_free (sname);
+
+					// Free cross-sectional ranks
+					filter -> SetRanks (NULL);
+					for (gint k = 0; k < FILTER_RANKS; k++)
+						g_free (franks[k]);
 
 					// Return terminate state
 					return FALSE;
@@ -387,9 +470,8 @@ gboolean AnalyzeQuotesDialog (GtkWindow *parent, GtkTreeModel *model, const gcha
 			g_free (ticker);
 			g_free (status);
 
-			// Process pending events
-			while (gtk_events_pending ())
-				gtk_main_iteration ();
+			// Set current progress and process pending events at limited rate
+			UpdateProgress (&pwin, i, size);
 
 			// Change iterator position to next element
 		} while (gtk_tree_model_iter_next (GTK_TREE_MODEL (model), &iter));
@@ -401,8 +483,26 @@ gboolean AnalyzeQuotesDialog (GtkWindow *parent, GtkTreeModel *model, const gcha
 		while (gtk_events_pending ())
 			gtk_main_iteration ();
 
+		// Free cross-sectional ranks
+		filter -> SetRanks (NULL);
+		for (gint k = 0; k < FILTER_RANKS; k++)
+			g_free (franks[k]);
+
+		// Save term statistics for next runs
+		filter -> SaveStatistics (sname, NULL);
+		g_free (sname);
+
+		// Get rejection statistics
+		gchar *details = filter -> GetStatistics ();
+
+		// Append stage measurements to profile log
+		SaveProfile (fname, "analyze", NULL);
+
 		// Show report dialog
-		return CreateReportDialog (parent, "Analyze report", "AnalyzeReport.tsv", GTK_TREE_MODEL (model), GTK_TREE_MODEL (list), good, bad, CreateAnalyzeList, SaveAnalyzeReport, records, errors);
+		status = CreateReportDialog (parent, "Analyze report", "AnalyzeReport.tsv", GTK_TREE_MODEL (list), &results, CreateAnalyzeList, SaveAnalyzeReport, records, errors, details);
+
+		// Free temporary string buffer
+		g_free (details);
 	}
 
 	// Return operation status
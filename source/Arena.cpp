@@ -0,0 +1,246 @@
+/*                                                                     Arena.cpp
+################################################################################
+# Encoding: UTF-8                                                  Tab size: 4 #
+#                                                                              #
+#                                 ARENA CLASS                                  #
+#                                                                              #
+# License: LGPLv3+                               Copyleft (Ɔ) 2014, Jack Black #
+################################################################################
+*/
+# include	<Arena.h>
+# include	<glib/gstdio.h>
+# include	<string.h>
+# include	<errno.h>
+# include	<fcntl.h>
+# include	<sys/stat.h>
+# include	<unistd.h>
+
+//****************************************************************************//
+//      Internal constants                                                    //
+//****************************************************************************//
+# define	ARENA_HEADER_SIZE	((sizeof (ArenaBlock) + ARENA_ALIGN - 1) & ~static_cast <gsize> (ARENA_ALIGN - 1))
+
+//****************************************************************************//
+//      Constructor                                                           //
+//****************************************************************************//
+Arena::Arena (void)
+{
+	// Set arena elements to default values
+	blocks = NULL;
+}
+
+//****************************************************************************//
+//      Destructor                                                            //
+//****************************************************************************//
+Arena::~Arena (void)
+{
+	// Free arena elements
+	while (blocks)
+	{
+		ArenaBlock *next = blocks -> next;
+		g_free (blocks);
+		blocks = next;
+	}
+
+	// Set arena elements to default values
+	blocks = NULL;
+}
+
+//****************************************************************************//
+//      Add new block to arena                                                //
+//****************************************************************************//
+void Arena::AddBlock (gsize size)
+{
+	// Allocate block with its header
+	ArenaBlock *block = reinterpret_cast <ArenaBlock*> (g_malloc (ARENA_HEADER_SIZE + size));
+
+	// Set block elements
+	block -> next = blocks;
+	block -> size = size;
+	block -> used = 0;
+
+	// Make new block current
+	blocks = block;
+}
+
+//****************************************************************************//
+//      Allocate memory from arena                                            //
+//****************************************************************************//
+gpointer Arena::Alloc (gsize size)
+{
+	// Align allocation size
+	size = (size + ARENA_ALIGN - 1) & ~static_cast <gsize> (ARENA_ALIGN - 1);
+
+	// Add new block if current block has not enough space
+	if (blocks == NULL || blocks -> size - blocks -> used < size)
+	{
+		// Grow blocks geometrically to keep count of blocks small
+		gsize bsize = blocks ? 2 * blocks -> size : ARENA_BLOCK_SIZE;
+		AddBlock (MAX (bsize, size));
+	}
+
+	// Take memory from current block
+	gchar *result = reinterpret_cast <gchar*> (blocks) + ARENA_HEADER_SIZE + blocks -> used;
+	blocks -> used += size;
+
+	// Return allocated memory
+	return result;
+}
+
+//****************************************************************************//
+//      Duplicate string in arena                                             //
+//****************************************************************************//
+gchar* Arena::Strdup (const gchar *string)
+{
+	// Check if string is set
+	if (string == NULL)
+		return NULL;
+
+	// Copy string into arena memory
+	gsize length = strlen (string) + 1;
+	gchar *result = reinterpret_cast <gchar*> (Alloc (length));
+	memcpy (result, string, length);
+
+	// Return string copy
+	return result;
+}
+
+//****************************************************************************//
+//      Concatenate strings in arena                                          //
+//****************************************************************************//
+gchar* Arena::Concat (const gchar *first, ...)
+{
+	// Compute length of result string
+	va_list args;
+	gsize length = 1;
+	va_start (args, first);
+	for (const gchar *string = first; string; string = va_arg (args, const gchar*))
+		length += strlen (string);
+	va_end (args);
+
+	// Copy strings into arena memory
+	gchar *result = reinterpret_cast <gchar*> (Alloc (length));
+	gchar *target = result;
+	va_start (args, first);
+	for (const gchar *string = first; string; string = va_arg (args, const gchar*))
+	{
+		gsize size = strlen (string);
+		memcpy (target, string, size);
+		target += size;
+	}
+	va_end (args);
+	target[0] = '\0';
+
+	// Return concatenated string
+	return result;
+}
+
+//****************************************************************************//
+//      Load file content into arena memory                                   //
+//****************************************************************************//
+gchar* Arena::LoadFile (const gchar *fname, gsize *length, GError **error)
+{
+	// Try to open file
+	gint fd = g_open (fname, O_RDONLY, 0);
+	if (fd < 0)
+	{
+		// Set error message
+		gint code = errno;
+		g_set_error (error, G_FILE_ERROR, g_file_error_from_errno (code), "Failed to open file '%s': %s", fname, g_strerror (code));
+
+		// Return fail status
+		return NULL;
+	}
+
+	// Get file size
+	struct stat info;
+	if (fstat (fd, &info) != 0)
+	{
+		// Set error message
+		gint code = errno;
+		g_set_error (error, G_FILE_ERROR, g_file_error_from_errno (code), "Failed to get attributes of file '%s': %s", fname, g_strerror (code));
+
+		// Close file
+		close (fd);
+
+		// Return fail status
+		return NULL;
+	}
+
+	// Read whole file into arena memory
+	gsize size = info.st_size;
+	gchar *content = reinterpret_cast <gchar*> (Alloc (size + 1));
+	gsize bytes = 0;
+	while (bytes < size)
+	{
+		gssize count = read (fd, content + bytes, size - bytes);
+		if (count < 0 && errno == EINTR)
+			continue;
+		if (count <= 0)
+		{
+			// Set error message
+			gint code = count ? errno : EIO;
+			g_set_error (error, G_FILE_ERROR, g_file_error_from_errno (code), "Failed to read from file '%s': %s", fname, g_strerror (code));
+
+			// Close file
+			close (fd);
+
+			// Return fail status
+			return NULL;
+		}
+		bytes += count;
+	}
+
+	// Close file
+	close (fd);
+
+	// Terminate file content by null like g_file_get_contents does
+	content[size] = '\0';
+
+	// Return file content
+	if (length)
+		*length = size;
+	return content;
+}
+
+//****************************************************************************//
+//      Release all allocations                                               //
+//****************************************************************************//
+void Arena::Reset (void)
+{
+	// Check if arena has blocks
+	if (blocks == NULL)
+		return;
+
+	// Merge all blocks into single block which fits whole batch next time
+	if (blocks -> next)
+	{
+		gsize size = GetSize ();
+		while (blocks)
+		{
+			ArenaBlock *next = blocks -> next;
+			g_free (blocks);
+			blocks = next;
+		}
+		AddBlock (size);
+	}
+
+	// Release all memory of current block
+	blocks -> used = 0;
+}
+
+//****************************************************************************//
+//      Get total size of arena blocks                                        //
+//****************************************************************************//
+gsize Arena::GetSize (void) const
+{
+	gsize size = 0;
+	for (const ArenaBlock *block = blocks; block; block = block -> next)
+		size += block -> size;
+	return size;
+}
+/*
+################################################################################
+#                                 END OF FILE                                  #
+################################################################################
+*/
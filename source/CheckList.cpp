@@ -8,6 +8,8 @@
 ################################################################################
 */
 # include	<Common.h>
+# include	<Writer.h>
+# include	<Profile.h>
 # include	<Quotes.h>
 # include	<StockList.h>
 # include	<CheckList.h>
@@ -25,10 +27,33 @@ struct CheckResult
 	gfloat		price;			// Last price
 };
 
+//****************************************************************************//
+//      Check task structure                                                  //
+//****************************************************************************//
+struct CheckTask
+{
+	gchar		*ticker;		// Stock ticker
+	guint		index;			// Stock index
+	CheckResult	result;			// Check result
+	gchar		*message;		// Error message
+};
+
+//****************************************************************************//
+//      Check context structure                                               //
+//****************************************************************************//
+struct CheckContext
+{
+	const gchar	*fname;			// Stock list file name
+	gboolean	mapped;			// Validate mapped quote files
+	gint		cancel;			// Cancel flag
+	GAsyncQueue	*arenas;		// Arenas of idle check threads
+	GAsyncQueue	*results;		// Finished check tasks
+};
+
 //****************************************************************************//
 //      Check stock quotes for errors                                         //
 //****************************************************************************//
-static CheckResult CheckQuotes (const gchar *fname, const gchar* ticker, GError **error)
+static CheckResult CheckQuotes (const gchar *fname, const gchar* ticker, Arena *arena, GError **error)
 {
 	// Init result structure
 	CheckResult result = {
@@ -41,10 +66,11 @@ static CheckResult CheckQuotes (const gchar *fname, const gchar* ticker, GError
 	};
 
 	// Get quotes file name
-	gchar* path = GetQuotesFile (fname, ticker);
+	gchar* path = GetQuotesFile (fname, ticker, arena);
 
-	// Create quotes object
+	// Create quotes object which takes memory from arena
 	Quotes quotes;
+	quotes.SetArena (arena);
 
 	// Try to open quotes
 	if (quotes.OpenList (path, error))
@@ -58,26 +84,160 @@ static CheckResult CheckQuotes (const gchar *fname, const gchar* ticker, GError
 		result.price = quotes.GetLastPrice ();
 	}
 
-	// Free temporary string buffer
-	g_free (path);
+	// Normal exit
+	return result;
+}
+
+//****************************************************************************//
+//      Check mapped stock quotes for errors without copying them             //
+//****************************************************************************//
+static CheckResult CheckMappedQuotes (const gchar *fname, const gchar* ticker, Arena *arena, GError **error)
+{
+	// Init result structure
+	CheckResult result = {
+		static_cast <gboolean> (FALSE),
+		static_cast <gint> (-1),
+		static_cast <time_t> (TIME_ERROR),
+		static_cast <time_t> (TIME_ERROR),
+		static_cast <time_t> (TIME_ERROR),
+		static_cast <gfloat> (-1)
+	};
+
+	// Get quotes file name
+	gchar* path = GetQuotesFile (fname, ticker, arena);
+
+	// Try to map quotes file
+	gint64 start = ProfileStart ();
+	GMappedFile *file = g_mapped_file_new (path, FALSE, error);
+	if (file)
+	{
+		// Get file content
+		const gchar *content = g_mapped_file_get_contents (file);
+		gsize bytes = g_mapped_file_get_length (file);
+		ProfileStop (PROFILE_READ, start, bytes);
+
+		// Check file size
+		if (bytes < sizeof (time_t) || (bytes - sizeof (time_t)) % sizeof (quote_t))
+		{
+			// Set error message
+			g_set_error (error, G_FILE_ERROR, G_FILE_ERROR_IO, "Quotes file is corrupted");
+		}
+		else
+		{
+			// Verify stock quotes in place
+			GError *local = NULL;
+			QuoteSummary summary;
+			bytes = (bytes - sizeof (time_t)) / sizeof (quote_t);
+			start = ProfileStart ();
+			gboolean verified = VerifyQuotes (reinterpret_cast <const quote_t*> (content), bytes, &summary, &local);
+			ProfileStop (PROFILE_VALIDATE, start, bytes * sizeof (quote_t));
+			if (verified)
+			{
+				// Set result structure fields
+				result.status = TRUE;
+				result.count = summary.count;
+				result.first = summary.first;
+				result.last = summary.last;
+				result.sync = *reinterpret_cast <const time_t*> (reinterpret_cast <const quote_t*> (content) + bytes);
+				result.price = summary.price;
+			}
+			else if (g_error_matches (local, G_FILE_ERROR, G_FILE_ERROR_INVAL))
+			{
+				// Release error object
+				g_error_free (local);
+
+				// Unsorted quotes should be checked on sorted copy
+				g_mapped_file_unref (file);
+				return CheckQuotes (fname, ticker, arena, error);
+			}
+			else
+			{
+				// Pass error to caller
+				g_propagate_error (error, local);
+			}
+		}
+
+		// Unmap quotes file
+		g_mapped_file_unref (file);
+	}
 
 	// Normal exit
 	return result;
 }
 
+//****************************************************************************//
+//      Check thread function                                                 //
+//****************************************************************************//
+static void CheckThread (gpointer data, gpointer user_data)
+{
+	// Convert data pointers
+	CheckTask *task = reinterpret_cast <CheckTask*> (data);
+	CheckContext *context = reinterpret_cast <CheckContext*> (user_data);
+
+	// Skip tasks which are left after cancellation
+	if (!g_atomic_int_get (&context -> cancel))
+	{
+		// Take arena of idle thread
+		Arena *arena = reinterpret_cast <Arena*> (g_async_queue_pop (context -> arenas));
+
+		// Create error object
+		GError *error = NULL;
+
+		// Check quotes
+		if (context -> mapped)
+			task -> result = CheckMappedQuotes (context -> fname, task -> ticker, arena, &error);
+		else
+			task -> result = CheckQuotes (context -> fname, task -> ticker, arena, &error);
+
+		// Keep error message
+		if (!task -> result.status)
+		{
+			task -> message = g_strdup (error -> message);
+			g_error_free (error);
+		}
+
+		// Release per-stock memory and return arena back
+		arena -> Reset ();
+		g_async_queue_push (context -> arenas, arena);
+	}
+
+	// Pass finished task to user interface thread
+	g_async_queue_push (context -> results, task);
+}
+
+//****************************************************************************//
+//      Free check task                                                       //
+//****************************************************************************//
+static void FreeCheckTask (CheckTask *task)
+{
+	// Free task elements
+	g_free (task -> ticker);
+	g_free (task -> message);
+	g_free (task);
+}
+
 //****************************************************************************//
 //      Save check report function                                            //
 //****************************************************************************//
 static gboolean SaveCheckReport (const gchar *fname, GtkTreeModel *model, GError **error)
 {
-	// Create string buffer
-	GString *string = g_string_new (NULL);
+	// Try to open report file
+	Writer writer;
+	if (!writer.Open (fname, Writer::GetTextFormat (fname), error))
+		return FALSE;
 
 	// Check if report is set
 	if (model)
 	{
 		// Append report header
-		g_string_append_printf (string, CHECK_TICKER_LABEL "\t" CHECK_QUOTES_LABEL "\t" CHECK_FIRST_LABEL "\t" CHECK_LAST_LABEL "\t" CHECK_SYNC_LABEL "\t" CHECK_PRICE_LABEL "\t" CHECK_STATUS_LABEL "\n");
+		writer.AddString (CHECK_TICKER_LABEL);
+		writer.AddString (CHECK_QUOTES_LABEL);
+		writer.AddString (CHECK_FIRST_LABEL);
+		writer.AddString (CHECK_LAST_LABEL);
+		writer.AddString (CHECK_SYNC_LABEL);
+		writer.AddString (CHECK_PRICE_LABEL);
+		writer.AddString (CHECK_STATUS_LABEL);
+		writer.EndRow ();
 
 		// Get iterator position
 		GtkTreeIter iter;
@@ -92,25 +252,30 @@ static gboolean SaveCheckReport (const gchar *fname, GtkTreeModel *model, GError
 				gfloat price;
 				gtk_tree_model_get (GTK_TREE_MODEL (model), &iter, CHECK_TICKER_ID, &ticker, CHECK_QUOTES_ID, &count, CHECK_FIRST_ID, &first, CHECK_LAST_ID, &last, CHECK_SYNC_ID, &sync, CHECK_PRICE_ID, &price, CHECK_STATUS_ID, &status, -1);
 
-				// Append quote information into string buffer
-				date_struct fdate = Time::ExtractDate (first);
-				date_struct ldate = Time::ExtractDate (last);
-				date_struct sdate = Time::ExtractDate (sync);
-				g_string_append_printf (string, "%s\t%i\t%.4i-%.2d-%.2d\t%.4i-%.2d-%.2d\t%.4i-%.2d-%.2d\t%.2f\t%s\n", ticker, count, fdate.year, fdate.mon, fdate.day, ldate.year, ldate.mon, ldate.day, sdate.year, sdate.mon, sdate.day, price, status);
+				// Append quote information into report
+				writer.AddString (ticker);
+				writer.AddInt (count);
+				writer.AddDate (first);
+				writer.AddDate (last);
+				writer.AddDate (sync);
+				writer.AddNumber (price, 2);
+				writer.AddString (status);
+				writer.EndRow ();
+
+				// Free temporary string buffers
+				g_free (ticker);
+				g_free (status);
 
 				// Change iterator position to next element
 			} while (gtk_tree_model_iter_next (GTK_TREE_MODEL (model), &iter));
 		}
-	}
-
-	// Try to save string buffer into file
-	gboolean status = g_file_set_contents (fname, string -> str, string -> len, error);
 
-	// Relase string buffer
-	g_string_free (string, TRUE);
+		// Append stage measurements of run
+		WriteProfile (&writer);
+	}
 
-	// Return file operation status
-	return status;
+	// Close report file
+	return writer.Close (error);
 }
 
 //****************************************************************************//
@@ -233,7 +398,12 @@ static GtkWidget* CreateCheckList (GtkTreeModel *model)
 //****************************************************************************//
 //      Check quotes dialog                                                   //
 //****************************************************************************//
-gboolean CheckQuotesDialog (GtkWindow *parent, GtkTreeModel *model, const gchar *fname)
+//
+// Quote files are checked by a pool of threads. Every thread takes its own
+// arena for per-stock memory, and finished tasks come back through the queue.
+// User interface thread adds them to check list in batches.
+//
+gboolean CheckQuotesDialog (GtkWindow *parent, GtkTreeModel *model, const gchar *fname, gboolean mapped)
 {
 	// Operation status
 	gboolean status = FALSE;
@@ -245,15 +415,30 @@ gboolean CheckQuotesDialog (GtkWindow *parent, GtkTreeModel *model, const gchar
 		// Create new check list
 		GtkListStore *list = gtk_list_store_new (CHECK_COLUMNS, G_TYPE_STRING, G_TYPE_INT, G_TYPE_INT64, G_TYPE_INT64, G_TYPE_INT64, G_TYPE_FLOAT, G_TYPE_STRING);
 
-		// Create good and bad lists
-		GList *good = NULL;
-		GList *bad = NULL;
+		// Create results of processed stocks
+		Results results;
+
+		// Clear stage measurements of previous run
+		ResetProfile ();
+
+		// Get count of check threads
+		gint threads = MIN (MAX (g_get_num_processors (), 1), CHECK_MAX_THREADS);
+
+		// Create check context
+		CheckContext context = {fname, mapped, 0, g_async_queue_new (), g_async_queue_new ()};
+
+		// Create arenas for per-stock memory of check threads
+		for (gint t = 0; t < threads; t++)
+			g_async_queue_push (context.arenas, new Arena ());
+
+		// Create pool of check threads
+		GThreadPool *pool = g_thread_pool_new (CheckThread, &context, threads, TRUE, NULL);
 
 		// Get stocks count
 		gint records = 0;
 		gint errors = 0;
 		gint i = 0;
-		gint size = GetTotalCount (GTK_TREE_MODEL (model));
+		gint size = 0;
 
 		// Create progress dialog
 		gboolean terminate = FALSE;
@@ -262,28 +447,52 @@ gboolean CheckQuotesDialog (GtkWindow *parent, GtkTreeModel *model, const gchar
 		// Iterate through all elements
 		do {
 			// Get stock details
-			gboolean state;
-			gchar *ticker, *status = NULL;
-			gtk_tree_model_get (GTK_TREE_MODEL (model), &iter, STOCK_CHECK_ID, &state, STOCK_TICKER_ID, &ticker, -1);
+			guint index;
+			gchar *ticker;
+			gtk_tree_model_get (GTK_TREE_MODEL (model), &iter, STOCK_TICKER_ID, &ticker, STOCK_INDEX_ID, &index, -1);
 
 			// Check if stock is marked
-			if (state)
+			if (IsStockMarked (index))
+			{
+				// Create check task which takes ticker ownership
+				CheckTask *task = g_new0 (CheckTask, 1);
+				task -> ticker = ticker;
+				task -> index = index;
+
+				// Pass task to check threads
+				g_thread_pool_push (pool, task, NULL);
+
+				// Increment tasks count
+				size++;
+			}
+			else
 			{
-				// Create error object
-				GError *error = NULL;
+				// Free temporary string buffer
+				g_free (ticker);
+			}
 
-				// Check quotes
-				CheckResult result = CheckQuotes (fname, ticker, &error);
-				if (!result.status)
+			// Change iterator position to next element
+		} while (gtk_tree_model_iter_next (GTK_TREE_MODEL (model), &iter));
+
+		// Collect results of all tasks
+		while (i < size && !terminate)
+		{
+			// Wait for next finished task
+			CheckTask *task = reinterpret_cast <CheckTask*> (g_async_queue_timeout_pop (context.results, CHECK_POLL_TIME));
+
+			// Add batch of finished tasks to check list
+			gint batch = 0;
+			while (task)
+			{
+				// Check status of task
+				const gchar *status;
+				if (!task -> result.status)
 				{
 					// Set status message
-					status = g_strdup (error -> message);
+					status = task -> message;
 
-					// Append new element to reference list
-					bad = g_list_append (bad, gtk_tree_row_reference_new (GTK_TREE_MODEL (model), gtk_tree_model_get_path (GTK_TREE_MODEL (model), &iter)));
-
-					// Release error object
-					g_error_free (error);
+					// Add stock to results
+					results.Add (task -> index, RESULT_BAD);
 
 					// Increment errors count
 					errors++;
@@ -291,58 +500,63 @@ gboolean CheckQuotesDialog (GtkWindow *parent, GtkTreeModel *model, const gchar
 				else
 				{
 					// Set status message
-					status = g_strdup (STRING_OK);
+					status = STRING_OK;
 
-					// Append new element to reference list
-					good = g_list_append (good, gtk_tree_row_reference_new (GTK_TREE_MODEL (model), gtk_tree_model_get_path (GTK_TREE_MODEL (model), &iter)));
+					// Add stock to results
+					results.Add (task -> index, RESULT_GOOD);
 				}
 
 				// Increment records count
 				records++;
 
 				// Add new element to list store object
-				GtkTreeIter liter;
-				gtk_list_store_append (GTK_LIST_STORE (list), &liter);
-				gtk_list_store_set (GTK_LIST_STORE (list), &liter, CHECK_TICKER_ID, ticker, CHECK_QUOTES_ID, result.count, CHECK_FIRST_ID, result.first, CHECK_LAST_ID, result.last, CHECK_SYNC_ID, result.sync, CHECK_PRICE_ID, result.price, CHECK_STATUS_ID, status, -1);
+				gint64 start = ProfileStart ();
+				gtk_list_store_insert_with_values (GTK_LIST_STORE (list), NULL, -1, CHECK_TICKER_ID, task -> ticker, CHECK_QUOTES_ID, task -> result.count, CHECK_FIRST_ID, task -> result.first, CHECK_LAST_ID, task -> result.last, CHECK_SYNC_ID, task -> result.sync, CHECK_PRICE_ID, task -> result.price, CHECK_STATUS_ID, status, -1);
+				ProfileStop (PROFILE_MODEL, start, 0);
+
+				// Free finished task
+				FreeCheckTask (task);
 
-				// Set current progress
+				// Get next finished task if batch is not full
 				i++;
-				gdouble fraction = static_cast <gdouble> (i) / size;
-				if (GTK_IS_PROGRESS_BAR (pwin.progress))
-					gtk_progress_bar_set_fraction (GTK_PROGRESS_BAR (pwin.progress), fraction);
+				batch++;
+				task = batch < CHECK_BATCH_SIZE ? reinterpret_cast <CheckTask*> (g_async_queue_try_pop (context.results)) : NULL;
+			}
 
-				// Check if termination flag is set
-				if (terminate)
-				{
-					// Clear check list
-					gtk_list_store_clear (GTK_LIST_STORE (list));
+			// Set current progress and process pending events at limited rate
+			UpdateProgress (&pwin, i, size);
+		}
 
-					// Decrement reference count to check list
-					g_object_unref (GTK_LIST_STORE (list));
+		// Stop check threads after termination and wait for them
+		g_atomic_int_set (&context.cancel, terminate);
+		g_thread_pool_free (pool, FALSE, TRUE);
 
-					// Release lists of references
-					g_list_free_full (good, reinterpret_cast <GDestroyNotify> (gtk_tree_row_reference_free));
-					g_list_free_full (bad, reinterpret_cast <GDestroyNotify> (gtk_tree_row_reference_free));
+		// Free tasks which were not added to check list
+		CheckTask *task;
+		while ((task = reinterpret_cast <CheckTask*> (g_async_queue_try_pop (context.results))))
+			FreeCheckTask (task);
 
-					// Free temporary string buffers
-					g_free (ticker);
-					g_free (status);
+		// Free arenas of check threads
+		Arena *arena;
+		while ((arena = reinterpret_cast <Arena*> (g_async_queue_try_pop (context.arenas))))
+			delete arena;
 
-					// Return terminate state
-					return FALSE;
-				}
-			}
+		// Free check context queues
+		g_async_queue_unref (context.arenas);
+		g_async_queue_unref (context.results);
 
-			// Free temporary string buffers
-			g_free (ticker);
-			g_free (status);
+		// Check if termination flag is set
+		if (terminate)
+		{
+			// Clear check list
+			gtk_list_store_clear (GTK_LIST_STORE (list));
 
-			// Process pending events
-			while (gtk_events_pending ())
-				gtk_main_iteration ();
+			// Decrement reference count to check list
+			g_object_unref (GTK_LIST_STORE (list));
 
-			// Change iterator position to next element
-		} while (gtk_tree_model_iter_next (GTK_TREE_MODEL (model), &iter));
+			// Return terminate state
+			return FALSE;
+		}
 
 		// Close progress window
 		gtk_window_close (GTK_WINDOW (pwin.window));
@@ -351,8 +565,11 @@ gboolean CheckQuotesDialog (GtkWindow *parent, GtkTreeModel *model, const gchar
 		while (gtk_events_pending ())
 			gtk_main_iteration ();
 
+		// Append stage measurements to profile log
+		SaveProfile (fname, "check", NULL);
+
 		// Show report dialog
-		return CreateReportDialog (parent, "Check report", "CheckReport.tsv", GTK_TREE_MODEL (model), GTK_TREE_MODEL (list), good, bad, CreateCheckList, SaveCheckReport, records, errors);
+		return CreateReportDialog (parent, "Check report", "CheckReport.tsv", GTK_TREE_MODEL (list), &results, CreateCheckList, SaveCheckReport, records, errors, NULL);
 	}
 
 	// Return operation status
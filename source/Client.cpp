@@ -9,6 +9,8 @@
 */
 # include	<QuoteList.h>
 # include	<Client.h>
+# include	<Profile.h>
+# include	<Probes.h>
 # include	<Array.h>
 
 //****************************************************************************//
@@ -64,10 +66,63 @@ static gsize DataAccumulator (gchar *ptr, gsize size, gsize nmemb, gpointer data
 	return bytes;
 }
 
+//============================================================================//
+//      Check if request failure is transient                                 //
+//============================================================================//
+static gboolean IsTransient (CURLcode result, long code)
+{
+	switch (result)
+	{
+		case CURLE_OK:
+			return code == CLIENT_TOO_MANY || code >= CLIENT_SERVER_ERROR;
+		case CURLE_COULDNT_RESOLVE_HOST:
+		case CURLE_COULDNT_CONNECT:
+		case CURLE_OPERATION_TIMEDOUT:
+		case CURLE_GOT_NOTHING:
+		case CURLE_SEND_ERROR:
+		case CURLE_RECV_ERROR:
+			return TRUE;
+		default:
+			return FALSE;
+	}
+}
+
+//============================================================================//
+//      Perform request with respect to request rate                          //
+//============================================================================//
+static CURLcode PerformRequest (CURL *handle, RateLimiter *limiter, long *code)
+{
+	// Wait until request is allowed by rate limiter
+	*code = 0;
+	if (!limiter -> Wait ())
+		return CURLE_ABORTED_BY_CALLBACK;
+
+	// Send request to quote server
+	gint64 start = ProfileStart ();
+	PROBE (request__start);
+	CURLcode result = curl_easy_perform (handle);
+
+	// Get response code
+	if (result == CURLE_OK)
+		result = curl_easy_getinfo (handle, CURLINFO_RESPONSE_CODE, code);
+
+	// Get amount of received bytes
+	curl_off_t bytes = 0;
+	curl_easy_getinfo (handle, CURLINFO_SIZE_DOWNLOAD_T, &bytes);
+	ProfileStop (PROFILE_TRANSFER, start, static_cast <gsize> (bytes));
+	PROBE3 (request__done, result, *code, bytes);
+
+	// Adjust request rate by request result
+	limiter -> Update (IsTransient (result, *code), static_cast <guint64> (bytes));
+
+	// Return request status
+	return result;
+}
+
 //============================================================================//
 //      Accumulate splits                                                     //
 //============================================================================//
-static gboolean AccumulateSplits (CURL *handle, Accumulator *accumulator, const gchar *ticker, time_t start, time_t end, GError **error)
+static gboolean AccumulateSplits (CURL *handle, RateLimiter *limiter, Accumulator *accumulator, const gchar *ticker, time_t start, time_t end, GError **error)
 {
 	// Allocate space for static buffer
 	gchar buffer [BUFFER_SIZE];
@@ -99,9 +154,20 @@ static gboolean AccumulateSplits (CURL *handle, Accumulator *accumulator, const
 		if (result == CURLE_OK)
 		{
 			// Get qoutes from quote server
-			result = curl_easy_perform (handle);
+			long code;
+			result = PerformRequest (handle, limiter, &code);
 			if (result == CURLE_OK)
 			{
+				// Check if server returned error
+				if (code >= CLIENT_BAD_REQUEST)
+				{
+					// Set error message
+					g_set_error (error, G_FILE_ERROR, IsTransient (result, code) ? G_FILE_ERROR_AGAIN : G_FILE_ERROR_IO, "Quote server returned HTTP error %li", code);
+
+					// Return fail status
+					return FALSE;
+				}
+
 				// Reserve space into accumulator
 				gchar *pos = reinterpret_cast <gchar*> (accumulator -> Reserve (sizeof (gchar)));
 				if (pos == NULL)
@@ -129,16 +195,42 @@ static gboolean AccumulateSplits (CURL *handle, Accumulator *accumulator, const
 	const char *message = curl_easy_strerror (result);
 
 	// Set error message
-	g_set_error (error, G_FILE_ERROR, G_FILE_ERROR_IO, message);
+	g_set_error (error, G_FILE_ERROR, IsTransient (result, 0) ? G_FILE_ERROR_AGAIN : G_FILE_ERROR_IO, message);
 
 	// Return fail status
 	return FALSE;
 }
 
+//============================================================================//
+//      Curl callback function for collecting response headers                //
+//============================================================================//
+static gsize HeaderAccumulator (gchar *ptr, gsize size, gsize nmemb, gpointer data)
+{
+	// Convert data pointer
+	gchar **etag = reinterpret_cast <gchar**> (data);
+
+	// Get amount of received bytes
+	gsize bytes = size * nmemb;
+
+	// Check if header is entity tag and it was requested
+	gsize len = sizeof (CLIENT_ETAG_HEADER) - 1;
+	if (etag && bytes > len && g_ascii_strncasecmp (ptr, CLIENT_ETAG_HEADER, len) == 0)
+	{
+		// Free previous entity tag
+		g_free (*etag);
+
+		// Store new entity tag
+		*etag = g_strstrip (g_strndup (ptr + len, bytes - len));
+	}
+
+	// Normal exit
+	return bytes;
+}
+
 //============================================================================//
 //      Accumulate quotes                                                     //
 //============================================================================//
-static gboolean AccumulateQuotes (CURL *handle, Accumulator *accumulator, const gchar *ticker, time_t start, time_t end, GError **error)
+static gboolean AccumulateQuotes (CURL *handle, RateLimiter *limiter, GKeyFile *validators, Accumulator *accumulator, const gchar *ticker, time_t start, time_t end, gboolean *unchanged, GError **error)
 {
 	// Allocate space for static buffer
 	gchar buffer [BUFFER_SIZE];
@@ -161,49 +253,140 @@ static gboolean AccumulateQuotes (CURL *handle, Accumulator *accumulator, const
 	date_struct edate = Time::ExtractDate (end);
 	g_snprintf (buffer, BUFFER_SIZE, "http://real-chart.finance.yahoo.com/table.csv?s=%s&a=%d&b=%d&c=%i&d=%d&e=%d&f=%i&g=d", ticker, sdate.mon - 1, sdate.day, sdate.year, edate.mon - 1, edate.day, edate.year);
 
-	// Set data for curl callback function
+	// Get validators of previous response of ticker if it was requested from the same start date.
+	// Full history is requested only when stored quotes are empty or were reset, and then it is
+	// always requested unconditionally, so a "Not modified" response can not leave them empty
+	gchar *etag = NULL;
+	gint64 modified = 0;
+	if (start != static_cast <time_t> (MIN_DATE) && g_key_file_has_key (validators, ticker, CLIENT_START_KEY, NULL) && g_key_file_get_int64 (validators, ticker, CLIENT_START_KEY, NULL) == start)
+	{
+		etag = g_key_file_get_string (validators, ticker, CLIENT_ETAG_KEY, NULL);
+		modified = g_key_file_get_int64 (validators, ticker, CLIENT_MODIFIED_KEY, NULL);
+	}
+
+	// Create conditional request header
+	struct curl_slist *headers = NULL;
+	if (etag)
+	{
+		gchar *header = g_strconcat ("If-None-Match: ", etag, NULL);
+		headers = curl_slist_append (headers, header);
+		g_free (header);
+	}
+
+	// Free entity tag of previous response
+	g_free (etag);
+	etag = NULL;
+
+	// Set data for curl callback functions
 	CURLcode result = curl_easy_setopt (handle, CURLOPT_WRITEDATA, &data);
 	if (result == CURLE_OK)
-	{
-		// Set URL
+		result = curl_easy_setopt (handle, CURLOPT_HEADERDATA, &etag);
+
+	// Set conditional request options
+	if (result == CURLE_OK)
+		result = curl_easy_setopt (handle, CURLOPT_HTTPHEADER, headers);
+	if (result == CURLE_OK)
+		result = curl_easy_setopt (handle, CURLOPT_TIMECONDITION, modified ? CURL_TIMECOND_IFMODSINCE : CURL_TIMECOND_NONE);
+	if (result == CURLE_OK)
+		result = curl_easy_setopt (handle, CURLOPT_TIMEVALUE, static_cast <long> (modified));
+
+	// Set URL
+	if (result == CURLE_OK)
 		result = curl_easy_setopt (handle, CURLOPT_URL, buffer);
-		if (result == CURLE_OK)
-		{
-			// Get qoutes from quote server
-			result = curl_easy_perform (handle);
-			if (result == CURLE_OK)
-			{
-				// Reserve space into accumulator
-				gchar *pos = reinterpret_cast <gchar*> (accumulator -> Reserve (sizeof (gchar)));
-				if (pos == NULL)
-				{
-					// Set error message
-					g_set_error (error, G_FILE_ERROR, G_FILE_ERROR_IO, "Can not reserve more space for sync buffer");
 
-					// Return fail status
-					return FALSE;
-				}
+	// Get qoutes from quote server
+	long code = 0;
+	if (result == CURLE_OK)
+		result = PerformRequest (handle, limiter, &code);
 
-				// Set end of string marker
-				*pos = '\0';
+	// Get modification time of response
+	long filetime = -1;
+	if (result == CURLE_OK)
+		result = curl_easy_getinfo (handle, CURLINFO_FILETIME, &filetime);
 
-				// Mark allocated accumulator space as filled by data
-				accumulator -> Fill (sizeof (gchar));
+	// Reset conditional request options for other requests
+	curl_easy_setopt (handle, CURLOPT_HTTPHEADER, NULL);
+	curl_easy_setopt (handle, CURLOPT_TIMECONDITION, CURL_TIMECOND_NONE);
+	curl_easy_setopt (handle, CURLOPT_HEADERDATA, NULL);
 
-				// Return success state
-				return TRUE;
-			}
-		}
+	// Release conditional request header
+	curl_slist_free_all (headers);
+
+	// Check transfer status
+	if (result != CURLE_OK)
+	{
+		// Get error desription
+		const char *message = curl_easy_strerror (result);
+
+		// Set error message
+		g_set_error (error, G_FILE_ERROR, IsTransient (result, 0) ? G_FILE_ERROR_AGAIN : G_FILE_ERROR_IO, message);
+
+		// Free entity tag
+		g_free (etag);
+
+		// Return fail status
+		return FALSE;
 	}
 
-	// Get error desription
-	const char *message = curl_easy_strerror (result);
+	// Check if quotes were not changed since previous response
+	if (code == CLIENT_NOT_MODIFIED)
+	{
+		// Set unchanged flag
+		*unchanged = TRUE;
 
-	// Set error message
-	g_set_error (error, G_FILE_ERROR, G_FILE_ERROR_IO, message);
+		// Free entity tag
+		g_free (etag);
 
-	// Return fail status
-	return FALSE;
+		// Return success state
+		return TRUE;
+	}
+
+	// Check if server returned error
+	if (code >= CLIENT_BAD_REQUEST)
+	{
+		// Set error message
+		g_set_error (error, G_FILE_ERROR, IsTransient (result, code) ? G_FILE_ERROR_AGAIN : G_FILE_ERROR_IO, "Quote server returned HTTP error %li", code);
+
+		// Free entity tag
+		g_free (etag);
+
+		// Return fail status
+		return FALSE;
+	}
+
+	// Store validators of new response
+	g_key_file_remove_group (validators, ticker, NULL);
+	if (etag || filetime > 0)
+	{
+		g_key_file_set_int64 (validators, ticker, CLIENT_START_KEY, start);
+		if (etag)
+			g_key_file_set_string (validators, ticker, CLIENT_ETAG_KEY, etag);
+		if (filetime > 0)
+			g_key_file_set_int64 (validators, ticker, CLIENT_MODIFIED_KEY, filetime);
+	}
+
+	// Free entity tag
+	g_free (etag);
+
+	// Reserve space into accumulator
+	gchar *pos = reinterpret_cast <gchar*> (accumulator -> Reserve (sizeof (gchar)));
+	if (pos == NULL)
+	{
+		// Set error message
+		g_set_error (error, G_FILE_ERROR, G_FILE_ERROR_IO, "Can not reserve more space for sync buffer");
+
+		// Return fail status
+		return FALSE;
+	}
+
+	// Set end of string marker
+	*pos = '\0';
+
+	// Mark allocated accumulator space as filled by data
+	accumulator -> Fill (sizeof (gchar));
+
+	// Return success state
+	return TRUE;
 }
 
 //****************************************************************************//
@@ -212,9 +395,11 @@ static gboolean AccumulateQuotes (CURL *handle, Accumulator *accumulator, const
 Client::Client (void)
 {
 	// Set client elements to default values
-	array = NULL;
-	size = 0;
 	handle = NULL;
+	cache = NULL;
+	validators = g_key_file_new ();
+	received = new Accumulator (CLIENT_BUFFER_SIZE);
+	parsed = new Accumulator (CLIENT_BUFFER_SIZE);
 }
 
 //****************************************************************************//
@@ -222,13 +407,57 @@ Client::Client (void)
 //****************************************************************************//
 Client::~Client (void)
 {
+	// Cleanup curl handle
+	curl_easy_cleanup (handle);
+
 	// Free client elements
-	g_free (array);
+	g_free (cache);
+	g_key_file_free (validators);
+	delete received;
+	delete parsed;
 
 	// Set client elements to default values
-	array = NULL;
-	size = 0;
 	handle = NULL;
+	cache = NULL;
+	validators = NULL;
+	received = NULL;
+	parsed = NULL;
+}
+
+//****************************************************************************//
+//      Clear reusable buffers and shrink them if they grew too much          //
+//****************************************************************************//
+void Client::ResetBuffers (void)
+{
+	// Keep high-water-mark capacity of receive buffer up to the limit
+	if (received -> Capacity () > CLIENT_BUFFER_LIMIT)
+	{
+		delete received;
+		received = new Accumulator (CLIENT_BUFFER_SIZE);
+	}
+	else
+		received -> Clear ();
+
+	// Keep high-water-mark capacity of parse buffer up to the limit
+	if (parsed -> Capacity () > CLIENT_BUFFER_LIMIT)
+	{
+		delete parsed;
+		parsed = new Accumulator (CLIENT_BUFFER_SIZE);
+	}
+	else
+		parsed -> Clear ();
+}
+
+//****************************************************************************//
+//      Set validator cache file                                              //
+//****************************************************************************//
+void Client::SetCacheFile (const gchar *fname)
+{
+	// Free old cache file name
+	g_free (cache);
+
+	// Set new cache file name
+	cache = g_strdup (fname);
 }
 
 //****************************************************************************//
@@ -246,6 +475,9 @@ gboolean Client::Init (GError **error)
 	array = NULL;
 	size = 0;
 
+	// Reset request rate and statistics
+	limiter.Reset ();
+
 	// Get new handle
 	handle = curl_easy_init ();
 	if (handle == NULL)
@@ -277,8 +509,23 @@ gboolean Client::Init (GError **error)
 					result = curl_easy_setopt (handle, CURLOPT_WRITEFUNCTION, DataAccumulator);
 					if (result == CURLE_OK)
 					{
-						// Return success state
-						return TRUE;
+						// Set header callback function
+						result = curl_easy_setopt (handle, CURLOPT_HEADERFUNCTION, HeaderAccumulator);
+						if (result == CURLE_OK)
+						{
+							// Request modification time of responses
+							result = curl_easy_setopt (handle, CURLOPT_FILETIME, 1L);
+							if (result == CURLE_OK)
+							{
+								// Enable all supported compressed encodings
+								result = curl_easy_setopt (handle, CURLOPT_ACCEPT_ENCODING, "");
+								if (result == CURLE_OK)
+								{
+									// Return success state
+									return TRUE;
+								}
+							}
+						}
 					}
 				}
 			}
@@ -296,17 +543,69 @@ gboolean Client::Init (GError **error)
 }
 
 //****************************************************************************//
-//      Request quotes from quote server                                      //
+//      Begin batch of requests                                               //
+//****************************************************************************//
+gboolean Client::Begin (const gchar* const tickers[], gsize count, GError **error)
+{
+	// Create empty validator cache
+	g_key_file_free (validators);
+	validators = g_key_file_new ();
+
+	// Load validator cache if it exists
+	if (cache && g_file_test (cache, G_FILE_TEST_IS_REGULAR))
+	{
+		// Start with empty cache if cache file is unreadable or corrupted
+		if (!g_key_file_load_from_file (validators, cache, G_KEY_FILE_NONE, NULL))
+		{
+			g_key_file_free (validators);
+			validators = g_key_file_new ();
+		}
+	}
+
+	// Return success state
+	return TRUE;
+}
+
+//****************************************************************************//
+//      End batch of requests                                                 //
+//****************************************************************************//
+gboolean Client::End (GError **error)
+{
+	// Check if validator cache is set
+	if (cache == NULL)
+		return TRUE;
+
+	// Convert validator cache into string buffer
+	gsize length;
+	gchar *data = g_key_file_to_data (validators, &length, NULL);
+
+	// Try to save string buffer into file
+	gboolean status = g_file_set_contents (cache, data, length, error);
+
+	// Free temporary string buffer
+	g_free (data);
+
+	// Return file operation status
+	return status;
+}
+
+//****************************************************************************//
+//      Check for quote splits                                                //
 //****************************************************************************//
 gboolean Client::CheckSplits (const gchar *ticker, time_t start, time_t end, GError **error)
 {
+	// Clear reusable buffers
+	ResetBuffers ();
+
 	// Try to get quotes from quote server
-	Accumulator buffer (0);
-	gboolean status = AccumulateSplits (handle, &buffer, ticker, start, end, error);
+	PROBE1 (splits__start, ticker);
+	gboolean status = AccumulateSplits (handle, &limiter, received, ticker, start, end, error);
+	PROBE2 (splits__done, ticker, status);
 	if (status)
 	{
 		// Check for splits and dividends
-		if (g_pattern_match_simple ("*DIVIDEND*", reinterpret_cast <const gchar*> (buffer.Data ())) || g_pattern_match_simple ("*SPLIT*", reinterpret_cast <const gchar*> (buffer.Data ())))
+		const gchar *data = reinterpret_cast <const gchar*> (received -> Data ());
+		if (g_pattern_match_simple ("*DIVIDEND*", data) || g_pattern_match_simple ("*SPLIT*", data))
 			return TRUE;
 		else
 			return FALSE;
@@ -321,56 +620,27 @@ gboolean Client::CheckSplits (const gchar *ticker, time_t start, time_t end, GEr
 //****************************************************************************//
 gboolean Client::GetQuotes (const gchar *ticker, time_t start, time_t end, GError **error)
 {
+	// Clear reusable buffers
+	ResetBuffers ();
+
 	// Try to get quotes from quote server
-	Accumulator buffer (0);
-	gboolean status = AccumulateQuotes (handle, &buffer, ticker, start, end, error);
-	if (status)
+	unchanged = FALSE;
+	PROBE1 (quotes__start, ticker);
+	gboolean status = AccumulateQuotes (handle, &limiter, validators, received, ticker, start, end, &unchanged, error);
+	PROBE2 (quotes__done, ticker, status);
+	if (status && unchanged)
 	{
-		// Skip quotes header
-		const gchar *pos = g_utf8_strchr (reinterpret_cast <const gchar*> (buffer.Data ()), -1, '\n');
-		if (pos == NULL)
-		{
-			// Set error message
-			g_set_error (error, G_FILE_ERROR, G_FILE_ERROR_IO, "Quote list is empty");
-
-			// Set fail status
-			status = FALSE;
-		}
-		else
-		{
-			// Go to first quote row
-			pos += sizeof (gchar);
-
-			// Create accumulator object
-			Accumulator accumulator (0);
-
-			// Extract quotes from string buffer
-			gsize count = ExtractQuotes (pos, &accumulator, error);
-			if (count == static_cast <gsize> (-1))
-			{
-				// Set fail status
-				status = FALSE;
-			}
-			else
-			{
-				// Check stock quotes for errors
-				QuoteList result = CheckQuotes (reinterpret_cast <const quote_t*> (accumulator.Data ()), count, error);
-				if (result.size == static_cast <gsize> (-1))
-				{
-					// Set fail status
-					status = FALSE;
-				}
-				else
-				{
-					// Free quote elements
-					g_free (array);
+		// Free quote elements
+		g_free (array);
 
-					// Set new quote elements
-					array = const_cast <quote_t*> (result.array);
-					size = result.size;
-				}
-			}
-		}
+		// Quotes were not modified, so there are no new quotes
+		array = NULL;
+		size = 0;
+	}
+	else if (status)
+	{
+		// Extract quotes from server response
+		status = ParseQuotes (reinterpret_cast <const gchar*> (received -> Data ()), parsed, start, end, error);
 	}
 
 	// Return file operation status
@@ -378,55 +648,27 @@ gboolean Client::GetQuotes (const gchar *ticker, time_t start, time_t end, GErro
 }
 
 //****************************************************************************//
-//      Get quote list                                                        //
-//****************************************************************************//
-QuoteList Client::GetQuoteList (void) const
-{
-	return {array, size};
-}
-
-//****************************************************************************//
-//      Get quotes count                                                      //
+//      Get request statistics                                                //
 //****************************************************************************//
-gint Client::GetCount (void) const
+gchar* Client::GetStatistics (void) const
 {
-	return size;
+	return limiter.GetStatistics ();
 }
 
 //****************************************************************************//
-//      Get first quote date                                                  //
+//      Check if provider requests quotes from quote server                   //
 //****************************************************************************//
-time_t Client::GetFirstDate (void) const
+gboolean Client::IsRemote (void) const
 {
-	// Check if quotes array has stock quotes
-	if (size)
-	{
-		// Return first quote date
-		return array[size-1].date;
-	}
-	else
-	{
-		// In case of error return TIME_ERROR
-		return TIME_ERROR;
-	}
+	return TRUE;
 }
 
 //****************************************************************************//
-//      Get last quote date                                                   //
+//      Set callback which is called while waiting between requests           //
 //****************************************************************************//
-time_t Client::GetLastDate (void) const
+void Client::SetWaitFunc (GSourceFunc func, gpointer data)
 {
-	// Check if quotes array has stock quotes
-	if (size)
-	{
-		// Return last quote date
-		return array[0].date;
-	}
-	else
-	{
-		// In case of error return TIME_ERROR
-		return TIME_ERROR;
-	}
+	limiter.SetWaitFunc (func, data);
 }
 /*
 ################################################################################
@@ -9,7 +9,9 @@
 */
 # include	<StockList.h>
 # include	<Common.h>
+# include	<Profile.h>
 # include	<Time.h>
+# include	<string.h>
 
 //****************************************************************************//
 //      Internal constants                                                    //
@@ -47,8 +49,7 @@ void DateRenderFunc (GtkTreeViewColumn *column, GtkCellRenderer *cell, GtkTreeMo
 	else
 	{
 		// Format quote date into string buffer
-		date_struct curdate = Time::ExtractDate (date);
-		g_snprintf (buffer, BUFFER_SIZE, "%.4i-%.2d-%.2d", curdate.year, curdate.mon, curdate.day);
+		FormatDate (date, buffer);
 
 		// Set cell text
 		g_object_set (G_OBJECT (cell), "text", buffer, NULL);
@@ -175,51 +176,61 @@ void ShowFileErrorMessage (GtkWindow *parent, const gchar *message, GError *erro
 }
 
 //****************************************************************************//
-//      Get total count of slected stocks                                     //
+//      Get quotes file for chosen stock                                      //
 //****************************************************************************//
-gint GetTotalCount (GtkTreeModel *model)
+gchar* GetQuotesFile (const gchar *path, const gchar *ticker)
 {
-	// Total stock count
-	gint total = 0;
+	// Truncate stock file path
+	gchar *temp = g_strdup (path);
+	*(g_utf8_strrchr (temp, -1, '.')) = '\0';
 
-	// Get iterator position
-	GtkTreeIter iter;
-	if (gtk_tree_model_get_iter_first (GTK_TREE_MODEL (model), &iter))
-	{
-			// Iterate through all elements
-		do {
-			// Get old state
-			gboolean state;
-			gtk_tree_model_get (GTK_TREE_MODEL (model), &iter, STOCK_CHECK_ID, &state, -1);
-
-			// Increment count of selected stocks
-			if (state)
-				total++;
-
-			// Change iterator position to next element
-		} while (gtk_tree_model_iter_next (GTK_TREE_MODEL (model), &iter));
-	}
+	// Create full path string to quotes file
+	gchar *result = g_strconcat (temp, "/", ticker, ".hst", NULL);
+
+	// Free temporary string buffer
+	g_free (temp);
 
-	// Return total stocks count
-	return total;
+	// Return quote file path
+	return result;
 }
 
 //****************************************************************************//
-//      Get quotes file for chosen stock                                      //
+//      Get quotes file for chosen stock using arena memory                   //
 //****************************************************************************//
-gchar* GetQuotesFile (const gchar *path, const gchar *ticker)
+gchar* GetQuotesFile (const gchar *path, const gchar *ticker, Arena *arena)
+{
+	// Get length of stock file path without extension
+	const gchar *ext = g_utf8_strrchr (path, -1, '.');
+	gsize length = ext - path;
+
+	// Create full path string to quotes file
+	gsize size = strlen (ticker);
+	gchar *result = reinterpret_cast <gchar*> (arena -> Alloc (length + size + sizeof ("/.hst")));
+	memcpy (result, path, length);
+	result[length] = '/';
+	memcpy (result + length + 1, ticker, size);
+	memcpy (result + length + 1 + size, ".hst", sizeof (".hst"));
+
+	// Return quote file path
+	return result;
+}
+
+//****************************************************************************//
+//      Get file from quotes directory of stock list                          //
+//****************************************************************************//
+gchar* GetQuotesPath (const gchar *path, const gchar *name)
 {
 	// Truncate stock file path
 	gchar *temp = g_strdup (path);
 	*(g_utf8_strrchr (temp, -1, '.')) = '\0';
 
-	// Create full path string to quotes file
-	gchar *result = g_strconcat (temp, "/", ticker, ".hst", NULL);
+	// Create full path string to file
+	gchar *result = g_strconcat (temp, "/", name, NULL);
 
 	// Free temporary string buffer
 	g_free (temp);
 
-	// Return quote file path
+	// Return file path
 	return result;
 }
 
@@ -234,26 +245,19 @@ static void Mark (GtkToolButton *toolbutton, gpointer data)
 	// Convert data pointer
 	StatusList *list = reinterpret_cast <StatusList*> (data);
 
-	// Process all reference list elements
-	GList *element = g_list_first (list -> list);
-	while (element)
+	// Mark all stocks with chosen result status
+	for (guint i = 0; i < list -> results -> GetSize (); i++)
 	{
-		// Get tree path
-		GtkTreePath *path = gtk_tree_row_reference_get_path (reinterpret_cast <GtkTreeRowReference*> (element -> data));
-		if (path)
-		{
-			// Get iterator position
-			GtkTreeIter iter;
-			if (gtk_tree_model_get_iter (GTK_TREE_MODEL (list -> model), &iter, path))
-			{
-				// Set mark state
-				gtk_list_store_set (GTK_LIST_STORE (list -> model), &iter, STOCK_CHECK_ID, TRUE, -1);
-			}
-		}
+		// Get stock result
+		const Result *result = list -> results -> GetResult (i);
 
-		// Go to next reference list element
-		element = element -> next;
+		// Set mark state
+		if (result -> status == list -> status)
+			MarkStock (result -> index, TRUE);
 	}
+
+	// Redraw stock list
+	RedrawStocks ();
 }
 
 //****************************************************************************//
@@ -298,7 +302,7 @@ static GtkWidget* CreateToolBar (StatusList *good, StatusList *bad)
 //****************************************************************************//
 //      Report summary                                                        //
 //****************************************************************************//
-static GtkWidget* CreateReportSummary (gint total, gint errors, guint box_border, guint action_border)
+static GtkWidget* CreateReportSummary (gint total, gint errors, const gchar *details, guint box_border, guint action_border)
 {
 	// Create box
 	GtkWidget *box = gtk_box_new (GTK_ORIENTATION_HORIZONTAL, 0);
@@ -363,6 +367,52 @@ static GtkWidget* CreateReportSummary (gint total, gint errors, guint box_border
 	g_string_free (rstring, TRUE);
 	g_string_free (estring, TRUE);
 
+	// Check if report has additional details
+	if (details)
+	{
+		// Create label fields
+		GtkWidget *DetailsLabel = gtk_label_new (NULL);
+		GtkWidget *DetailsValue = gtk_label_new (NULL);
+
+		// Add labels to grid
+		gtk_grid_attach (GTK_GRID (lgrid), GTK_WIDGET (DetailsLabel), 0, 1, 1, 1);
+		gtk_grid_attach (GTK_GRID (lgrid), GTK_WIDGET (DetailsValue), 1, 1, 1, 1);
+
+		// Set label properties
+		gtk_label_set_selectable (GTK_LABEL (DetailsLabel), FALSE);
+		gtk_label_set_selectable (GTK_LABEL (DetailsValue), TRUE);
+		gtk_label_set_single_line_mode (GTK_LABEL (DetailsLabel), TRUE);
+		gtk_label_set_single_line_mode (GTK_LABEL (DetailsValue), TRUE);
+		gtk_widget_set_halign (GTK_WIDGET (DetailsLabel), GTK_ALIGN_END);
+		gtk_widget_set_halign (GTK_WIDGET (DetailsValue), GTK_ALIGN_START);
+
+		// Set report details
+		gtk_label_set_markup (GTK_LABEL (DetailsLabel), "<b>Statistics:</b>");
+		gtk_label_set_text (GTK_LABEL (DetailsValue), details);
+	}
+
+	// Create label fields
+	GtkWidget *ProfileLabel = gtk_label_new (NULL);
+	GtkWidget *ProfileValue = gtk_label_new (NULL);
+
+	// Add labels to grid
+	gtk_grid_attach (GTK_GRID (rgrid), GTK_WIDGET (ProfileLabel), 0, 1, 1, 1);
+	gtk_grid_attach (GTK_GRID (rgrid), GTK_WIDGET (ProfileValue), 1, 1, 1, 1);
+
+	// Set label properties
+	gtk_label_set_selectable (GTK_LABEL (ProfileLabel), FALSE);
+	gtk_label_set_selectable (GTK_LABEL (ProfileValue), TRUE);
+	gtk_label_set_single_line_mode (GTK_LABEL (ProfileLabel), TRUE);
+	gtk_label_set_single_line_mode (GTK_LABEL (ProfileValue), TRUE);
+	gtk_widget_set_halign (GTK_WIDGET (ProfileLabel), GTK_ALIGN_END);
+	gtk_widget_set_halign (GTK_WIDGET (ProfileValue), GTK_ALIGN_START);
+
+	// Set stage measurements of run
+	gchar *profile = GetProfileSummary ();
+	gtk_label_set_markup (GTK_LABEL (ProfileLabel), "<b>Timing:</b>");
+	gtk_label_set_text (GTK_LABEL (ProfileValue), profile);
+	g_free (profile);
+
 	// Return box object
 	return box;
 }
@@ -489,6 +539,7 @@ static gboolean SaveReportDialog (GtkWindow *parent, const gchar *rname, GtkTree
 	// Create file filter
 	GtkFileFilter *filter = gtk_file_filter_new ();
 	gtk_file_filter_add_pattern (GTK_FILE_FILTER (filter), "*.tsv");
+	gtk_file_filter_add_pattern (GTK_FILE_FILTER (filter), "*.csv");
 
 	// Add file filter to file chooser
 	gtk_file_chooser_set_filter (GTK_FILE_CHOOSER (dialog), GTK_FILE_FILTER (filter));
@@ -644,20 +695,42 @@ ProgressDialog CreateProgressDialog (GtkWindow *parent, const gchar *message, gb
 	gtk_widget_show_all (GTK_WIDGET (dialog));
 
 	// Return progress window structure
-	return {GTK_WINDOW (dialog), GTK_PROGRESS_BAR (progress)};
+	return {GTK_WINDOW (dialog), GTK_PROGRESS_BAR (progress), g_get_monotonic_time ()};
+}
+
+//****************************************************************************//
+//      Update progress dialog at limited rate                                //
+//****************************************************************************//
+void UpdateProgress (ProgressDialog *pwin, gint done, gint total)
+{
+	// Skip update if previous one was done recently
+	gint64 now = g_get_monotonic_time ();
+	if (now - pwin -> updated < PROGRESS_TIME)
+		return;
+
+	// Set update time
+	pwin -> updated = now;
+
+	// Set current progress
+	if (GTK_IS_PROGRESS_BAR (pwin -> progress) && total > 0)
+		gtk_progress_bar_set_fraction (GTK_PROGRESS_BAR (pwin -> progress), static_cast <gdouble> (done) / total);
+
+	// Process pending events
+	while (gtk_events_pending ())
+		gtk_main_iteration ();
 }
 
 //****************************************************************************//
 //      Report dialog                                                         //
 //****************************************************************************//
-gboolean CreateReportDialog (GtkWindow *parent, const gchar *title, const gchar *rname, GtkTreeModel *stocks, GtkTreeModel *report, GList *good, GList *bad, GtkWidget* (*CreateList) (GtkTreeModel *model), gboolean (*SaveReport) (const gchar *fname, GtkTreeModel *model, GError **error), gint total, gint errors)
+gboolean CreateReportDialog (GtkWindow *parent, const gchar *title, const gchar *rname, GtkTreeModel *report, Results *results, GtkWidget* (*CreateList) (GtkTreeModel *model), gboolean (*SaveReport) (const gchar *fname, GtkTreeModel *model, GError **error), gint total, gint errors, const gchar *details)
 {
 	// Operation status
 	gboolean status = FALSE;
 
 	// Create status lists
-	StatusList glist = {stocks, good};
-	StatusList blist = {stocks, bad};
+	StatusList glist = {results, RESULT_GOOD};
+	StatusList blist = {results, RESULT_BAD};
 
 	// Create dialog window
 	GtkWidget *window = gtk_dialog_new_with_buttons (title, GTK_WINDOW (parent), GTK_DIALOG_MODAL, "_Close", GTK_RESPONSE_CANCEL, "_Save", GTK_RESPONSE_ACCEPT, NULL);
@@ -671,7 +744,7 @@ gboolean CreateReportDialog (GtkWindow *parent, const gchar *title, const gchar
 	// Add items to box
 	gtk_box_pack_start (GTK_BOX (box), GTK_WIDGET (CreateToolBar (&glist, &blist)), FALSE, FALSE, 0);
 	gtk_box_pack_start (GTK_BOX (box), GTK_WIDGET (CreateList (report)), TRUE, TRUE, 0);
-	gtk_box_pack_start (GTK_BOX (box), GTK_WIDGET (CreateReportSummary (total, errors, gtk_container_get_border_width (GTK_CONTAINER (box)), gtk_container_get_border_width (GTK_CONTAINER (action)))), FALSE, FALSE, 0);
+	gtk_box_pack_start (GTK_BOX (box), GTK_WIDGET (CreateReportSummary (total, errors, details, gtk_container_get_border_width (GTK_CONTAINER (box)), gtk_container_get_border_width (GTK_CONTAINER (action)))), FALSE, FALSE, 0);
 
 	// Set default dialog button
 	gtk_dialog_set_default_response (GTK_DIALOG (window), GTK_RESPONSE_ACCEPT);
@@ -692,10 +765,6 @@ gboolean CreateReportDialog (GtkWindow *parent, const gchar *title, const gchar
 	// Decrement reference count to list
 	g_object_unref (GTK_LIST_STORE (report));
 
-	// Release lists of references
-	g_list_free_full (good, reinterpret_cast <GDestroyNotify> (gtk_tree_row_reference_free));
-	g_list_free_full (bad, reinterpret_cast <GDestroyNotify> (gtk_tree_row_reference_free));
-
 	// Destroy dialog widget
 	gtk_widget_destroy (GTK_WIDGET (window));
 
@@ -0,0 +1,210 @@
+/*                                                                     Dates.cpp
+################################################################################
+# Encoding: UTF-8                                                  Tab size: 4 #
+#                                                                              #
+#                                  DATE CODEC                                  #
+#                                                                              #
+# License: LGPLv3+                               Copyleft (Ɔ) 2014, Jack Black #
+################################################################################
+*/
+# include	<Dates.h>
+
+//****************************************************************************//
+//      Calendar table constants                                              //
+//****************************************************************************//
+# define	DATE_YEARS			(DATE_LAST_YEAR - DATE_FIRST_YEAR + 1)	// Count of years in calendar table
+# define	DATE_DAYS			73049		// Count of days in calendar table
+# define	DATE_EPOCH			(-25567)	// Day number of first day of calendar table
+
+//****************************************************************************//
+//      Local objects                                                         //
+//****************************************************************************//
+static	gsize		ready = 0;				// Calendar table is initialized
+static	gint32		years [DATE_YEARS];		// Day numbers of first days of years
+static	guint32		days [DATE_DAYS];		// Packed dates of all days
+static	gchar		digits [200];			// Decimal digit pairs from 00 to 99
+
+//============================================================================//
+//      Count of days before month                                            //
+//============================================================================//
+static const guint16 months [2][13] = {
+	{0, 31, 59, 90, 120, 151, 181, 212, 243, 273, 304, 334, 365},
+	{0, 31, 60, 91, 121, 152, 182, 213, 244, 274, 305, 335, 366}
+};
+
+//****************************************************************************//
+//      Internal functions                                                    //
+//****************************************************************************//
+
+//============================================================================//
+//      Check for leap year                                                   //
+//============================================================================//
+static guint IsLeapYear (guint year)
+{
+	return (year % 4 == 0 && year % 100 != 0) || year % 400 == 0;
+}
+
+//============================================================================//
+//      Fill calendar table                                                   //
+//============================================================================//
+static void InitCalendar (void)
+{
+	// Check if calendar table is not initialized yet
+	if (g_once_init_enter (&ready))
+	{
+		// Fill decimal digit pairs
+		for (guint i = 0; i < 100; i++)
+		{
+			digits [2 * i] = '0' + i / 10;
+			digits [2 * i + 1] = '0' + i % 10;
+		}
+
+		// Fill packed dates of all days
+		gint32 number = DATE_EPOCH;
+		guint32 *ptr = days;
+		for (guint year = DATE_FIRST_YEAR; year <= DATE_LAST_YEAR; year++)
+		{
+			// Set day number of first day of year
+			years [year - DATE_FIRST_YEAR] = number;
+
+			// Fill days of all months
+			guint leap = IsLeapYear (year);
+			for (guint mon = 1; mon <= 12; mon++)
+			{
+				guint count = months [leap][mon] - months [leap][mon - 1];
+				for (guint day = 1; day <= count; day++)
+					*ptr++ = year << 9 | mon << 5 | day;
+			}
+
+			// Go to next year
+			number += months [leap][12];
+		}
+
+		// Mark calendar table as initialized
+		g_once_init_leave (&ready, 1);
+	}
+}
+
+//****************************************************************************//
+//      Global functions                                                      //
+//****************************************************************************//
+
+//============================================================================//
+//      Convert date into time stamp                                          //
+//============================================================================//
+time_t MakeDate (gint64 year, guint mon, guint day)
+{
+	// Check if date is out of calendar table range
+	if (year < DATE_FIRST_YEAR || year > DATE_LAST_YEAR)
+		return Time::ConvertDate (day, mon, year, 0, 0, 0);
+
+	// Init calendar table
+	InitCalendar ();
+
+	// Check month and day
+	guint leap = IsLeapYear (year);
+	if (mon < 1 || mon > 12 || day < 1 || day > static_cast <guint> (months [leap][mon] - months [leap][mon - 1]))
+		return TIME_ERROR;
+
+	// Convert day number into time stamp
+	gint32 number = years [year - DATE_FIRST_YEAR] + months [leap][mon - 1] + day - 1;
+	return static_cast <time_t> (number) * TIME_DAY;
+}
+
+//============================================================================//
+//      Extract date from time stamp                                          //
+//============================================================================//
+date_struct GetDate (time_t date)
+{
+	// Get day number
+	time_t number = date / TIME_DAY;
+	if (date % TIME_DAY < 0)
+		number--;
+
+	// Check if date is out of calendar table range
+	time_t index = number - DATE_EPOCH;
+	if (index < 0 || index >= DATE_DAYS)
+		return Time::ExtractDate (date);
+
+	// Init calendar table
+	InitCalendar ();
+
+	// Unpack date
+	guint32 packed = days [index];
+	date_struct result;
+	result.year = packed >> 9;
+	result.mon = packed >> 5 & 0xF;
+	result.day = packed & 0x1F;
+
+	// Return date structure
+	return result;
+}
+
+//============================================================================//
+//      Parse date in ISO format                                              //
+//============================================================================//
+gsize ParseDate (const gchar *string, time_t *date)
+{
+	// Check ISO date shape
+	for (guint i = 0; i < 10; i++)
+	{
+		if (i == 4 || i == 7)
+		{
+			if (string [i] != '-')
+				return 0;
+		}
+		else if (!g_ascii_isdigit (string [i]))
+			return 0;
+	}
+
+	// Day should have two digits only
+	if (g_ascii_isdigit (string [10]))
+		return 0;
+
+	// Convert date into time stamp
+	guint year = (string [0] - '0') * 1000 + (string [1] - '0') * 100 + (string [2] - '0') * 10 + (string [3] - '0');
+	guint mon = (string [5] - '0') * 10 + (string [6] - '0');
+	guint day = (string [8] - '0') * 10 + (string [9] - '0');
+	*date = MakeDate (year, mon, day);
+
+	// Return count of parsed symbols
+	return 10;
+}
+
+//============================================================================//
+//      Format date in ISO format                                             //
+//============================================================================//
+gsize FormatDate (time_t date, gchar buffer[])
+{
+	// Extract date from time stamp
+	date_struct curdate = GetDate (date);
+
+	// Check if year is out of four digit range
+	if (curdate.year < 0 || curdate.year > 9999)
+		return g_snprintf (buffer, DATE_SIZE, "%.4li-%.2d-%.2d", static_cast <glong> (curdate.year), curdate.mon, curdate.day);
+
+	// Init calendar table
+	InitCalendar ();
+
+	// Copy digit pairs into buffer
+	guint year = curdate.year;
+	buffer [0] = digits [2 * (year / 100)];
+	buffer [1] = digits [2 * (year / 100) + 1];
+	buffer [2] = digits [2 * (year % 100)];
+	buffer [3] = digits [2 * (year % 100) + 1];
+	buffer [4] = '-';
+	buffer [5] = digits [2 * curdate.mon];
+	buffer [6] = digits [2 * curdate.mon + 1];
+	buffer [7] = '-';
+	buffer [8] = digits [2 * curdate.day];
+	buffer [9] = digits [2 * curdate.day + 1];
+	buffer [10] = '\0';
+
+	// Return length of string
+	return 10;
+}
+/*
+################################################################################
+#                                 END OF FILE                                  #
+################################################################################
+*/
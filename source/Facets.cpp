@@ -0,0 +1,325 @@
+/*                                                                    Facets.cpp
+################################################################################
+# Encoding: UTF-8                                                  Tab size: 4 #
+#                                                                              #
+#                                 FACETS CLASS                                 #
+#                                                                              #
+# License: LGPLv3+                               Copyleft (Ɔ) 2014, Jack Black #
+################################################################################
+*/
+# include	<StockList.h>
+# include	<Facets.h>
+# include	<string.h>
+
+//****************************************************************************//
+//      Internal constants                                                    //
+//****************************************************************************//
+# define	WORD_SHIFT		6			// Shift to convert row index into word index
+# define	WORD_MASK		63			// Mask to extract bit position from row index
+
+//****************************************************************************//
+//      Internal functions                                                    //
+//****************************************************************************//
+
+//============================================================================//
+//      Free facets object                                                    //
+//============================================================================//
+static void FreeFacets (gpointer data)
+{
+	delete reinterpret_cast <Facets*> (data);
+}
+
+//============================================================================//
+//      Free facet value                                                      //
+//============================================================================//
+static void FreeValue (gpointer data)
+{
+	// Convert value pointer
+	FacetValue *value = reinterpret_cast <FacetValue*> (data);
+
+	// Free value elements
+	g_free (value -> name);
+	g_free (value -> bits);
+	g_free (value);
+}
+
+//============================================================================//
+//      Compare facet values by name                                          //
+//============================================================================//
+static gint CompareValues (gconstpointer a, gconstpointer b)
+{
+	// Convert value pointers
+	const FacetValue *va = *reinterpret_cast <FacetValue* const*> (a);
+	const FacetValue *vb = *reinterpret_cast <FacetValue* const*> (b);
+
+	// Compare value names
+	return g_utf8_collate (va -> name, vb -> name);
+}
+
+//============================================================================//
+//      Set bit of selection index                                            //
+//============================================================================//
+static inline void SetBit (guint64 bits[], guint index)
+{
+	bits[index >> WORD_SHIFT] |= G_GUINT64_CONSTANT (1) << (index & WORD_MASK);
+}
+
+//****************************************************************************//
+//      Constructor                                                           //
+//****************************************************************************//
+Facets::Facets (void)
+{
+	// Set facets elements to default values
+	model = NULL;
+	for (guint i = 0; i < FACET_COLUMNS; i++)
+	{
+		tables [i] = g_hash_table_new (g_str_hash, g_str_equal);
+		values [i] = g_ptr_array_new_with_free_func (FreeValue);
+	}
+	all = NULL;
+	result = NULL;
+	words = 0;
+	count = 0;
+	dirty = TRUE;
+}
+
+//****************************************************************************//
+//      Destructor                                                            //
+//****************************************************************************//
+Facets::~Facets (void)
+{
+	// Free facets elements
+	Clear ();
+	for (guint i = 0; i < FACET_COLUMNS; i++)
+	{
+		g_hash_table_unref (tables [i]);
+		g_ptr_array_unref (values [i]);
+	}
+
+	// Set facets elements to default values
+	model = NULL;
+}
+
+//****************************************************************************//
+//      Free facets elements                                                  //
+//****************************************************************************//
+void Facets::Clear (void)
+{
+	// Free facet values
+	for (guint i = 0; i < FACET_COLUMNS; i++)
+	{
+		g_hash_table_remove_all (tables [i]);
+		g_ptr_array_set_size (values [i], 0);
+	}
+
+	// Free bitsets
+	g_free (all);
+	g_free (result);
+
+	// Set facets elements to default values
+	all = NULL;
+	result = NULL;
+	words = 0;
+	count = 0;
+}
+
+//****************************************************************************//
+//      Rebuild facets from stock list                                        //
+//****************************************************************************//
+void Facets::Build (void)
+{
+	// Free old facets
+	Clear ();
+
+	// Find max selection index of stock list
+	guint size = 0;
+	GtkTreeIter iter;
+	if (gtk_tree_model_get_iter_first (model, &iter))
+	{
+		// Iterate through all elements
+		do {
+			// Get selection index
+			guint index;
+			gtk_tree_model_get (model, &iter, STOCK_INDEX_ID, &index, -1);
+
+			// Update count of selection indices
+			size = MAX (size, index + 1);
+
+			// Change iterator position to next element
+		} while (gtk_tree_model_iter_next (model, &iter));
+	}
+
+	// Allocate bitsets
+	words = (size + WORD_MASK) >> WORD_SHIFT;
+	all = g_new0 (guint64, words);
+	result = g_new0 (guint64, words);
+
+	// Fill facet values
+	if (gtk_tree_model_get_iter_first (model, &iter))
+	{
+		// Iterate through all elements
+		do {
+			// Get stock fields
+			gchar *fields [FACET_COLUMNS];
+			guint index;
+			gtk_tree_model_get (model, &iter, STOCK_COUNTRY_ID, &fields [FACET_COUNTRY], STOCK_SECTOR_ID, &fields [FACET_SECTOR], STOCK_INDUSTRY_ID, &fields [FACET_INDUSTRY], STOCK_INDEX_ID, &index, -1);
+
+			// Add stock to all stocks
+			SetBit (all, index);
+
+			// Add stock to its facet values
+			for (guint i = 0; i < FACET_COLUMNS; i++)
+			{
+				// Find facet value
+				const gchar *name = fields [i] ? fields [i] : "";
+				FacetValue *value = reinterpret_cast <FacetValue*> (g_hash_table_lookup (tables [i], name));
+
+				// Create new facet value if it is not found
+				if (!value)
+				{
+					value = g_new (FacetValue, 1);
+					value -> name = g_strdup (name);
+					value -> bits = g_new0 (guint64, words);
+					value -> count = 0;
+					g_hash_table_insert (tables [i], value -> name, value);
+					g_ptr_array_add (values [i], value);
+				}
+
+				// Add stock to facet value
+				SetBit (value -> bits, index);
+				value -> count++;
+
+				// Free temporary string buffer
+				g_free (fields [i]);
+			}
+
+			// Change iterator position to next element
+		} while (gtk_tree_model_iter_next (model, &iter));
+	}
+
+	// Sort facet values by name
+	for (guint i = 0; i < FACET_COLUMNS; i++)
+		g_ptr_array_sort (values [i], CompareValues);
+
+	// Facets are up to date
+	dirty = FALSE;
+}
+
+//****************************************************************************//
+//      Signal handler for changes of stock list                              //
+//****************************************************************************//
+void Facets::ListChanged (GtkTreeModel *model, GtkTreePath *path, GtkTreeIter *iter, gpointer data)
+{
+	reinterpret_cast <Facets*> (data) -> dirty = TRUE;
+}
+
+//****************************************************************************//
+//      Signal handler for "row-deleted" signal of stock list                 //
+//****************************************************************************//
+void Facets::RowDeleted (GtkTreeModel *model, GtkTreePath *path, gpointer data)
+{
+	reinterpret_cast <Facets*> (data) -> dirty = TRUE;
+}
+
+//****************************************************************************//
+//      Attach facets to stock list                                           //
+//****************************************************************************//
+void Facets::Attach (GtkListStore *list)
+{
+	// Set indexed stock list
+	model = GTK_TREE_MODEL (list);
+
+	// Rebuild facets after any change of stock list
+	g_signal_connect (G_OBJECT (list), "row-changed", G_CALLBACK (ListChanged), this);
+	g_signal_connect (G_OBJECT (list), "row-inserted", G_CALLBACK (ListChanged), this);
+	g_signal_connect (G_OBJECT (list), "row-deleted", G_CALLBACK (RowDeleted), this);
+
+	// Stock list frees facets with itself
+	g_object_set_data_full (G_OBJECT (list), FACETS_DATA, this, FreeFacets);
+}
+
+//****************************************************************************//
+//      Get values of facet sorted by name                                    //
+//****************************************************************************//
+const GPtrArray* Facets::GetValues (guint facet)
+{
+	// Rebuild facets if stock list was changed
+	if (dirty)
+		Build ();
+
+	// Return facet values
+	return facet < FACET_COLUMNS ? values [facet] : NULL;
+}
+
+//****************************************************************************//
+//      Find stocks which have all required facet values                      //
+//****************************************************************************//
+guint Facets::Intersect (const gchar *names[])
+{
+	// Rebuild facets if stock list was changed
+	if (dirty)
+		Build ();
+
+	// Start from all stocks
+	memcpy (result, all, words * sizeof (guint64));
+
+	// Intersect bitsets of required facet values
+	for (guint i = 0; i < FACET_COLUMNS; i++)
+	{
+		// Skip facets which match any value
+		if (!names[i])
+			continue;
+
+		// Find facet value
+		FacetValue *value = reinterpret_cast <FacetValue*> (g_hash_table_lookup (tables [i], names[i]));
+
+		// Nothing is found if value does not exist
+		if (!value)
+		{
+			memset (result, 0, words * sizeof (guint64));
+			break;
+		}
+
+		// Intersect bitsets
+		for (guint j = 0; j < words; j++)
+			result[j] &= value -> bits[j];
+	}
+
+	// Count found stocks
+	guint total = 0;
+	for (guint i = 0; i < words; i++)
+		total += __builtin_popcountll (result[i]);
+
+	// Return count of found stocks
+	count = total;
+	return count;
+}
+
+//****************************************************************************//
+//      Get bits of found stocks                                              //
+//****************************************************************************//
+const guint64* Facets::GetResult (void) const
+{
+	return result;
+}
+
+//****************************************************************************//
+//      Get count of words in bitset of found stocks                          //
+//****************************************************************************//
+guint Facets::GetWords (void) const
+{
+	return words;
+}
+
+//****************************************************************************//
+//      Get count of found stocks                                             //
+//****************************************************************************//
+guint Facets::GetCount (void) const
+{
+	return count;
+}
+/*
+################################################################################
+#                                 END OF FILE                                  #
+################################################################################
+*/
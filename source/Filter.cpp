@@ -0,0 +1,1093 @@
+/*                                                                    Filter.cpp
+################################################################################
+# Encoding: UTF-8                                                  Tab size: 4 #
+#                                                                              #
+#                                 FILTER CLASS                                 #
+#                                                                              #
+# License: LGPLv3+                               Copyleft (Ɔ) 2014, Jack Black #
+################################################################################
+*/
+# include	<Filter.h>
+# include	<Math.h>
+# include	<Statistics.h>
+# include	<Indicators.h>
+# include	<string.h>
+
+//****************************************************************************//
+//      Filter constants                                                      //
+//****************************************************************************//
+
+//============================================================================//
+//      Operation codes                                                       //
+//============================================================================//
+# define	FILTER_OP_CONST			0		// Push constant value
+# define	FILTER_OP_VAR			1		// Push quote variable
+# define	FILTER_OP_METRIC		2		// Push metric value
+# define	FILTER_OP_ADD			3		// Addition
+# define	FILTER_OP_SUB			4		// Subtraction
+# define	FILTER_OP_MUL			5		// Multiplication
+# define	FILTER_OP_DIV			6		// Division
+# define	FILTER_OP_NEG			7		// Negation
+# define	FILTER_OP_NOT			8		// Logical not
+# define	FILTER_OP_LT			9		// Less than
+# define	FILTER_OP_LE			10		// Less than or equal
+# define	FILTER_OP_GT			11		// Greater than
+# define	FILTER_OP_GE			12		// Greater than or equal
+# define	FILTER_OP_EQ			13		// Equal
+# define	FILTER_OP_NE			14		// Not equal
+# define	FILTER_OP_JUMP_FALSE	15		// Jump if false, otherwise drop value
+# define	FILTER_OP_JUMP_TRUE		16		// Jump if true, otherwise drop value
+
+//============================================================================//
+//      Quote variables                                                       //
+//============================================================================//
+# define	FILTER_VAR_COUNT		0		// Count of quotes
+# define	FILTER_VAR_OPEN			1		// Last open price
+# define	FILTER_VAR_HIGH			2		// Last high price
+# define	FILTER_VAR_LOW			3		// Last low price
+# define	FILTER_VAR_CLOSE		4		// Last close price
+# define	FILTER_VAR_VOLUME		5		// Last volume
+# define	FILTER_VAR_VOLUME_RANK	6		// Percentile rank of last volume among all stocks
+# define	FILTER_VAR_RANGE_RANK	7		// Percentile rank of last daily range among all stocks
+# define	FILTER_VAR_CHANGE_RANK	8		// Percentile rank of last price change among all stocks
+
+//============================================================================//
+//      Evaluation costs                                                      //
+//============================================================================//
+# define	FILTER_COST_OP			1.0		// Cost of single instruction
+# define	FILTER_COST_MEDIAN_VOL	4.0		// Cost of median volume per quote
+# define	FILTER_COST_VOLATILITY	24.0	// Cost of daily range per quote
+# define	FILTER_COST_ATR_PCT		4.0		// Cost of true range per quote
+# define	FILTER_COST_SMA			1.0		// Cost of moving average per quote
+# define	FILTER_COST_CHANGE_PCT	0.0		// Cost of price change per quote
+
+//============================================================================//
+//      Term statistics                                                       //
+//============================================================================//
+# define	FILTER_REORDER_PERIOD	64		// Evaluations between term reorderings
+# define	FILTER_STATS_LIMIT		0x10000	// Max count of checks to keep in statistics
+
+//****************************************************************************//
+//      Filter name structure                                                 //
+//****************************************************************************//
+struct FilterName
+{
+	const gchar	*name;			// Name in filter expression
+	guint		id;				// Variable or function id
+};
+
+//****************************************************************************//
+//      Filter parser structure                                               //
+//****************************************************************************//
+struct FilterParser
+{
+	const gchar	*source;		// Filter expression
+	const gchar	*pos;			// Current parse position
+	GArray		*code;			// Compiled code
+	GArray		*terms;			// Terms of top level conjunction
+	GArray		*metrics;		// Metrics used by expression
+	gboolean	split;			// Split top level conjunction into terms
+	gboolean	mixed;			// Top level expression is not a conjunction
+};
+
+//****************************************************************************//
+//      Filter names                                                          //
+//****************************************************************************//
+static const FilterName variables[] = {
+	{"count",		FILTER_VAR_COUNT},
+	{"open",		FILTER_VAR_OPEN},
+	{"high",		FILTER_VAR_HIGH},
+	{"low",			FILTER_VAR_LOW},
+	{"close",		FILTER_VAR_CLOSE},
+	{"price",		FILTER_VAR_CLOSE},
+	{"volume",		FILTER_VAR_VOLUME},
+	{"volume_rank",	FILTER_VAR_VOLUME_RANK},
+	{"range_rank",	FILTER_VAR_RANGE_RANK},
+	{"change_rank",	FILTER_VAR_CHANGE_RANK}
+};
+
+static const FilterName functions[] = {
+	{"median_vol",	FILTER_FUNC_MEDIAN_VOL},
+	{"volatility",	FILTER_FUNC_VOLATILITY},
+	{"atr_pct",		FILTER_FUNC_ATR_PCT},
+	{"sma",			FILTER_FUNC_SMA},
+	{"change_pct",	FILTER_FUNC_CHANGE_PCT}
+};
+
+//****************************************************************************//
+//      Internal functions                                                    //
+//****************************************************************************//
+
+//============================================================================//
+//      Skip white spaces                                                     //
+//============================================================================//
+static void SkipSpaces (FilterParser *parser)
+{
+	while (g_ascii_isspace (*parser -> pos))
+		parser -> pos++;
+}
+
+//============================================================================//
+//      Match operator token                                                  //
+//============================================================================//
+static gboolean Match (FilterParser *parser, const gchar *token)
+{
+	// Skip white spaces
+	SkipSpaces (parser);
+
+	// Check if token is at current position
+	gsize len = strlen (token);
+	if (strncmp (parser -> pos, token, len) == 0)
+	{
+		// Move to next token
+		parser -> pos += len;
+
+		// Return success state
+		return TRUE;
+	}
+
+	// Return fail status
+	return FALSE;
+}
+
+//============================================================================//
+//      Set syntax error                                                      //
+//============================================================================//
+static gboolean SyntaxError (FilterParser *parser, const gchar *message, GError **error)
+{
+	// Set error message
+	g_set_error (error, G_FILE_ERROR, G_FILE_ERROR_IO, "Filter error at position %li: %s", static_cast <glong> (parser -> pos - parser -> source + 1), message);
+
+	// Return fail status
+	return FALSE;
+}
+
+//============================================================================//
+//      Emit instruction                                                      //
+//============================================================================//
+static guint Emit (FilterParser *parser, guint op, guint arg, gdouble value)
+{
+	// Append instruction to compiled code
+	FilterCode code = {op, arg, value};
+	g_array_append_val (parser -> code, code);
+
+	// Return instruction address
+	return parser -> code -> len - 1;
+}
+
+//============================================================================//
+//      Find name in name table                                               //
+//============================================================================//
+static gint FindName (const FilterName table[], gsize size, const gchar *name, gsize len)
+{
+	for (gsize i = 0; i < size; i++)
+		if (strlen (table[i].name) == len && strncmp (table[i].name, name, len) == 0)
+			return table[i].id;
+
+	// Name was not found
+	return -1;
+}
+
+//============================================================================//
+//      Get slot of metric                                                    //
+//============================================================================//
+static guint GetMetricSlot (GArray *metrics, guint func, guint period)
+{
+	// Reuse slot of the same metric
+	for (guint i = 0; i < metrics -> len; i++)
+	{
+		const FilterMetric *metric = &g_array_index (metrics, FilterMetric, i);
+		if (metric -> func == func && metric -> period == period)
+			return i;
+	}
+
+	// Add new metric
+	FilterMetric metric = {func, period};
+	g_array_append_val (metrics, metric);
+
+	// Return slot of new metric
+	return metrics -> len - 1;
+}
+
+//============================================================================//
+//      Estimate evaluation cost of code range                                //
+//============================================================================//
+static gdouble EstimateCost (FilterParser *parser, guint start, guint end)
+{
+	// Metric costs per quote
+	static const gdouble costs[] = {FILTER_COST_MEDIAN_VOL, FILTER_COST_VOLATILITY, FILTER_COST_ATR_PCT, FILTER_COST_SMA, FILTER_COST_CHANGE_PCT};
+
+	// Sum costs of all instructions
+	gdouble cost = 0.0;
+	for (guint i = start; i < end; i++)
+	{
+		const FilterCode *code = &g_array_index (parser -> code, FilterCode, i);
+		cost += FILTER_COST_OP;
+		if (code -> op == FILTER_OP_METRIC)
+		{
+			const FilterMetric *metric = &g_array_index (parser -> metrics, FilterMetric, code -> arg);
+			cost += costs[metric -> func] * metric -> period;
+		}
+	}
+
+	// Return code range cost
+	return cost;
+}
+
+//============================================================================//
+//      Add top level term                                                    //
+//============================================================================//
+static void AddTerm (FilterParser *parser, const gchar *text, guint start)
+{
+	// Create new term
+	guint end = parser -> code -> len;
+	FilterTerm term = {g_strstrip (g_strndup (text, parser -> pos - text)), start, end, EstimateCost (parser, start, end), 0, 0, 0};
+
+	// Append term to term list
+	g_array_append_val (parser -> terms, term);
+}
+
+// Forward declaration of top expression parser
+static gboolean ParseOr (FilterParser *parser, gboolean top, GError **error);
+
+//============================================================================//
+//      Parse primary expression                                              //
+//============================================================================//
+static gboolean ParsePrimary (FilterParser *parser, GError **error)
+{
+	// Skip white spaces
+	SkipSpaces (parser);
+
+	// Check for nested expression
+	if (Match (parser, "("))
+	{
+		if (!ParseOr (parser, FALSE, error))
+			return FALSE;
+		if (!Match (parser, ")"))
+			return SyntaxError (parser, "missing ')'", error);
+		return TRUE;
+	}
+
+	// Check for number
+	if (g_ascii_isdigit (*parser -> pos) || *parser -> pos == '.')
+	{
+		gchar *end;
+		gdouble value = g_ascii_strtod (parser -> pos, &end);
+		if (end == parser -> pos)
+			return SyntaxError (parser, "bad number", error);
+		parser -> pos = end;
+		Emit (parser, FILTER_OP_CONST, 0, value);
+		return TRUE;
+	}
+
+	// Check for name
+	if (g_ascii_isalpha (*parser -> pos) || *parser -> pos == '_')
+	{
+		// Get name length
+		const gchar *name = parser -> pos;
+		while (g_ascii_isalnum (*parser -> pos) || *parser -> pos == '_')
+			parser -> pos++;
+		gsize len = parser -> pos - name;
+
+		// Check if name is quote variable
+		gint id = FindName (variables, G_N_ELEMENTS (variables), name, len);
+		if (id >= 0)
+		{
+			Emit (parser, FILTER_OP_VAR, id, 0.0);
+			return TRUE;
+		}
+
+		// Check if name is metric function
+		id = FindName (functions, G_N_ELEMENTS (functions), name, len);
+		if (id >= 0)
+		{
+			// Parse function period
+			if (!Match (parser, "("))
+				return SyntaxError (parser, "missing '(' after function name", error);
+			SkipSpaces (parser);
+			gchar *end;
+			guint64 period = g_ascii_strtoull (parser -> pos, &end, 10);
+			if (end == parser -> pos || period == 0 || period > G_MAXUINT)
+				return SyntaxError (parser, "function period must be a positive integer", error);
+			parser -> pos = end;
+			if (!Match (parser, ")"))
+				return SyntaxError (parser, "missing ')'", error);
+
+			// Emit metric access
+			Emit (parser, FILTER_OP_METRIC, GetMetricSlot (parser -> metrics, id, period), 0.0);
+			return TRUE;
+		}
+
+		// Unknown name
+		parser -> pos = name;
+		return SyntaxError (parser, "unknown name", error);
+	}
+
+	// Unexpected token
+	return SyntaxError (parser, "value expected", error);
+}
+
+//============================================================================//
+//      Parse unary expression                                                //
+//============================================================================//
+static gboolean ParseUnary (FilterParser *parser, GError **error)
+{
+	// Check for unary operator
+	SkipSpaces (parser);
+	if (parser -> pos[0] == '!' && parser -> pos[1] != '=')
+	{
+		parser -> pos++;
+		if (!ParseUnary (parser, error))
+			return FALSE;
+		Emit (parser, FILTER_OP_NOT, 0, 0.0);
+		return TRUE;
+	}
+	if (Match (parser, "-"))
+	{
+		if (!ParseUnary (parser, error))
+			return FALSE;
+		Emit (parser, FILTER_OP_NEG, 0, 0.0);
+		return TRUE;
+	}
+
+	// Parse primary expression
+	return ParsePrimary (parser, error);
+}
+
+//============================================================================//
+//      Parse product expression                                              //
+//============================================================================//
+static gboolean ParseProduct (FilterParser *parser, GError **error)
+{
+	// Parse first operand
+	if (!ParseUnary (parser, error))
+		return FALSE;
+
+	// Parse next operands
+	while (TRUE)
+	{
+		guint op;
+		if (Match (parser, "*"))
+			op = FILTER_OP_MUL;
+		else if (Match (parser, "/"))
+			op = FILTER_OP_DIV;
+		else
+			return TRUE;
+		if (!ParseUnary (parser, error))
+			return FALSE;
+		Emit (parser, op, 0, 0.0);
+	}
+}
+
+//============================================================================//
+//      Parse sum expression                                                  //
+//============================================================================//
+static gboolean ParseSum (FilterParser *parser, GError **error)
+{
+	// Parse first operand
+	if (!ParseProduct (parser, error))
+		return FALSE;
+
+	// Parse next operands
+	while (TRUE)
+	{
+		guint op;
+		if (Match (parser, "+"))
+			op = FILTER_OP_ADD;
+		else if (Match (parser, "-"))
+			op = FILTER_OP_SUB;
+		else
+			return TRUE;
+		if (!ParseProduct (parser, error))
+			return FALSE;
+		Emit (parser, op, 0, 0.0);
+	}
+}
+
+//============================================================================//
+//      Parse comparison expression                                           //
+//============================================================================//
+static gboolean ParseCompare (FilterParser *parser, GError **error)
+{
+	// Parse first operand
+	if (!ParseSum (parser, error))
+		return FALSE;
+
+	// Parse next operands
+	while (TRUE)
+	{
+		guint op;
+		if (Match (parser, "<="))
+			op = FILTER_OP_LE;
+		else if (Match (parser, ">="))
+			op = FILTER_OP_GE;
+		else if (Match (parser, "=="))
+			op = FILTER_OP_EQ;
+		else if (Match (parser, "!="))
+			op = FILTER_OP_NE;
+		else if (Match (parser, "<"))
+			op = FILTER_OP_LT;
+		else if (Match (parser, ">"))
+			op = FILTER_OP_GT;
+		else
+			return TRUE;
+		if (!ParseSum (parser, error))
+			return FALSE;
+		Emit (parser, op, 0, 0.0);
+	}
+}
+
+//============================================================================//
+//      Parse conjunction expression                                          //
+//============================================================================//
+static gboolean ParseAnd (FilterParser *parser, gboolean top, GError **error)
+{
+	// Check if operands are terms of top level conjunction
+	gboolean split = top && parser -> split;
+
+	// Parse first operand
+	SkipSpaces (parser);
+	const gchar *text = parser -> pos;
+	guint start = parser -> code -> len;
+	if (!ParseCompare (parser, error))
+		return FALSE;
+	if (split)
+		AddTerm (parser, text, start);
+
+	// Parse next operands
+	while (Match (parser, "&&"))
+	{
+		if (split)
+		{
+			// Compile operand as separate term
+			SkipSpaces (parser);
+			text = parser -> pos;
+			start = parser -> code -> len;
+			if (!ParseCompare (parser, error))
+				return FALSE;
+			AddTerm (parser, text, start);
+		}
+		else
+		{
+			// Skip second operand if first operand is false
+			guint jump = Emit (parser, FILTER_OP_JUMP_FALSE, 0, 0.0);
+			if (!ParseCompare (parser, error))
+				return FALSE;
+			g_array_index (parser -> code, FilterCode, jump).arg = parser -> code -> len;
+		}
+	}
+
+	// Return success state
+	return TRUE;
+}
+
+//============================================================================//
+//      Parse disjunction expression                                          //
+//============================================================================//
+static gboolean ParseOr (FilterParser *parser, gboolean top, GError **error)
+{
+	// Parse first operand
+	if (!ParseAnd (parser, top, error))
+		return FALSE;
+
+	// Parse next operands
+	while (Match (parser, "||"))
+	{
+		// Top level expression can not be split into terms
+		if (top && parser -> split)
+		{
+			parser -> mixed = TRUE;
+			return FALSE;
+		}
+
+		// Skip second operand if first operand is true
+		guint jump = Emit (parser, FILTER_OP_JUMP_TRUE, 0, 0.0);
+		if (!ParseAnd (parser, FALSE, error))
+			return FALSE;
+		g_array_index (parser -> code, FilterCode, jump).arg = parser -> code -> len;
+	}
+
+	// Return success state
+	return TRUE;
+}
+
+//============================================================================//
+//      Free terms of term list                                               //
+//============================================================================//
+static void FreeTerms (GArray *terms)
+{
+	for (guint i = 0; i < terms -> len; i++)
+		g_free (g_array_index (terms, FilterTerm, i).text);
+	g_array_set_size (terms, 0);
+}
+
+//============================================================================//
+//      Get term rank (lower rank terms are checked first)                    //
+//============================================================================//
+static gdouble GetRank (const FilterTerm *term)
+{
+	// Estimate probability of rejection from previous checks
+	gdouble rejection = (term -> checked - term -> passed + 1.0) / (term -> checked + 2.0);
+
+	// Cheap terms which often reject quotes go first
+	return term -> cost / rejection;
+}
+
+//============================================================================//
+//      Compare terms by rank                                                 //
+//============================================================================//
+static gint CompareTerms (gconstpointer a, gconstpointer b)
+{
+	// Get terms
+	const FilterTerm *term1 = reinterpret_cast <const FilterTerm*> (a);
+	const FilterTerm *term2 = reinterpret_cast <const FilterTerm*> (b);
+
+	// Compare term ranks
+	gdouble rank1 = GetRank (term1);
+	gdouble rank2 = GetRank (term2);
+	if (rank1 < rank2)
+		return -1;
+	if (rank1 > rank2)
+		return 1;
+
+	// Keep source order of equal terms
+	return (term1 -> start > term2 -> start) - (term1 -> start < term2 -> start);
+}
+
+//============================================================================//
+//      Compute metric value                                                  //
+//============================================================================//
+static gdouble ComputeMetric (const FilterMetric *metric, QuoteList quotes)
+{
+	// Get count of quotes to compute metric on
+	gsize count = MIN (static_cast <gsize> (metric -> period), quotes.size);
+	if (count == 0)
+		return 0.0;
+
+	// Get quotes array
+	const quote_t *array = quotes.array;
+
+	// Compute metric
+	switch (metric -> func)
+	{
+		case FILTER_FUNC_MEDIAN_VOL:
+		{
+			// Get median of volumes
+			gsize *volumes = g_new (gsize, count);
+			for (gsize i = 0; i < count; i++)
+				volumes[i] = array[i].volume;
+			gdouble result = Statistics::Median (volumes, count);
+			g_free (volumes);
+			return result;
+		}
+		case FILTER_FUNC_VOLATILITY:
+		{
+			// Get median of daily ranges
+			gfloat *ranges = g_new (gfloat, count);
+			for (gsize i = 0; i < count; i++)
+				ranges[i] = Math::Log (array[i].high / array[i].low);
+			gdouble result = Statistics::Median (ranges, count) * 100.0;
+			g_free (ranges);
+			return result;
+		}
+		case FILTER_FUNC_ATR_PCT:
+		{
+			// Get average of true ranges (one more bar gives previous close of the oldest one)
+			gsize size = MIN (count + 1, quotes.size);
+			gdouble *ranges = g_new (gdouble, size);
+			ATR (array, size, count, ranges);
+			gdouble result = ranges[0] / array[0].close * 100.0;
+			g_free (ranges);
+			return result;
+		}
+		case FILTER_FUNC_SMA:
+		{
+			// Get average of close prices
+			gdouble *closes = g_new (gdouble, 2 * count);
+			GetSeries (array, count, INDICATOR_CLOSE, closes);
+			SMA (closes, count, count, closes + count);
+			gdouble result = closes[count];
+			g_free (closes);
+			return result;
+		}
+		case FILTER_FUNC_CHANGE_PCT:
+		{
+			// Get change of close price
+			gsize first = MIN (count, quotes.size - 1);
+			return (array[0].close / array[first].close - 1.0) * 100.0;
+		}
+		default:
+			return 0.0;
+	}
+}
+
+//============================================================================//
+//      Get quote variable value                                              //
+//============================================================================//
+static gdouble GetVariable (guint id, QuoteList quotes, const gdouble ranks[])
+{
+	// Check for cross-sectional ranks
+	if (id >= FILTER_VAR_VOLUME_RANK)
+		return ranks ? ranks[id - FILTER_VAR_VOLUME_RANK] : M_NAN;
+
+	// Check if quotes array has stock quotes
+	if (quotes.size == 0)
+		return 0.0;
+
+	// Get last quote
+	const quote_t *quote = quotes.array;
+
+	// Return variable value
+	switch (id)
+	{
+		case FILTER_VAR_COUNT:
+			return quotes.size;
+		case FILTER_VAR_OPEN:
+			return quote -> open;
+		case FILTER_VAR_HIGH:
+			return quote -> high;
+		case FILTER_VAR_LOW:
+			return quote -> low;
+		case FILTER_VAR_CLOSE:
+			return quote -> close;
+		case FILTER_VAR_VOLUME:
+			return quote -> volume;
+		default:
+			return 0.0;
+	}
+}
+
+//****************************************************************************//
+//      Constructor                                                           //
+//****************************************************************************//
+Filter::Filter (void)
+{
+	// Set filter elements to default values
+	code = g_array_new (FALSE, FALSE, sizeof (FilterCode));
+	terms = g_array_new (FALSE, FALSE, sizeof (FilterTerm));
+	metrics = g_array_new (FALSE, FALSE, sizeof (FilterMetric));
+	values = NULL;
+	stamps = NULL;
+	stack = NULL;
+	generation = 0;
+	evaluations = 0;
+	ranks = NULL;
+}
+
+//****************************************************************************//
+//      Destructor                                                            //
+//****************************************************************************//
+Filter::~Filter (void)
+{
+	// Remove compiled code
+	Clear ();
+
+	// Free filter elements
+	g_array_free (code, TRUE);
+	g_array_free (terms, TRUE);
+	g_array_free (metrics, TRUE);
+
+	// Set filter elements to default values
+	code = NULL;
+	terms = NULL;
+	metrics = NULL;
+}
+
+//****************************************************************************//
+//      Remove compiled code                                                  //
+//****************************************************************************//
+void Filter::Clear (void)
+{
+	// Free filter elements
+	FreeTerms (terms);
+	g_array_set_size (code, 0);
+	g_array_set_size (metrics, 0);
+	g_free (values);
+	g_free (stamps);
+	g_free (stack);
+
+	// Set filter elements to default values
+	values = NULL;
+	stamps = NULL;
+	stack = NULL;
+	generation = 0;
+	evaluations = 0;
+}
+
+//****************************************************************************//
+//      Compile filter expression                                             //
+//****************************************************************************//
+gboolean Filter::Compile (const gchar *expression, GError **error)
+{
+	// Remove previously compiled code
+	Clear ();
+
+	// Create parser which splits top level conjunction into terms
+	FilterParser parser = {expression, expression, code, terms, metrics, TRUE, FALSE};
+
+	// Try to parse expression
+	gboolean status = ParseOr (&parser, TRUE, error);
+	if (!status && parser.mixed)
+	{
+		// Remove partially compiled code
+		Clear ();
+
+		// Compile whole expression as single term
+		parser.pos = expression;
+		parser.split = FALSE;
+		parser.mixed = FALSE;
+		SkipSpaces (&parser);
+		const gchar *text = parser.pos;
+		status = ParseOr (&parser, TRUE, error);
+		if (status)
+			AddTerm (&parser, text, 0);
+	}
+
+	// Check if whole expression was parsed
+	if (status)
+	{
+		SkipSpaces (&parser);
+		if (*parser.pos != '\0')
+			status = SyntaxError (&parser, "unexpected symbol", error);
+	}
+
+	// Check compilation status
+	if (!status)
+	{
+		// Remove partially compiled code
+		Clear ();
+
+		// Return fail status
+		return FALSE;
+	}
+
+	// Allocate metric cache and evaluation stack
+	values = g_new0 (gdouble, metrics -> len + 1);
+	stamps = g_new0 (guint, metrics -> len + 1);
+	stack = g_new0 (gdouble, code -> len + 1);
+
+	// Check cheap terms first
+	Reorder ();
+
+	// Return success state
+	return TRUE;
+}
+
+//****************************************************************************//
+//      Get metric value from cache or compute it                             //
+//****************************************************************************//
+gdouble Filter::GetMetric (guint slot, QuoteList quotes)
+{
+	// Compute metric only once per quote list
+	if (stamps[slot] != generation)
+	{
+		values[slot] = ComputeMetric (&g_array_index (metrics, FilterMetric, slot), quotes);
+		stamps[slot] = generation;
+	}
+
+	// Return metric value
+	return values[slot];
+}
+
+//****************************************************************************//
+//      Evaluate single term                                                  //
+//****************************************************************************//
+gboolean Filter::EvaluateTerm (const FilterTerm *term, QuoteList quotes)
+{
+	// Get compiled code
+	const FilterCode *program = &g_array_index (code, FilterCode, 0);
+
+	// Run term code
+	gdouble *sp = stack;
+	guint pc = term -> start;
+	while (pc < term -> end)
+	{
+		// Get instruction
+		const FilterCode *cmd = program + pc++;
+
+		// Execute instruction
+		switch (cmd -> op)
+		{
+			case FILTER_OP_CONST:
+				*sp++ = cmd -> value;
+				break;
+			case FILTER_OP_VAR:
+				*sp++ = GetVariable (cmd -> arg, quotes, ranks);
+				break;
+			case FILTER_OP_METRIC:
+				*sp++ = GetMetric (cmd -> arg, quotes);
+				break;
+			case FILTER_OP_ADD:
+				sp--;
+				sp[-1] = sp[-1] + sp[0];
+				break;
+			case FILTER_OP_SUB:
+				sp--;
+				sp[-1] = sp[-1] - sp[0];
+				break;
+			case FILTER_OP_MUL:
+				sp--;
+				sp[-1] = sp[-1] * sp[0];
+				break;
+			case FILTER_OP_DIV:
+				sp--;
+				sp[-1] = sp[-1] / sp[0];
+				break;
+			case FILTER_OP_NEG:
+				sp[-1] = -sp[-1];
+				break;
+			case FILTER_OP_NOT:
+				sp[-1] = sp[-1] == 0.0;
+				break;
+			case FILTER_OP_LT:
+				sp--;
+				sp[-1] = sp[-1] < sp[0];
+				break;
+			case FILTER_OP_LE:
+				sp--;
+				sp[-1] = sp[-1] <= sp[0];
+				break;
+			case FILTER_OP_GT:
+				sp--;
+				sp[-1] = sp[-1] > sp[0];
+				break;
+			case FILTER_OP_GE:
+				sp--;
+				sp[-1] = sp[-1] >= sp[0];
+				break;
+			case FILTER_OP_EQ:
+				sp--;
+				sp[-1] = sp[-1] == sp[0];
+				break;
+			case FILTER_OP_NE:
+				sp--;
+				sp[-1] = sp[-1] != sp[0];
+				break;
+			case FILTER_OP_JUMP_FALSE:
+				if (sp[-1] == 0.0)
+					pc = cmd -> arg;
+				else
+					sp--;
+				break;
+			case FILTER_OP_JUMP_TRUE:
+				if (sp[-1] != 0.0)
+					pc = cmd -> arg;
+				else
+					sp--;
+				break;
+		}
+	}
+
+	// Return term value
+	return sp > stack && sp[-1] != 0.0 && !Math::IsNaN (sp[-1]);
+}
+
+//****************************************************************************//
+//      Check if filter uses cross-sectional ranks                            //
+//****************************************************************************//
+gboolean Filter::UsesRanks (void) const
+{
+	for (guint i = 0; i < code -> len; i++)
+	{
+		const FilterCode *cmd = &g_array_index (code, FilterCode, i);
+		if (cmd -> op == FILTER_OP_VAR && cmd -> arg >= FILTER_VAR_VOLUME_RANK)
+			return TRUE;
+	}
+
+	// Filter does not use ranks
+	return FALSE;
+}
+
+//****************************************************************************//
+//      Set cross-sectional ranks of next stock                               //
+//****************************************************************************//
+void Filter::SetRanks (const gdouble ranks[])
+{
+	this -> ranks = ranks;
+}
+
+//****************************************************************************//
+//      Check if quotes pass filter                                           //
+//****************************************************************************//
+gboolean Filter::Evaluate (QuoteList quotes, const gchar **reject)
+{
+	// Invalidate metric cache of previous quote list
+	generation++;
+
+	// Periodically adapt term order to collected statistics
+	if (++evaluations >= FILTER_REORDER_PERIOD)
+		Reorder ();
+
+	// Check terms until first failed term
+	for (guint i = 0; i < terms -> len; i++)
+	{
+		FilterTerm *term = &g_array_index (terms, FilterTerm, i);
+		term -> checked++;
+		if (!EvaluateTerm (term, quotes))
+		{
+			// Update term statistics
+			term -> rejects++;
+
+			// Return failed term
+			if (reject)
+				*reject = term -> text;
+
+			// Return fail status
+			return FALSE;
+		}
+		term -> passed++;
+	}
+
+	// Return success state
+	return TRUE;
+}
+
+//****************************************************************************//
+//      Order terms by cost and rejection rate                                //
+//****************************************************************************//
+void Filter::Reorder (void)
+{
+	// Sort terms by rank
+	g_array_sort (terms, CompareTerms);
+
+	// Reset evaluations count
+	evaluations = 0;
+}
+
+//****************************************************************************//
+//      Get metric value computed by last evaluation                          //
+//****************************************************************************//
+gboolean Filter::FindMetric (guint func, guint period, gdouble *value) const
+{
+	// Find metric in metric cache
+	for (guint i = 0; i < metrics -> len; i++)
+	{
+		const FilterMetric *metric = &g_array_index (metrics, FilterMetric, i);
+		if (metric -> func == func && metric -> period == period && generation && stamps[i] == generation)
+		{
+			// Return metric value
+			*value = values[i];
+
+			// Return success state
+			return TRUE;
+		}
+	}
+
+	// Metric was not computed
+	return FALSE;
+}
+
+//****************************************************************************//
+//      Load term statistics                                                  //
+//****************************************************************************//
+gboolean Filter::LoadStatistics (const gchar *fname, GError **error)
+{
+	// Try to read statistics file
+	gchar *buffer;
+	if (!g_file_get_contents (fname, &buffer, NULL, error))
+		return FALSE;
+
+	// Split file content into lines
+	gchar **lines = g_strsplit (buffer, "\n", -1);
+
+	// Parse statistics of each term
+	for (gchar **line = lines; *line; line++)
+	{
+		// Get line fields: checked count, passed count and term text
+		gchar **fields = g_strsplit (*line, "\t", 3);
+		if (g_strv_length (fields) == 3)
+		{
+			// Parse counts
+			guint64 checked = g_ascii_strtoull (fields[0], NULL, 10);
+			guint64 passed = g_ascii_strtoull (fields[1], NULL, 10);
+
+			// Set statistics of matched term
+			if (passed <= checked && checked <= FILTER_STATS_LIMIT)
+			{
+				for (guint i = 0; i < terms -> len; i++)
+				{
+					FilterTerm *term = &g_array_index (terms, FilterTerm, i);
+					if (strcmp (term -> text, fields[2]) == 0)
+					{
+						term -> checked = checked;
+						term -> passed = passed;
+					}
+				}
+			}
+		}
+
+		// Free line fields
+		g_strfreev (fields);
+	}
+
+	// Free temporary buffers
+	g_strfreev (lines);
+	g_free (buffer);
+
+	// Order terms by loaded statistics
+	Reorder ();
+
+	// Return success state
+	return TRUE;
+}
+
+//****************************************************************************//
+//      Save term statistics                                                  //
+//****************************************************************************//
+gboolean Filter::SaveStatistics (const gchar *fname, GError **error) const
+{
+	// Create string buffer
+	GString *string = g_string_new (NULL);
+
+	// Append statistics of each term
+	for (guint i = 0; i < terms -> len; i++)
+	{
+		const FilterTerm *term = &g_array_index (terms, FilterTerm, i);
+
+		// Scale down old statistics to let term order follow recent runs
+		guint checked = term -> checked;
+		guint passed = term -> passed;
+		while (checked > FILTER_STATS_LIMIT)
+		{
+			checked /= 2;
+			passed /= 2;
+		}
+
+		// Append term statistics into string buffer
+		g_string_append_printf (string, "%u\t%u\t%s\n", checked, passed, term -> text);
+	}
+
+	// Try to save string buffer into file
+	gboolean status = g_file_set_contents (fname, string -> str, string -> len, error);
+
+	// Relase string buffer
+	g_string_free (string, TRUE);
+
+	// Return file operation status
+	return status;
+}
+
+//****************************************************************************//
+//      Get rejection statistics of current run                               //
+//****************************************************************************//
+gchar* Filter::GetStatistics (void) const
+{
+	// Create string buffer
+	GString *string = g_string_new (NULL);
+
+	// Append rejections of each term in check order
+	for (guint i = 0; i < terms -> len; i++)
+	{
+		const FilterTerm *term = &g_array_index (terms, FilterTerm, i);
+		if (term -> rejects)
+			g_string_append_printf (string, "%s%s: %u rejected", string -> len ? ", " : "", term -> text, term -> rejects);
+	}
+
+	// Return statistics string
+	return g_string_free (string, string -> len == 0);
+}
+/*
+################################################################################
+#                                 END OF FILE                                  #
+################################################################################
+*/
@@ -0,0 +1,505 @@
+/*                                                                Indicators.cpp
+################################################################################
+# Encoding: UTF-8                                                  Tab size: 4 #
+#                                                                              #
+#                              ROLLING INDICATORS                              #
+#                                                                              #
+# License: LGPLv3+                               Copyleft (Ɔ) 2014, Jack Black #
+################################################################################
+*/
+# include	<Indicators.h>
+# include	<Math.h>
+
+//****************************************************************************//
+//      Median heap structure                                                 //
+//****************************************************************************//
+struct MedianHeap
+{
+	gsize		*slots;			// Window slots stored in heap
+	gsize		size;			// Size of heap
+	gboolean	max;			// Heap keeps max value on top
+};
+
+//****************************************************************************//
+//      Internal functions                                                    //
+//****************************************************************************//
+
+//============================================================================//
+//      Set elements without enough history to NaN                            //
+//============================================================================//
+static gboolean CheckWindow (gsize size, gsize window, gdouble result[])
+{
+	// Check if series has at least one full window
+	if (window == 0 || window > size)
+	{
+		for (gsize i = 0; i < size; i++)
+			result[i] = M_NAN;
+		return FALSE;
+	}
+
+	// Set first elements of series to NaN
+	for (gsize i = size - window + 1; i < size; i++)
+		result[i] = M_NAN;
+
+	// Return success state
+	return TRUE;
+}
+
+//============================================================================//
+//      Check if first value must be on top of heap                           //
+//============================================================================//
+static inline gboolean Before (const MedianHeap *heap, const gdouble values[], gsize a, gsize b)
+{
+	return heap -> max ? values[a] > values[b] : values[a] < values[b];
+}
+
+//============================================================================//
+//      Swap heap elements                                                    //
+//============================================================================//
+static inline void SwapSlots (MedianHeap *heap, gsize pos[], gsize i, gsize j)
+{
+	gsize temp = heap -> slots[i];
+	heap -> slots[i] = heap -> slots[j];
+	heap -> slots[j] = temp;
+	pos[heap -> slots[i]] = i;
+	pos[heap -> slots[j]] = j;
+}
+
+//============================================================================//
+//      Move heap element up to its place                                     //
+//============================================================================//
+static gsize SiftUp (MedianHeap *heap, const gdouble values[], gsize pos[], gsize i)
+{
+	while (i)
+	{
+		gsize parent = (i - 1) / 2;
+		if (!Before (heap, values, heap -> slots[i], heap -> slots[parent]))
+			break;
+		SwapSlots (heap, pos, i, parent);
+		i = parent;
+	}
+
+	// Return new element position
+	return i;
+}
+
+//============================================================================//
+//      Move heap element down to its place                                   //
+//============================================================================//
+static void SiftDown (MedianHeap *heap, const gdouble values[], gsize pos[], gsize i)
+{
+	while (TRUE)
+	{
+		gsize top = i;
+		gsize left = 2 * i + 1;
+		gsize right = left + 1;
+		if (left < heap -> size && Before (heap, values, heap -> slots[left], heap -> slots[top]))
+			top = left;
+		if (right < heap -> size && Before (heap, values, heap -> slots[right], heap -> slots[top]))
+			top = right;
+		if (top == i)
+			break;
+		SwapSlots (heap, pos, i, top);
+		i = top;
+	}
+}
+
+//============================================================================//
+//      Compare window slots by value                                         //
+//============================================================================//
+static gint CompareSlots (gconstpointer a, gconstpointer b, gpointer data)
+{
+	// Get slot values
+	const gdouble *values = reinterpret_cast <const gdouble*> (data);
+	gdouble value1 = values[*reinterpret_cast <const gsize*> (a)];
+	gdouble value2 = values[*reinterpret_cast <const gsize*> (b)];
+
+	// Compare slot values
+	return (value1 > value2) - (value1 < value2);
+}
+
+//****************************************************************************//
+//      Extract quote field into series                                       //
+//****************************************************************************//
+void GetSeries (const quote_t array[], gsize size, guint field, gdouble result[])
+{
+	for (gsize i = 0; i < size; i++)
+	{
+		switch (field)
+		{
+			case INDICATOR_OPEN:
+				result[i] = array[i].open;
+				break;
+			case INDICATOR_HIGH:
+				result[i] = array[i].high;
+				break;
+			case INDICATOR_LOW:
+				result[i] = array[i].low;
+				break;
+			case INDICATOR_CLOSE:
+				result[i] = array[i].close;
+				break;
+			case INDICATOR_ADJCLOSE:
+				result[i] = array[i].adjclose;
+				break;
+			case INDICATOR_VOLUME:
+				result[i] = array[i].volume;
+				break;
+			default:
+				result[i] = M_NAN;
+				break;
+		}
+	}
+}
+
+//****************************************************************************//
+//      Simple moving average                                                 //
+//****************************************************************************//
+void SMA (const gdouble series[], gsize size, gsize window, gdouble result[])
+{
+	// Check window size
+	if (!CheckWindow (size, window, result))
+		return;
+
+	// Move window from the oldest bar to the latest one
+	gdouble sum = 0.0;
+	for (gsize i = size; i--;)
+	{
+		// Add new value to window and remove old one
+		sum += series[i];
+		if (i + window < size)
+			sum -= series[i+window];
+
+		// Set average of full window
+		if (i + window <= size)
+			result[i] = sum / window;
+	}
+}
+
+//****************************************************************************//
+//      Exponential moving average                                            //
+//****************************************************************************//
+void EMA (const gdouble series[], gsize size, gsize window, gdouble result[])
+{
+	// Check window size
+	if (!CheckWindow (size, window, result))
+		return;
+
+	// Use simple average of first window as initial value
+	gsize first = size - window;
+	gdouble sum = 0.0;
+	for (gsize i = first; i < size; i++)
+		sum += series[i];
+	result[first] = sum / window;
+
+	// Smooth next values
+	gdouble alpha = 2.0 / (window + 1.0);
+	for (gsize i = first; i--;)
+		result[i] = result[i+1] + alpha * (series[i] - result[i+1]);
+}
+
+//****************************************************************************//
+//      Average true range                                                    //
+//****************************************************************************//
+void ATR (const quote_t array[], gsize size, gsize window, gdouble result[])
+{
+	// Check window size
+	if (!CheckWindow (size, window, result))
+		return;
+
+	// Create ring buffer of true ranges in window
+	gdouble *ranges = g_new (gdouble, window);
+
+	// Move window from the oldest bar to the latest one
+	gdouble sum = 0.0;
+	for (gsize i = size; i--;)
+	{
+		// Get true range of bar
+		gdouble high = array[i].high;
+		gdouble low = array[i].low;
+		if (i + 1 < size)
+		{
+			high = MAX (high, array[i+1].close);
+			low = MIN (low, array[i+1].close);
+		}
+
+		// Replace the oldest true range in window
+		gsize slot = (size - 1 - i) % window;
+		if (i + window < size)
+			sum -= ranges[slot];
+		ranges[slot] = high - low;
+		sum += ranges[slot];
+
+		// Set average of full window
+		if (i + window <= size)
+			result[i] = sum / window;
+	}
+
+	// Free ring buffer
+	g_free (ranges);
+}
+
+//****************************************************************************//
+//      Rolling standard deviation                                            //
+//****************************************************************************//
+void StdDev (const gdouble series[], gsize size, gsize window, gdouble result[])
+{
+	// Check window size
+	if (!CheckWindow (size, window, result))
+		return;
+
+	// Sum values relative to the oldest value to keep precision
+	gdouble base = series[size-1];
+
+	// Move window from the oldest bar to the latest one
+	gdouble sum = 0.0;
+	gdouble sum2 = 0.0;
+	for (gsize i = size; i--;)
+	{
+		// Add new value to window
+		gdouble value = series[i] - base;
+		sum += value;
+		sum2 += value * value;
+
+		// Remove old value from window
+		if (i + window < size)
+		{
+			value = series[i+window] - base;
+			sum -= value;
+			sum2 -= value * value;
+		}
+
+		// Set deviation of full window
+		if (i + window <= size)
+		{
+			gdouble mean = sum / window;
+			gdouble variance = sum2 / window - mean * mean;
+			result[i] = Math::Sqrt (MAX (variance, 0.0));
+		}
+	}
+}
+
+//****************************************************************************//
+//      Rolling minimum                                                       //
+//****************************************************************************//
+void RollingMin (const gdouble series[], gsize size, gsize window, gdouble result[])
+{
+	// Check window size
+	if (!CheckWindow (size, window, result))
+		return;
+
+	// Create monotonic deque of bar indices with increasing values
+	gsize *deque = g_new (gsize, window);
+	gsize head = 0;
+	gsize count = 0;
+
+	// Move window from the oldest bar to the latest one
+	for (gsize i = size; i--;)
+	{
+		// Remove bars which can not be window minimum any more
+		while (count && series[deque[(head + count - 1) % window]] >= series[i])
+			count--;
+
+		// Remove bar which left window
+		if (count && deque[head] >= i + window)
+		{
+			head = (head + 1) % window;
+			count--;
+		}
+
+		// Add new bar
+		deque[(head + count) % window] = i;
+		count++;
+
+		// Set minimum of full window
+		if (i + window <= size)
+			result[i] = series[deque[head]];
+	}
+
+	// Free deque
+	g_free (deque);
+}
+
+//****************************************************************************//
+//      Rolling maximum                                                       //
+//****************************************************************************//
+void RollingMax (const gdouble series[], gsize size, gsize window, gdouble result[])
+{
+	// Check window size
+	if (!CheckWindow (size, window, result))
+		return;
+
+	// Create monotonic deque of bar indices with decreasing values
+	gsize *deque = g_new (gsize, window);
+	gsize head = 0;
+	gsize count = 0;
+
+	// Move window from the oldest bar to the latest one
+	for (gsize i = size; i--;)
+	{
+		// Remove bars which can not be window maximum any more
+		while (count && series[deque[(head + count - 1) % window]] <= series[i])
+			count--;
+
+		// Remove bar which left window
+		if (count && deque[head] >= i + window)
+		{
+			head = (head + 1) % window;
+			count--;
+		}
+
+		// Add new bar
+		deque[(head + count) % window] = i;
+		count++;
+
+		// Set maximum of full window
+		if (i + window <= size)
+			result[i] = series[deque[head]];
+	}
+
+	// Free deque
+	g_free (deque);
+}
+
+//****************************************************************************//
+//      Rolling median                                                        //
+//****************************************************************************//
+void RollingMedian (const gdouble series[], gsize size, gsize window, gdouble result[])
+{
+	// Check window size
+	if (!CheckWindow (size, window, result))
+		return;
+
+	// Create window values and heap positions of window slots
+	gdouble *values = g_new (gdouble, window);
+	gsize *pos = g_new (gsize, window);
+	gboolean *upper = g_new (gboolean, window);
+
+	// Fill first window and sort its slots by value
+	gsize *slots = g_new (gsize, window);
+	for (gsize i = 0; i < window; i++)
+	{
+		values[i] = series[size-1-i];
+		slots[i] = i;
+	}
+	g_qsort_with_data (slots, window, sizeof (gsize), CompareSlots, values);
+
+	// Lower half goes to max heap and upper half goes to min heap.
+	// Sorted arrays already have heap order, so no sifting is needed.
+	gsize lsize = (window + 1) / 2;
+	MedianHeap lower = {g_new (gsize, lsize), lsize, TRUE};
+	MedianHeap higher = {g_new (gsize, window - lsize), window - lsize, FALSE};
+	for (gsize i = 0; i < lsize; i++)
+	{
+		gsize slot = slots[lsize-1-i];
+		lower.slots[i] = slot;
+		pos[slot] = i;
+		upper[slot] = FALSE;
+	}
+	for (gsize i = 0; i < higher.size; i++)
+	{
+		gsize slot = slots[lsize+i];
+		higher.slots[i] = slot;
+		pos[slot] = i;
+		upper[slot] = TRUE;
+	}
+	g_free (slots);
+
+	// Move window from the oldest bar to the latest one
+	for (gsize i = size - window + 1; i--;)
+	{
+		// Replace the oldest value in window with new one
+		if (i + window < size)
+		{
+			gsize slot = (size - 1 - i) % window;
+			values[slot] = series[i];
+			MedianHeap *heap = upper[slot] ? &higher : &lower;
+			gsize index = pos[slot];
+			if (SiftUp (heap, values, pos, index) == index)
+				SiftDown (heap, values, pos, index);
+
+			// Exchange heap tops if lower half got greater value than upper half
+			if (higher.size && values[lower.slots[0]] > values[higher.slots[0]])
+			{
+				gsize lslot = lower.slots[0];
+				gsize hslot = higher.slots[0];
+				lower.slots[0] = hslot;
+				higher.slots[0] = lslot;
+				upper[hslot] = FALSE;
+				upper[lslot] = TRUE;
+				SiftDown (&lower, values, pos, 0);
+				SiftDown (&higher, values, pos, 0);
+			}
+		}
+
+		// Set median of window
+		if (window % 2)
+			result[i] = values[lower.slots[0]];
+		else
+			result[i] = 0.5 * (values[lower.slots[0]] + values[higher.slots[0]]);
+	}
+
+	// Free temporary buffers
+	g_free (lower.slots);
+	g_free (higher.slots);
+	g_free (upper);
+	g_free (pos);
+	g_free (values);
+}
+
+//****************************************************************************//
+//      Rolling correlation of two series                                     //
+//****************************************************************************//
+void Correlation (const gdouble x[], const gdouble y[], gsize size, gsize window, gdouble result[])
+{
+	// Check window size
+	if (!CheckWindow (size, window, result))
+		return;
+
+	// Sum values relative to the oldest values to keep precision
+	gdouble xbase = x[size-1];
+	gdouble ybase = y[size-1];
+
+	// Move window from the oldest bar to the latest one
+	gdouble sx = 0.0, sy = 0.0, sxx = 0.0, syy = 0.0, sxy = 0.0;
+	for (gsize i = size; i--;)
+	{
+		// Add new values to window
+		gdouble dx = x[i] - xbase;
+		gdouble dy = y[i] - ybase;
+		sx += dx;
+		sy += dy;
+		sxx += dx * dx;
+		syy += dy * dy;
+		sxy += dx * dy;
+
+		// Remove old values from window
+		if (i + window < size)
+		{
+			dx = x[i+window] - xbase;
+			dy = y[i+window] - ybase;
+			sx -= dx;
+			sy -= dy;
+			sxx -= dx * dx;
+			syy -= dy * dy;
+			sxy -= dx * dy;
+		}
+
+		// Set correlation of full window
+		if (i + window <= size)
+		{
+			gdouble cov = sxy - sx * sy / window;
+			gdouble xvar = sxx - sx * sx / window;
+			gdouble yvar = syy - sy * sy / window;
+			if (xvar > 0.0 && yvar > 0.0)
+				result[i] = cov / Math::Sqrt (xvar * yvar);
+			else
+				result[i] = M_NAN;
+		}
+	}
+}
+/*
+################################################################################
+#                                 END OF FILE                                  #
+################################################################################
+*/
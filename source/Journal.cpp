@@ -0,0 +1,246 @@
+/*                                                                   Journal.cpp
+################################################################################
+# Encoding: UTF-8                                                  Tab size: 4 #
+#                                                                              #
+#                                 JOURNAL CLASS                                #
+#                                                                              #
+# License: LGPLv3+                               Copyleft (Ɔ) 2014, Jack Black #
+################################################################################
+*/
+# include	<Common.h>
+# include	<Journal.h>
+# include	<glib/gstdio.h>
+# include	<errno.h>
+
+//****************************************************************************//
+//      Internal constants                                                    //
+//****************************************************************************//
+# define	JOURNAL_FIELDS		8			// Count of fields in journal line
+
+//****************************************************************************//
+//      Internal functions                                                    //
+//****************************************************************************//
+
+//============================================================================//
+//      Free journal entry                                                    //
+//============================================================================//
+static void FreeEntry (gpointer data)
+{
+	// Convert entry pointer
+	JournalEntry *entry = reinterpret_cast <JournalEntry*> (data);
+
+	// Free entry elements
+	g_free (entry -> message);
+	g_free (entry);
+}
+
+//****************************************************************************//
+//      Constructor                                                           //
+//****************************************************************************//
+Journal::Journal (void)
+{
+	// Set journal elements to default values
+	path = NULL;
+	session = 0;
+	entries = g_hash_table_new_full (g_str_hash, g_str_equal, g_free, FreeEntry);
+	pending = g_string_new (NULL);
+	queued = 0;
+}
+
+//****************************************************************************//
+//      Destructor                                                            //
+//****************************************************************************//
+Journal::~Journal (void)
+{
+	// Free journal elements
+	g_free (path);
+	g_hash_table_unref (entries);
+	g_string_free (pending, TRUE);
+
+	// Set journal elements to default values
+	path = NULL;
+	entries = NULL;
+	pending = NULL;
+	queued = 0;
+}
+
+//****************************************************************************//
+//      Add job entry                                                         //
+//****************************************************************************//
+void Journal::Insert (const gchar *ticker, guint state, guint attempts, gint count, time_t start, time_t end, const gchar *message)
+{
+	// Create new entry
+	JournalEntry *entry = g_new (JournalEntry, 1);
+	entry -> state = state;
+	entry -> attempts = attempts;
+	entry -> count = count;
+	entry -> start = start;
+	entry -> end = end;
+	entry -> message = g_strdup (message);
+
+	// Replace previous entry of ticker
+	g_hash_table_replace (entries, g_strdup (ticker), entry);
+}
+
+//****************************************************************************//
+//      Open journal of trading session                                       //
+//****************************************************************************//
+gboolean Journal::Open (const gchar *fname, time_t session, GError **error)
+{
+	// Set journal elements
+	g_free (path);
+	path = GetQuotesPath (fname, JOURNAL_FILE_NAME);
+	this -> session = session;
+	g_hash_table_remove_all (entries);
+	g_string_truncate (pending, 0);
+	queued = 0;
+
+	// Journal does not exist before first sync
+	gchar *content;
+	if (!g_file_get_contents (path, &content, NULL, NULL))
+		return TRUE;
+
+	// Process all journal lines
+	gboolean stale = FALSE;
+	GString *kept = g_string_new (NULL);
+	gchar **lines = g_strsplit (content, "\n", 0);
+	for (gchar **lptr = lines; *lptr; lptr++)
+	{
+		// Skip empty lines
+		if (**lptr == '\0')
+			continue;
+
+		// Split line into fields
+		gchar **fields = g_strsplit (*lptr, "\t", JOURNAL_FIELDS);
+
+		// Keep jobs of trading session only
+		if (g_strv_length (fields) == JOURNAL_FIELDS && g_ascii_strtoll (fields[0], NULL, 10) == session)
+		{
+			// Add job entry and its line
+			Insert (fields[1], g_ascii_strtoull (fields[2], NULL, 10), g_ascii_strtoull (fields[3], NULL, 10), g_ascii_strtoll (fields[4], NULL, 10), g_ascii_strtoll (fields[5], NULL, 10), g_ascii_strtoll (fields[6], NULL, 10), fields[7]);
+			g_string_append_printf (kept, "%s\n", *lptr);
+		}
+		else
+			stale = TRUE;
+
+		// Release array of fields
+		g_strfreev (fields);
+	}
+
+	// Release array of strings
+	g_strfreev (lines);
+	g_free (content);
+
+	// Drop lines of other sessions from journal file
+	gboolean status = TRUE;
+	if (stale)
+	{
+		// Journal of previous session is started anew
+		if (kept -> len == 0)
+		{
+			// Remove journal file
+			if (g_unlink (path) != 0)
+			{
+				// Set error message
+				g_set_error (error, G_FILE_ERROR, g_file_error_from_errno (errno), "Can not remove sync journal: %s", g_strerror (errno));
+
+				// Set fail status
+				status = FALSE;
+			}
+		}
+		else
+		{
+			// Rewrite journal file with lines of current session only
+			GError *fault = NULL;
+			if (!g_file_set_contents (path, kept -> str, kept -> len, &fault))
+			{
+				// Set error message
+				g_set_error (error, G_FILE_ERROR, fault -> code, "Can not rewrite sync journal: %s", fault -> message);
+				g_error_free (fault);
+
+				// Set fail status
+				status = FALSE;
+			}
+		}
+	}
+
+	// Release kept lines
+	g_string_free (kept, TRUE);
+
+	// Return operation status
+	return status;
+}
+
+//****************************************************************************//
+//      Write pending lines into journal file                                 //
+//****************************************************************************//
+gboolean Journal::Flush (GError **error)
+{
+	// Check if journal has pending lines
+	if (path == NULL || queued == 0)
+		return TRUE;
+
+	// Append pending lines to the end of journal file
+	FILE *stream = g_fopen (path, "a");
+	gboolean status = stream != NULL;
+	if (status)
+	{
+		status = fwrite (pending -> str, pending -> len, 1, stream) == 1;
+		status = (fclose (stream) == 0) && status;
+	}
+
+	// Check file operation status
+	if (!status)
+	{
+		// Set error message
+		g_set_error (error, G_FILE_ERROR, g_file_error_from_errno (errno), "Can not write sync journal: %s", g_strerror (errno));
+
+		// Return fail status
+		return FALSE;
+	}
+
+	// Clear pending lines
+	g_string_truncate (pending, 0);
+	queued = 0;
+
+	// Return success status
+	return TRUE;
+}
+
+//****************************************************************************//
+//      Add finished sync job                                                 //
+//****************************************************************************//
+void Journal::Add (const gchar *ticker, guint state, guint attempts, gint count, time_t start, time_t end, const gchar *message)
+{
+	// Count attempts of previous runs of the session
+	const JournalEntry *entry = Find (ticker);
+	if (entry)
+		attempts += entry -> attempts;
+
+	// Keep message on single line
+	gchar *text = g_strdup (message ? message : "");
+	g_strdelimit (text, "\t\r\n", ' ');
+
+	// Append job line
+	g_string_append_printf (pending, "%" G_GINT64_FORMAT "\t%s\t%u\t%u\t%i\t%" G_GINT64_FORMAT "\t%" G_GINT64_FORMAT "\t%s\n", static_cast <gint64> (session), ticker, state, attempts, count, static_cast <gint64> (start), static_cast <gint64> (end), text);
+	queued++;
+
+	// Update job entry
+	Insert (ticker, state, attempts, count, start, end, text);
+
+	// Free temporary string buffer
+	g_free (text);
+}
+
+//****************************************************************************//
+//      Find latest job entry of ticker                                       //
+//****************************************************************************//
+const JournalEntry* Journal::Find (const gchar *ticker) const
+{
+	return reinterpret_cast <const JournalEntry*> (g_hash_table_lookup (entries, ticker));
+}
+/*
+################################################################################
+#                                 END OF FILE                                  #
+################################################################################
+*/
@@ -0,0 +1,498 @@
+/*                                                             LocalProvider.cpp
+################################################################################
+# Encoding: UTF-8                                                  Tab size: 4 #
+#                                                                              #
+#                             LOCAL PROVIDER CLASS                             #
+#                                                                              #
+# License: LGPLv3+                               Copyleft (Ɔ) 2014, Jack Black #
+################################################################################
+*/
+# include	<QuoteList.h>
+# include	<LocalProvider.h>
+# include	<Numbers.h>
+# include	<Math.h>
+
+//****************************************************************************//
+//      Internal constants                                                    //
+//****************************************************************************//
+# define	BULK_FIELDS		8		// Count of fields in bulk quotes file
+
+//****************************************************************************//
+//      Quote route structure                                                 //
+//****************************************************************************//
+struct QuoteRoute
+{
+	Accumulator	*quotes;		// Quotes of ticker
+	GError		*error;			// First error found in quotes of ticker
+};
+
+//****************************************************************************//
+//      Internal functions                                                    //
+//****************************************************************************//
+
+//============================================================================//
+//      Free quote route                                                      //
+//============================================================================//
+static void FreeRoute (gpointer data)
+{
+	// Convert data pointer
+	QuoteRoute *route = reinterpret_cast <QuoteRoute*> (data);
+
+	// Free route elements
+	delete route -> quotes;
+	if (route -> error)
+		g_error_free (route -> error);
+
+	// Free route structure
+	g_free (route);
+}
+
+//============================================================================//
+//      Extract quote from bulk quotes file fields                            //
+//============================================================================//
+static gboolean ExtractBulkQuote (gchar *fields[], gsize count, quote_t *quote, GError **error)
+{
+	// Check count of fields
+	if (count < BULK_FIELDS - 1)
+	{
+		// Set error message
+		g_set_error (error, G_FILE_ERROR, G_FILE_ERROR_IO, "Missing quote fields");
+		return FALSE;
+	}
+
+	// Extract date from string
+	quote -> date = ExtractDate (fields[1], error);
+	if (quote -> date == static_cast <time_t> (TIME_ERROR))
+		return FALSE;
+
+	// Extract prices from string
+	quote -> open = ExtractPrice (fields[2], "open", error);
+	if (Math::IsNaN (quote -> open))
+		return FALSE;
+	quote -> high = ExtractPrice (fields[3], "high", error);
+	if (Math::IsNaN (quote -> high))
+		return FALSE;
+	quote -> low = ExtractPrice (fields[4], "low", error);
+	if (Math::IsNaN (quote -> low))
+		return FALSE;
+	quote -> close = ExtractPrice (fields[5], "close", error);
+	if (Math::IsNaN (quote -> close))
+		return FALSE;
+
+	// Extract volume from string
+	quote -> volume = ExtractVolume (fields[6], error);
+	if (quote -> volume == static_cast <gsize> (-1))
+		return FALSE;
+
+	// Extract adjusted close price from string or use close price instead
+	if (count > BULK_FIELDS - 1)
+	{
+		quote -> adjclose = ExtractPrice (fields[7], "adjclose", error);
+		if (Math::IsNaN (quote -> adjclose))
+			return FALSE;
+	}
+	else
+		quote -> adjclose = quote -> close;
+
+	// Return success state
+	return TRUE;
+}
+
+//============================================================================//
+//      Extract split date in YYYYMMDD format                                 //
+//============================================================================//
+static time_t ExtractSplitDate (const gchar *string)
+{
+	// Extract date number
+	sint32_t number;
+	gsize len = Numbers::DecToNum (&number, string);
+	if (len != 8 || string[len] != '\0')
+		return TIME_ERROR;
+
+	// Convert date number into time stamp
+	return MakeDate (number / 10000, number / 100 % 100, number % 100);
+}
+
+//****************************************************************************//
+//      Constructor                                                           //
+//****************************************************************************//
+LocalProvider::LocalProvider (void)
+{
+	// Set provider elements to default values
+	path = NULL;
+	files = NULL;
+	routes = NULL;
+}
+
+//****************************************************************************//
+//      Destructor                                                            //
+//****************************************************************************//
+LocalProvider::~LocalProvider (void)
+{
+	// Free provider elements
+	g_free (path);
+	if (files)
+		g_hash_table_destroy (files);
+	if (routes)
+		g_hash_table_destroy (routes);
+
+	// Set provider elements to default values
+	path = NULL;
+	files = NULL;
+	routes = NULL;
+}
+
+//****************************************************************************//
+//      Read bulk quotes file and route its quotes by ticker                  //
+//****************************************************************************//
+gboolean LocalProvider::RouteQuotes (const gchar* const tickers[], gsize count, GError **error)
+{
+	// Open bulk quotes file
+	GIOChannel *channel = g_io_channel_new_file (path, "r", error);
+	if (channel == NULL)
+		return FALSE;
+
+	// Read file as raw bytes through large buffer
+	g_io_channel_set_encoding (channel, NULL, NULL);
+	g_io_channel_set_buffer_size (channel, LOCAL_BUFFER_SIZE);
+
+	// Create routes for requested tickers
+	routes = g_hash_table_new_full (g_str_hash, g_str_equal, g_free, FreeRoute);
+	for (gsize i = 0; i < count; i++)
+	{
+		// Create empty route
+		QuoteRoute *route = g_new (QuoteRoute, 1);
+		route -> quotes = new Accumulator (0);
+		route -> error = NULL;
+
+		// Add route for ticker
+		g_hash_table_replace (routes, g_strdup (tickers[i]), route);
+	}
+
+	// Create line buffer which is reused for all file lines
+	GString *string = g_string_new (NULL);
+
+	// Process all file lines in single pass
+	GIOStatus status;
+	gint line = 0;
+	while ((status = g_io_channel_read_line_string (channel, string, NULL, error)) == G_IO_STATUS_NORMAL)
+	{
+		// Go to next file line
+		line++;
+
+		// Split line into fields in place
+		gchar *fields [BULK_FIELDS];
+		gsize size = 0;
+		gchar *pos = string -> str;
+		fields[size++] = pos;
+		while (*pos != '\0' && *pos != '\n' && *pos != '\r')
+		{
+			// Check for field separator
+			if (*pos == ',' || *pos == '\t')
+			{
+				// Set end of field marker
+				*pos = '\0';
+
+				// Set start of next field
+				if (size < BULK_FIELDS)
+					fields[size++] = pos + 1;
+			}
+
+			// Go to next symbol
+			pos++;
+		}
+
+		// Set end of line marker
+		*pos = '\0';
+
+		// Skip file header
+		if (line == 1 && size > 1 && !g_ascii_isdigit (fields[1][0]))
+			continue;
+
+		// Find route for ticker and skip not requested tickers
+		QuoteRoute *route = reinterpret_cast <QuoteRoute*> (g_hash_table_lookup (routes, fields[0]));
+		if (route == NULL || route -> error)
+			continue;
+
+		// Reserve space into accumulator
+		quote_t *quote = reinterpret_cast <quote_t*> (route -> quotes -> Reserve (sizeof (quote_t)));
+		if (quote == NULL)
+		{
+			// Set error message
+			g_set_error (&route -> error, G_FILE_ERROR, G_FILE_ERROR_IO, "Can not reserve more space for quotes buffer");
+			continue;
+		}
+
+		// Extract quote from line fields
+		if (!ExtractBulkQuote (fields, size, quote, &route -> error))
+		{
+			// Set error message prefix
+			g_prefix_error (&route -> error, "Line %i: ", line);
+			continue;
+		}
+
+		// Mark allocated accumulator space as filled by data
+		route -> quotes -> Fill (sizeof (quote_t));
+	}
+
+	// Relase line buffer
+	g_string_free (string, TRUE);
+
+	// Close bulk quotes file
+	g_io_channel_unref (channel);
+
+	// Return file operation status
+	return status == G_IO_STATUS_EOF;
+}
+
+//****************************************************************************//
+//      Get file name of ticker file                                          //
+//****************************************************************************//
+gchar* LocalProvider::GetFileName (const gchar *ticker, const gchar *ext) const
+{
+	// Create file name
+	gchar *name = g_strconcat (ticker, ext, NULL);
+
+	// Check if file is present in quotes directory
+	gchar *fname = NULL;
+	if (files == NULL || g_hash_table_contains (files, name))
+		fname = g_build_filename (path, name, NULL);
+
+	// Free temporary string buffer
+	g_free (name);
+
+	// Return full file name
+	return fname;
+}
+
+//****************************************************************************//
+//      Set quotes directory or bulk quotes file                              //
+//****************************************************************************//
+void LocalProvider::SetPath (const gchar *name)
+{
+	// Free old quotes path
+	g_free (path);
+
+	// Set new quotes path
+	path = g_strdup (name);
+}
+
+//****************************************************************************//
+//      Provider initialization                                               //
+//****************************************************************************//
+gboolean LocalProvider::Init (GError **error)
+{
+	// Free quote elements
+	g_free (array);
+
+	// Set quote elements to default values
+	array = NULL;
+	size = 0;
+
+	// Check quotes directory or bulk quotes file
+	if (path == NULL || !g_file_test (path, static_cast <GFileTest> (G_FILE_TEST_IS_DIR | G_FILE_TEST_IS_REGULAR)))
+	{
+		// Set error message
+		g_set_error (error, G_FILE_ERROR, G_FILE_ERROR_NOENT, "Quotes path '%s' not found", path ? path : "");
+
+		// Return fail status
+		return FALSE;
+	}
+
+	// Return success state
+	return TRUE;
+}
+
+//****************************************************************************//
+//      Begin batch of requests                                               //
+//****************************************************************************//
+gboolean LocalProvider::Begin (const gchar* const tickers[], gsize count, GError **error)
+{
+	// Release routes of previous batch
+	if (routes)
+		g_hash_table_destroy (routes);
+	routes = NULL;
+
+	// Route quotes of bulk quotes file by ticker
+	if (g_file_test (path, G_FILE_TEST_IS_REGULAR))
+		return RouteQuotes (tickers, count, error);
+
+	// Open quotes directory
+	GDir *dir = g_dir_open (path, 0, error);
+	if (dir == NULL)
+		return FALSE;
+
+	// Create new file set
+	if (files)
+		g_hash_table_destroy (files);
+	files = g_hash_table_new_full (g_str_hash, g_str_equal, g_free, NULL);
+
+	// Read directory once instead of probing files for every ticker
+	const gchar *name;
+	while ((name = g_dir_read_name (dir)))
+		g_hash_table_add (files, g_strdup (name));
+
+	// Close quotes directory
+	g_dir_close (dir);
+
+	// Return success state
+	return TRUE;
+}
+
+//****************************************************************************//
+//      End batch of requests                                                 //
+//****************************************************************************//
+gboolean LocalProvider::End (GError **error)
+{
+	// Release file set and routes
+	if (files)
+		g_hash_table_destroy (files);
+	if (routes)
+		g_hash_table_destroy (routes);
+
+	// Set file set and routes to default values
+	files = NULL;
+	routes = NULL;
+
+	// Return success state
+	return TRUE;
+}
+
+//****************************************************************************//
+//      Check for quote splits                                                //
+//****************************************************************************//
+gboolean LocalProvider::CheckSplits (const gchar *ticker, time_t start, time_t end, GError **error)
+{
+	// Bulk quotes file has no splits records
+	if (routes)
+		return FALSE;
+
+	// Get splits file name
+	gchar *fname = GetFileName (ticker, LOCAL_SPLITS_EXT);
+
+	// Check if stock has splits file
+	if (fname == NULL || !g_file_test (fname, G_FILE_TEST_IS_REGULAR))
+	{
+		// Free temporary string buffer
+		g_free (fname);
+
+		// Stock has no splits
+		return FALSE;
+	}
+
+	// Try to read splits file
+	gchar *contents;
+	gboolean status = g_file_get_contents (fname, &contents, NULL, error);
+	if (status)
+	{
+		// Set default status
+		status = FALSE;
+
+		// Split buffer into lines
+		gchar **lines = g_strsplit_set (contents, "\n", 0);
+
+		// Process all file lines
+		for (gchar **lptr = lines; *lptr && !status; lptr++)
+		{
+			// Split string into tokens
+			gchar **tokens = g_strsplit_set (*lptr, ",", 0);
+
+			// Check if line has split or dividend record
+			if (g_strv_length (tokens) > 1)
+			{
+				// Get record type and date
+				const gchar *type = g_strstrip (tokens[0]);
+				time_t date = ExtractSplitDate (g_strstrip (tokens[1]));
+
+				// Check if record is from requested date range
+				if ((g_strcmp0 (type, "DIVIDEND") == 0 || g_strcmp0 (type, "SPLIT") == 0) && date != static_cast <time_t> (TIME_ERROR) && date >= start && date <= end)
+					status = TRUE;
+			}
+
+			// Release array of tokens
+			g_strfreev (tokens);
+		}
+
+		// Release array of strings
+		g_strfreev (lines);
+
+		// Free temporary string buffer
+		g_free (contents);
+	}
+
+	// Free temporary string buffer
+	g_free (fname);
+
+	// Return file operation status
+	return status;
+}
+
+//****************************************************************************//
+//      Read quotes from quotes directory                                     //
+//****************************************************************************//
+gboolean LocalProvider::GetQuotes (const gchar *ticker, time_t start, time_t end, GError **error)
+{
+	// Check if quotes were routed from bulk quotes file
+	if (routes)
+	{
+		// Find route for ticker
+		QuoteRoute *route = reinterpret_cast <QuoteRoute*> (g_hash_table_lookup (routes, ticker));
+		if (route == NULL)
+		{
+			// Set error message
+			g_set_error (error, G_FILE_ERROR, G_FILE_ERROR_NOENT, "Ticker %s was not requested from bulk quotes file", ticker);
+
+			// Return fail status
+			return FALSE;
+		}
+
+		// Check if quotes of ticker have errors
+		gboolean status = FALSE;
+		if (route -> error)
+			g_propagate_error (error, g_error_copy (route -> error));
+		else
+		{
+			// Check quotes and keep quotes from date range
+			status = SetQuotes (reinterpret_cast <const quote_t*> (route -> quotes -> Data ()), route -> quotes -> Size () / sizeof (quote_t), start, end, error);
+		}
+
+		// Route is kept till end of batch for duplicate tickers and retries
+
+		// Return file operation status
+		return status;
+	}
+
+	// Get quotes file name
+	gchar *fname = GetFileName (ticker, LOCAL_QUOTES_EXT);
+	if (fname == NULL)
+	{
+		// Set error message
+		g_set_error (error, G_FILE_ERROR, G_FILE_ERROR_NOENT, "Quotes file '%s%s' not found", ticker, LOCAL_QUOTES_EXT);
+
+		// Return fail status
+		return FALSE;
+	}
+
+	// Try to read quotes file
+	gchar *contents;
+	gboolean status = g_file_get_contents (fname, &contents, NULL, error);
+	if (status)
+	{
+		// Extract quotes from file content
+		status = ParseQuotes (contents, start, end, error);
+
+		// Free temporary string buffer
+		g_free (contents);
+	}
+
+	// Free temporary string buffer
+	g_free (fname);
+
+	// Return file operation status
+	return status;
+}
+/*
+################################################################################
+#                                 END OF FILE                                  #
+################################################################################
+*/
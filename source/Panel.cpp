@@ -0,0 +1,745 @@
+/*                                                                     Panel.cpp
+################################################################################
+# Encoding: UTF-8                                                  Tab size: 4 #
+#                                                                              #
+#                                 PANEL CLASS                                  #
+#                                                                              #
+# License: LGPLv3+                               Copyleft (Ɔ) 2014, Jack Black #
+################################################################################
+*/
+# include	<Common.h>
+# include	<Panel.h>
+# include	<Math.h>
+# include	<glib/gstdio.h>
+# include	<string.h>
+# include	<errno.h>
+
+//****************************************************************************//
+//      Panel quote structure                                                 //
+//****************************************************************************//
+struct PanelQuote
+{
+	gint64		date;			// Quote date
+	gfloat		values [PANEL_FIELDS];	// Quote fields
+};
+
+//****************************************************************************//
+//      Panel patch structure                                                 //
+//****************************************************************************//
+struct PanelPatch
+{
+	guint		row;			// Stored row index
+	guint		column;			// Ticker column
+	gfloat		values [PANEL_FIELDS];	// Quote fields
+};
+
+//****************************************************************************//
+//      Internal functions                                                    //
+//****************************************************************************//
+
+//============================================================================//
+//      Compare dates                                                         //
+//============================================================================//
+static gint CompareDates (gconstpointer a, gconstpointer b)
+{
+	// Convert date pointers
+	gint64 date1 = *reinterpret_cast <const gint64*> (a);
+	gint64 date2 = *reinterpret_cast <const gint64*> (b);
+
+	// Compare dates
+	return (date1 > date2) - (date1 < date2);
+}
+
+//============================================================================//
+//      Compare values                                                        //
+//============================================================================//
+static gint CompareValues (gconstpointer a, gconstpointer b, gpointer data)
+{
+	// Convert value pointers
+	gdouble value1 = *reinterpret_cast <const gdouble*> (a);
+	gdouble value2 = *reinterpret_cast <const gdouble*> (b);
+
+	// Compare values
+	return (value1 > value2) - (value1 < value2);
+}
+
+//============================================================================//
+//      Find date index in sorted dates array                                 //
+//============================================================================//
+static gint FindDate (const gint64 dates[], guint size, gint64 date)
+{
+	// Binary search of date
+	guint low = 0;
+	guint high = size;
+	while (low < high)
+	{
+		guint middle = (low + high) / 2;
+		if (dates[middle] < date)
+			low = middle + 1;
+		else
+			high = middle;
+	}
+
+	// Return date index or -1 if date was not found
+	return (low < size && dates[low] == date) ? static_cast <gint> (low) : -1;
+}
+
+//============================================================================//
+//      Count sorted values which are less than value                         //
+//============================================================================//
+static gsize CountLess (const gdouble array[], gsize size, gdouble value, gboolean equal)
+{
+	// Binary search of value bound
+	gsize low = 0;
+	gsize high = size;
+	while (low < high)
+	{
+		gsize middle = (low + high) / 2;
+		if (array[middle] < value || (equal && array[middle] == value))
+			low = middle + 1;
+		else
+			high = middle;
+	}
+
+	// Return count of values
+	return low;
+}
+
+//============================================================================//
+//      Convert quote to panel fields                                         //
+//============================================================================//
+static void GetFields (const quote_t *quote, gfloat values[])
+{
+	values[PANEL_CLOSE] = quote -> close;
+	values[PANEL_VOLUME] = quote -> volume;
+	values[PANEL_RANGE] = Math::Log (quote -> high / quote -> low);
+}
+
+//============================================================================//
+//      Free panel quotes array                                               //
+//============================================================================//
+static void FreeQuotes (gpointer data)
+{
+	g_array_free (reinterpret_cast <GArray*> (data), TRUE);
+}
+
+//****************************************************************************//
+//      Constructor                                                           //
+//****************************************************************************//
+Panel::Panel (void)
+{
+	// Set panel elements to default values
+	file = NULL;
+	memset (&header, 0, sizeof (header));
+	names = NULL;
+	rows = NULL;
+	rsize = 0;
+	columns = g_hash_table_new (g_str_hash, g_str_equal);
+	pending = g_hash_table_new_full (g_int64_hash, g_int64_equal, NULL, g_free);
+	patches = g_array_new (FALSE, FALSE, sizeof (PanelPatch));
+}
+
+//****************************************************************************//
+//      Destructor                                                            //
+//****************************************************************************//
+Panel::~Panel (void)
+{
+	// Close panel file
+	Close ();
+
+	// Free panel elements
+	g_hash_table_destroy (columns);
+	g_hash_table_destroy (pending);
+	g_array_free (patches, TRUE);
+
+	// Set panel elements to default values
+	columns = NULL;
+	pending = NULL;
+	patches = NULL;
+}
+
+//****************************************************************************//
+//      Close panel file                                                      //
+//****************************************************************************//
+void Panel::Close (void)
+{
+	// Free panel elements
+	g_hash_table_remove_all (columns);
+	g_array_set_size (patches, 0);
+	if (file)
+		g_mapped_file_unref (file);
+
+	// Set panel elements to default values
+	file = NULL;
+	memset (&header, 0, sizeof (header));
+	names = NULL;
+	rows = NULL;
+	rsize = 0;
+}
+
+//****************************************************************************//
+//      Open panel file                                                       //
+//****************************************************************************//
+gboolean Panel::Open (const gchar *fname, GError **error)
+{
+	// Close previous panel file
+	Close ();
+
+	// Try to map panel file into memory
+	gchar *path = GetQuotesPath (fname, PANEL_FILE_NAME);
+	file = g_mapped_file_new (path, FALSE, error);
+	g_free (path);
+	if (file == NULL)
+		return FALSE;
+
+	// Get panel content
+	const gchar *data = g_mapped_file_get_contents (file);
+	gsize length = g_mapped_file_get_length (file);
+
+	// Check panel header
+	gboolean status = FALSE;
+	if (length >= sizeof (PanelHeader))
+	{
+		// Copy panel header
+		memcpy (&header, data, sizeof (PanelHeader));
+
+		// Check panel signature and size
+		if (memcmp (header.magic, PANEL_MAGIC, sizeof (header.magic)) == 0 && header.fields == PANEL_FIELDS)
+		{
+			rsize = sizeof (gint64) + static_cast <gsize> (header.fields) * header.tickers * sizeof (gfloat);
+			gsize tsize = static_cast <gsize> (header.tickers) * PANEL_TICKER_SIZE;
+			if (length >= sizeof (PanelHeader) + tsize + header.dates * rsize)
+			{
+				names = data + sizeof (PanelHeader);
+				rows = names + tsize;
+				status = TRUE;
+			}
+		}
+	}
+
+	// Check if panel is valid
+	if (!status)
+	{
+		// Close panel file
+		Close ();
+
+		// Set error message
+		g_set_error (error, G_FILE_ERROR, G_FILE_ERROR_IO, "Panel file is corrupted");
+
+		// Return fail status
+		return FALSE;
+	}
+
+	// Create ticker index
+	for (guint32 i = 0; i < header.tickers; i++)
+	{
+		const gchar *name = names + i * PANEL_TICKER_SIZE;
+		if (name [PANEL_TICKER_SIZE - 1] == '\0')
+			g_hash_table_insert (columns, const_cast <gchar*> (name), GUINT_TO_POINTER (i + 1));
+	}
+
+	// Return success state
+	return TRUE;
+}
+
+//****************************************************************************//
+//      Build panel from quote files of all stocks                            //
+//****************************************************************************//
+gboolean Panel::Build (const gchar *fname, const gchar* const tickers[], gsize count, GError **error)
+{
+	// Close previous panel file
+	Close ();
+
+	// Create ticker table and ticker quotes
+	GString *table = g_string_new (NULL);
+	GPtrArray *quotes = g_ptr_array_new_with_free_func (FreeQuotes);
+	GArray *dates = g_array_new (FALSE, FALSE, sizeof (gint64));
+
+	// Collect recent quotes of all stocks
+	for (gsize t = 0; t < count; t++)
+	{
+		// Skip tickers which do not fit into ticker table
+		const gchar *ticker = tickers[t];
+		if (strlen (ticker) >= PANEL_TICKER_SIZE)
+			continue;
+
+		// Add ticker to ticker table
+		gchar name [PANEL_TICKER_SIZE] = {0};
+		strcpy (name, ticker);
+		g_string_append_len (table, name, PANEL_TICKER_SIZE);
+
+		// Create ticker quotes
+		GArray *array = g_array_new (FALSE, FALSE, sizeof (PanelQuote));
+		g_ptr_array_add (quotes, array);
+
+		// Try to open quotes of ticker
+		gchar *path = GetQuotesFile (fname, ticker);
+		Quotes list;
+		if (list.OpenList (path, NULL))
+		{
+			// Keep recent quotes only
+			QuoteList qlist = list.GetQuoteList ();
+			gsize size = MIN (qlist.size, static_cast <gsize> (PANEL_DEPTH));
+			for (gsize i = 0; i < size; i++)
+			{
+				PanelQuote quote;
+				quote.date = qlist.array[i].date;
+				GetFields (&qlist.array[i], quote.values);
+				g_array_append_val (array, quote);
+				g_array_append_val (dates, quote.date);
+			}
+		}
+		g_free (path);
+	}
+
+	// Sort dates and remove duplicates
+	g_array_sort (dates, CompareDates);
+	guint unique = 0;
+	for (guint i = 0; i < dates -> len; i++)
+		if (unique == 0 || g_array_index (dates, gint64, unique - 1) != g_array_index (dates, gint64, i))
+			g_array_index (dates, gint64, unique++) = g_array_index (dates, gint64, i);
+
+	// Keep recent dates only
+	guint first = unique > PANEL_DEPTH ? unique - PANEL_DEPTH : 0;
+	const gint64 *darray = &g_array_index (dates, gint64, first);
+	guint dsize = unique - first;
+
+	// Create panel header
+	PanelHeader head;
+	memcpy (head.magic, PANEL_MAGIC, sizeof (head.magic));
+	head.tickers = quotes -> len;
+	head.dates = dsize;
+	head.fields = PANEL_FIELDS;
+	head.reserved = 0;
+
+	// Create panel matrix with missing values
+	gsize width = static_cast <gsize> (PANEL_FIELDS) * head.tickers;
+	gfloat *matrix = g_new (gfloat, dsize * width + 1);
+	for (gsize i = 0; i < dsize * width; i++)
+		matrix[i] = M_NAN;
+
+	// Place ticker quotes into matrix
+	for (guint t = 0; t < quotes -> len; t++)
+	{
+		GArray *array = reinterpret_cast <GArray*> (g_ptr_array_index (quotes, t));
+		for (guint i = 0; i < array -> len; i++)
+		{
+			const PanelQuote *quote = &g_array_index (array, PanelQuote, i);
+			gint index = FindDate (darray, dsize, quote -> date);
+			if (index >= 0)
+				for (guint f = 0; f < PANEL_FIELDS; f++)
+					matrix [index * width + f * head.tickers + t] = quote -> values[f];
+		}
+	}
+
+	// Create panel content
+	GString *string = g_string_new (NULL);
+	g_string_append_len (string, reinterpret_cast <const gchar*> (&head), sizeof (PanelHeader));
+	g_string_append_len (string, table -> str, table -> len);
+	for (guint i = 0; i < dsize; i++)
+	{
+		g_string_append_len (string, reinterpret_cast <const gchar*> (&darray[i]), sizeof (gint64));
+		g_string_append_len (string, reinterpret_cast <const gchar*> (matrix + i * width), width * sizeof (gfloat));
+	}
+
+	// Free temporary buffers
+	g_free (matrix);
+	g_array_free (dates, TRUE);
+	g_ptr_array_free (quotes, TRUE);
+	g_string_free (table, TRUE);
+
+	// Try to save panel content into file
+	gchar *path = GetQuotesPath (fname, PANEL_FILE_NAME);
+	gboolean status = g_file_set_contents (path, string -> str, string -> len, error);
+	g_free (path);
+
+	// Relase string buffer
+	g_string_free (string, TRUE);
+
+	// Open new panel file
+	return status && Open (fname, error);
+}
+
+//****************************************************************************//
+//      Find stored row of date                                               //
+//****************************************************************************//
+gint Panel::FindRow (gint64 date) const
+{
+	// Binary search of date in stored rows
+	guint low = 0;
+	guint high = header.dates;
+	while (low < high)
+	{
+		guint middle = (low + high) / 2;
+		gint64 value;
+		memcpy (&value, rows + middle * rsize, sizeof (gint64));
+		if (value < date)
+			low = middle + 1;
+		else
+			high = middle;
+	}
+
+	// Return row index or -1 if date was not found
+	gint64 value = 0;
+	if (low < header.dates)
+		memcpy (&value, rows + low * rsize, sizeof (gint64));
+	return (low < header.dates && value == date) ? static_cast <gint> (low) : -1;
+}
+
+//****************************************************************************//
+//      Get stored cell value                                                 //
+//****************************************************************************//
+gfloat Panel::GetCell (guint row, guint field, guint column) const
+{
+	// Read cell of stored row
+	gfloat value;
+	memcpy (&value, rows + row * rsize + sizeof (gint64) + (static_cast <gsize> (field) * header.tickers + column) * sizeof (gfloat), sizeof (gfloat));
+	return value;
+}
+
+//****************************************************************************//
+//      Add new quotes of ticker to pending date rows                         //
+//****************************************************************************//
+void Panel::AddQuotes (const gchar *ticker, QuoteList quotes, gboolean reset)
+{
+	// Check if ticker is in panel
+	gint column = FindTicker (ticker);
+	if (column < 0)
+		return;
+
+	// Clear whole ticker column if quote history was reset by split
+	// adjustment, so stored unadjusted prices are not mixed with new ones
+	if (reset)
+	{
+		for (guint row = 0; row < header.dates; row++)
+		{
+			PanelPatch patch;
+			patch.row = row;
+			patch.column = column;
+			for (guint f = 0; f < PANEL_FIELDS; f++)
+				patch.values[f] = M_NAN;
+			g_array_append_val (patches, patch);
+		}
+	}
+
+	// Get first and last panel dates
+	time_t last = GetLastDate ();
+	gint64 first = 0;
+	if (header.dates)
+		memcpy (&first, rows, sizeof (gint64));
+
+	// Add quotes from latest one down to first panel date
+	for (gsize i = 0; i < quotes.size && (header.dates == 0 || quotes.array[i].date >= first); i++)
+	{
+		// Get quote fields
+		gint64 date = quotes.array[i].date;
+		gfloat fields [PANEL_FIELDS];
+		GetFields (&quotes.array[i], fields);
+
+		// Check if quote date is already stored in panel
+		if (last != static_cast <time_t> (TIME_ERROR) && date <= last)
+		{
+			// Fill missing cell of stored row left by partial sync, or
+			// replace cell of reset column (patches are applied in order)
+			gint row = FindRow (date);
+			if (row >= 0 && (reset || Math::IsNaN (GetCell (row, PANEL_CLOSE, column))))
+			{
+				PanelPatch patch;
+				patch.row = row;
+				patch.column = column;
+				memcpy (patch.values, fields, sizeof (patch.values));
+				g_array_append_val (patches, patch);
+			}
+			continue;
+		}
+
+		// Find pending row of quote date
+		gchar *row = reinterpret_cast <gchar*> (g_hash_table_lookup (pending, &date));
+		if (row == NULL)
+		{
+			// Create new row with missing values
+			row = reinterpret_cast <gchar*> (g_malloc (rsize));
+			memcpy (row, &date, sizeof (gint64));
+			gfloat *values = reinterpret_cast <gfloat*> (row + sizeof (gint64));
+			for (gsize j = 0; j < static_cast <gsize> (header.fields) * header.tickers; j++)
+				values[j] = M_NAN;
+
+			// Date key is stored in row itself
+			g_hash_table_insert (pending, row, row);
+		}
+
+		// Set quote fields
+		gfloat *values = reinterpret_cast <gfloat*> (row + sizeof (gint64));
+		for (guint f = 0; f < PANEL_FIELDS; f++)
+			values [f * header.tickers + column] = fields[f];
+	}
+}
+
+//****************************************************************************//
+//      Write pending rows and cells to panel file                            //
+//****************************************************************************//
+gboolean Panel::Flush (const gchar *fname, GError **error)
+{
+	// Check if panel has new rows or cells
+	if (file == NULL || (g_hash_table_size (pending) == 0 && patches -> len == 0))
+		return TRUE;
+
+	// Sort new rows by date
+	GList *keys = g_hash_table_get_keys (pending);
+	keys = g_list_sort (keys, CompareDates);
+
+	// Get panel layout
+	PanelHeader head = header;
+	gsize tsize = static_cast <gsize> (head.tickers) * PANEL_TICKER_SIZE;
+	gsize offset = sizeof (PanelHeader) + tsize;
+	guint total = head.dates + g_hash_table_size (pending);
+
+	// Try to write panel file
+	gchar *path = GetQuotesPath (fname, PANEL_FILE_NAME);
+	gboolean status;
+	if (total > PANEL_DEPTH)
+	{
+		// Drop oldest rows to keep panel depth
+		guint drop = total - PANEL_DEPTH;
+		guint keep = drop < head.dates ? head.dates - drop : 0;
+		guint skip = drop > head.dates ? drop - head.dates : 0;
+
+		// Copy header, ticker table and kept stored rows
+		head.dates = PANEL_DEPTH;
+		GString *string = g_string_new (NULL);
+		g_string_append_len (string, reinterpret_cast <const gchar*> (&head), sizeof (PanelHeader));
+		g_string_append_len (string, names, tsize);
+		g_string_append_len (string, rows + (header.dates - keep) * rsize, keep * rsize);
+
+		// Fill missing cells of kept rows
+		for (guint i = 0; i < patches -> len; i++)
+		{
+			const PanelPatch *patch = &g_array_index (patches, PanelPatch, i);
+			if (patch -> row >= header.dates - keep)
+			{
+				gchar *row = string -> str + offset + (patch -> row - (header.dates - keep)) * rsize + sizeof (gint64);
+				for (guint f = 0; f < PANEL_FIELDS; f++)
+					memcpy (row + (static_cast <gsize> (f) * head.tickers + patch -> column) * sizeof (gfloat), &patch -> values[f], sizeof (gfloat));
+			}
+		}
+
+		// Append new rows
+		guint index = 0;
+		for (GList *item = keys; item; item = item -> next, index++)
+			if (index >= skip)
+				g_string_append_len (string, reinterpret_cast <const gchar*> (item -> data), rsize);
+
+		// Replace panel file (mapped file is released first)
+		Close ();
+		status = g_file_set_contents (path, string -> str, string -> len, error);
+		g_string_free (string, TRUE);
+
+		// Check file operation status
+		if (!status)
+		{
+			// Free temporary buffers
+			g_free (path);
+			g_list_free (keys);
+
+			// Return fail status
+			return FALSE;
+		}
+	}
+	else
+	{
+		// Try to open panel file for writing
+		FILE *stream = g_fopen (path, "r+b");
+		status = stream != NULL;
+		if (status)
+		{
+			// Fill missing cells of stored rows in place
+			for (guint i = 0; i < patches -> len && status; i++)
+			{
+				const PanelPatch *patch = &g_array_index (patches, PanelPatch, i);
+				for (guint f = 0; f < PANEL_FIELDS && status; f++)
+				{
+					gsize cell = offset + patch -> row * rsize + sizeof (gint64) + (static_cast <gsize> (f) * head.tickers + patch -> column) * sizeof (gfloat);
+					status = fseek (stream, cell, SEEK_SET) == 0 && fwrite (&patch -> values[f], sizeof (gfloat), 1, stream) == 1;
+				}
+			}
+
+			// Write new rows right after rows listed in header
+			status = status && fseek (stream, offset + head.dates * rsize, SEEK_SET) == 0;
+			for (GList *item = keys; item && status; item = item -> next)
+			{
+				status = fwrite (item -> data, rsize, 1, stream) == 1;
+				head.dates++;
+			}
+
+			// Update dates count in header after rows are written
+			status = status && fflush (stream) == 0 && fseek (stream, 0, SEEK_SET) == 0 && fwrite (&head, sizeof (PanelHeader), 1, stream) == 1;
+			status = (fclose (stream) == 0) && status;
+		}
+	}
+	g_free (path);
+
+	// Free list of keys
+	g_list_free (keys);
+
+	// Check file operation status
+	if (!status)
+	{
+		// Set error message
+		g_set_error (error, G_FILE_ERROR, g_file_error_from_errno (errno), "Can not extend panel file: %s", g_strerror (errno));
+
+		// Return fail status
+		return FALSE;
+	}
+
+	// Remove written rows and cells
+	g_hash_table_remove_all (pending);
+	g_array_set_size (patches, 0);
+
+	// Reopen extended panel file
+	return Open (fname, error);
+}
+
+//****************************************************************************//
+//      Find ticker column                                                    //
+//****************************************************************************//
+gint Panel::FindTicker (const gchar *ticker) const
+{
+	return static_cast <gint> (GPOINTER_TO_UINT (g_hash_table_lookup (columns, ticker))) - 1;
+}
+
+//****************************************************************************//
+//      Check if panel has the same ticker set as stock list                  //
+//****************************************************************************//
+gboolean Panel::HasTickers (const gchar* const tickers[], gsize count) const
+{
+	// Every ticker which fits into ticker table must have its column
+	guint fitting = 0;
+	for (gsize i = 0; i < count; i++)
+	{
+		if (strlen (tickers[i]) < PANEL_TICKER_SIZE)
+		{
+			if (FindTicker (tickers[i]) < 0)
+				return FALSE;
+			fitting++;
+		}
+	}
+
+	// Panel must not have columns of removed tickers
+	return file != NULL && fitting == header.tickers;
+}
+
+//****************************************************************************//
+//      Get cross section of field on latest date                             //
+//****************************************************************************//
+gboolean Panel::GetCrossSection (guint field, gdouble result[]) const
+{
+	// Check if panel has enough dates
+	guint need = field == PANEL_CHANGE ? 2 : 1;
+	if (header.dates < need)
+		return FALSE;
+
+	// Take latest known values of each ticker, so tickers which missed
+	// latest dates because of partial sync still get values
+	guint stored = field == PANEL_CHANGE ? PANEL_CLOSE : field;
+	for (guint32 i = 0; i < header.tickers; i++)
+	{
+		// Find latest known values
+		gdouble values [2];
+		guint count = 0;
+		for (guint row = header.dates; row-- && count < need;)
+		{
+			gfloat value = GetCell (row, stored, i);
+			if (!Math::IsNaN (value))
+				values[count++] = value;
+		}
+
+		// Set cross section value
+		if (count < need)
+			result[i] = M_NAN;
+		else if (field == PANEL_CHANGE)
+			result[i] = values[0] / values[1] - 1.0;
+		else
+			result[i] = values[0];
+	}
+
+	// Return success state
+	return TRUE;
+}
+
+//****************************************************************************//
+//      Get percentile ranks of all tickers on latest date                    //
+//****************************************************************************//
+gboolean Panel::GetRanks (guint field, gdouble result[]) const
+{
+	// Get cross section of field
+	if (field > PANEL_CHANGE || !GetCrossSection (field, result))
+		return FALSE;
+
+	// Collect known values
+	gdouble *sorted = g_new (gdouble, header.tickers + 1);
+	gsize count = 0;
+	for (guint32 i = 0; i < header.tickers; i++)
+		if (!Math::IsNaN (result[i]))
+			sorted[count++] = result[i];
+
+	// Sort known values
+	g_qsort_with_data (sorted, count, sizeof (gdouble), CompareValues, NULL);
+
+	// Convert values to percentile ranks
+	for (guint32 i = 0; i < header.tickers; i++)
+	{
+		if (!Math::IsNaN (result[i]))
+		{
+			gsize less = CountLess (sorted, count, result[i], FALSE);
+			gsize equal = CountLess (sorted, count, result[i], TRUE) - less;
+			result[i] = 100.0 * (less + 0.5 * equal) / count;
+		}
+	}
+
+	// Free sorted values
+	g_free (sorted);
+
+	// Return success state
+	return TRUE;
+}
+
+//****************************************************************************//
+//      Get tickers count                                                     //
+//****************************************************************************//
+guint Panel::GetTickers (void) const
+{
+	return header.tickers;
+}
+
+//****************************************************************************//
+//      Get dates count                                                       //
+//****************************************************************************//
+guint Panel::GetDates (void) const
+{
+	return header.dates;
+}
+
+//****************************************************************************//
+//      Get last panel date                                                   //
+//****************************************************************************//
+time_t Panel::GetLastDate (void) const
+{
+	// Check if panel has dates
+	if (header.dates)
+	{
+		// Return last panel date
+		gint64 date;
+		memcpy (&date, rows + (header.dates - 1) * rsize, sizeof (gint64));
+		return date;
+	}
+	else
+	{
+		// In case of error return TIME_ERROR
+		return TIME_ERROR;
+	}
+}
+/*
+################################################################################
+#                                 END OF FILE                                  #
+################################################################################
+*/
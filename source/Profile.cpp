@@ -0,0 +1,244 @@
+/*                                                                   Profile.cpp
+################################################################################
+# Encoding: UTF-8                                                  Tab size: 4 #
+#                                                                              #
+#                             PROFILE INSTRUMENTATION                          #
+#                                                                              #
+# License: LGPLv3+                               Copyleft (Ɔ) 2014, Jack Black #
+################################################################################
+*/
+# include	<Common.h>
+# include	<Profile.h>
+# include	<glib/gstdio.h>
+# include	<errno.h>
+# include	<sys/resource.h>
+
+//****************************************************************************//
+//      Internal constants                                                    //
+//****************************************************************************//
+# define	PROFILE_STAGE_LABEL		"Stage"			// Stage column label
+# define	PROFILE_TIME_LABEL		"Time, ms"		// Time column label
+# define	PROFILE_CALLS_LABEL		"Calls"			// Calls column label
+# define	PROFILE_BYTES_LABEL		"Bytes"			// Bytes column label
+
+//****************************************************************************//
+//      Internal variables                                                    //
+//****************************************************************************//
+static ProfileStage stages [PROFILE_STAGES];
+static const gchar *names [PROFILE_STAGES] = {"read", "write", "transfer", "parse", "validate", "stats", "model"};
+static glong startpeak;
+
+//****************************************************************************//
+//      Internal functions                                                    //
+//****************************************************************************//
+
+//============================================================================//
+//      Get peak resident memory of process in kilobytes                      //
+//============================================================================//
+static glong GetPeakMemory (void)
+{
+	struct rusage usage;
+	return getrusage (RUSAGE_SELF, &usage) ? 0 : usage.ru_maxrss;
+}
+
+//****************************************************************************//
+//      Constructor                                                           //
+//****************************************************************************//
+ProfileTimer::ProfileTimer (guint stage)
+{
+	// Set timer elements to default values
+	this -> stage = stage;
+	this -> start = ProfileStart ();
+	this -> bytes = 0;
+}
+
+//****************************************************************************//
+//      Destructor                                                            //
+//****************************************************************************//
+ProfileTimer::~ProfileTimer (void)
+{
+	// Add measured time to profile stage
+	ProfileStop (stage, start, bytes);
+}
+
+//****************************************************************************//
+//      Set amount of processed bytes                                         //
+//****************************************************************************//
+void ProfileTimer::SetBytes (gsize amount)
+{
+	bytes = amount;
+}
+
+//****************************************************************************//
+//      Get start time of stage measurement                                   //
+//****************************************************************************//
+gint64 ProfileStart (void)
+{
+	return g_get_monotonic_time ();
+}
+
+//****************************************************************************//
+//      Add measured time to profile stage                                    //
+//****************************************************************************//
+void ProfileStop (guint stage, gint64 start, gsize bytes)
+{
+	// Check stage id
+	if (stage < PROFILE_STAGES)
+	{
+		// Stages are updated from worker threads
+		__sync_fetch_and_add (&stages[stage].time, g_get_monotonic_time () - start);
+		__sync_fetch_and_add (&stages[stage].calls, 1);
+		__sync_fetch_and_add (&stages[stage].bytes, static_cast <gint64> (bytes));
+	}
+}
+
+//****************************************************************************//
+//      Clear all profile stages before new run                               //
+//****************************************************************************//
+void ResetProfile (void)
+{
+	// Remember process peak memory at run start
+	startpeak = GetPeakMemory ();
+
+	// Clear stage measurements
+	for (guint i = 0; i < PROFILE_STAGES; i++)
+	{
+		__sync_lock_test_and_set (&stages[i].time, 0);
+		__sync_lock_test_and_set (&stages[i].calls, 0);
+		__sync_lock_test_and_set (&stages[i].bytes, 0);
+	}
+}
+
+//****************************************************************************//
+//      Get measurements of profile stage                                     //
+//****************************************************************************//
+ProfileStage GetProfileStage (guint stage)
+{
+	// Empty stage for wrong stage id
+	ProfileStage result = {0, 0, 0};
+
+	// Read stage measurements
+	if (stage < PROFILE_STAGES)
+	{
+		result.time = __sync_fetch_and_add (&stages[stage].time, 0);
+		result.calls = __sync_fetch_and_add (&stages[stage].calls, 0);
+		result.bytes = __sync_fetch_and_add (&stages[stage].bytes, 0);
+	}
+
+	// Return stage measurements
+	return result;
+}
+
+//****************************************************************************//
+//      Get profile summary of run                                            //
+//****************************************************************************//
+gchar* GetProfileSummary (void)
+{
+	// Create string buffer
+	GString *string = g_string_new (NULL);
+
+	// Add time of all called stages
+	for (guint i = 0; i < PROFILE_STAGES; i++)
+	{
+		ProfileStage stage = GetProfileStage (i);
+		if (stage.calls)
+			g_string_append_printf (string, "%s %.1f ms, ", names [i], stage.time * 0.001);
+	}
+
+	// Add growth of peak memory during run and process peak memory
+	glong peak = GetPeakMemory ();
+	g_string_append_printf (string, "peak memory growth %.1f MB, process peak RSS %.1f MB", (peak - startpeak) / 1024.0, peak / 1024.0);
+
+	// Return profile summary
+	return g_string_free (string, FALSE);
+}
+
+//****************************************************************************//
+//      Write profile footer into report                                      //
+//****************************************************************************//
+void WriteProfile (Writer *writer)
+{
+	// Separate footer from report rows
+	writer -> EndRow ();
+
+	// Append footer header
+	writer -> AddString (PROFILE_STAGE_LABEL);
+	writer -> AddString (PROFILE_TIME_LABEL);
+	writer -> AddString (PROFILE_CALLS_LABEL);
+	writer -> AddString (PROFILE_BYTES_LABEL);
+	writer -> EndRow ();
+
+	// Append measurements of all called stages
+	for (guint i = 0; i < PROFILE_STAGES; i++)
+	{
+		ProfileStage stage = GetProfileStage (i);
+		if (stage.calls)
+		{
+			writer -> AddString (names [i]);
+			writer -> AddNumber (stage.time * 0.001, 1);
+			writer -> AddInt (stage.calls);
+			writer -> AddInt (stage.bytes);
+			writer -> EndRow ();
+		}
+	}
+}
+
+//****************************************************************************//
+//      Append profile of run into profile log of quotes directory            //
+//****************************************************************************//
+gboolean SaveProfile (const gchar *fname, const gchar *run, GError **error)
+{
+	// Compose profile record as one JSON object per line
+	glong peak = GetPeakMemory ();
+	GString *string = g_string_new (NULL);
+	g_string_append_printf (string, "{\"run\": \"%s\", \"time\": %" G_GINT64_FORMAT ", \"peak_growth_kb\": %li, \"process_peak_kb\": %li, \"stages\": {", run, g_get_real_time () / G_USEC_PER_SEC, peak - startpeak, peak);
+	for (guint i = 0; i < PROFILE_STAGES; i++)
+	{
+		ProfileStage stage = GetProfileStage (i);
+		g_string_append_printf (string, "%s\"%s\": {\"us\": %" G_GINT64_FORMAT ", \"calls\": %" G_GINT64_FORMAT ", \"bytes\": %" G_GINT64_FORMAT "}", i ? ", " : "", names [i], stage.time, stage.calls, stage.bytes);
+	}
+	g_string_append (string, "}}\n");
+
+	// Get profile log file name
+	gchar *path = GetQuotesPath (fname, PROFILE_FILE_NAME);
+
+	// Rotate profile log when it gets too big, so only one old log is kept
+	GStatBuf info;
+	if (g_stat (path, &info) == 0 && info.st_size >= PROFILE_MAX_SIZE)
+	{
+		gchar *old = g_strconcat (path, PROFILE_OLD_EXT, NULL);
+		g_rename (path, old);
+		g_free (old);
+	}
+
+	// Append profile record to the end of log
+	FILE *stream = g_fopen (path, "a");
+	g_free (path);
+	gboolean status = stream != NULL;
+	if (status)
+	{
+		status = fwrite (string -> str, string -> len, 1, stream) == 1;
+		status = (fclose (stream) == 0) && status;
+	}
+
+	// Free temporary string buffer
+	g_string_free (string, TRUE);
+
+	// Check file operation status
+	if (!status)
+	{
+		// Set error message
+		g_set_error (error, G_FILE_ERROR, g_file_error_from_errno (errno), "Can not write profile log: %s", g_strerror (errno));
+
+		// Return fail status
+		return FALSE;
+	}
+
+	// Return success status
+	return TRUE;
+}
+/*
+################################################################################
+#                                 END OF FILE                                  #
+################################################################################
+*/
@@ -9,6 +9,8 @@
 */
 # include	<Common.h>
 # include	<QuoteList.h>
+# include	<Indicators.h>
+# include	<Probes.h>
 # include	<Math.h>
 # include	<math.h>		// TODO: Удалить как поменяю процессор
 
@@ -59,6 +61,7 @@
 # define	BORDER_COLOR		"#7CB0DF"		// Border line color
 # define	LINE_COLOR			"#6BA5D3"		// Line color
 # define	BAR_COLOR			"#ACE6FF"		// Bar color
+# define	AVERAGE_COLOR		"#FFE38C"		// Moving average color
 
 //============================================================================//
 //      Line width                                                            //
@@ -67,6 +70,12 @@
 # define	LINE_WIDTH			1				// Line width
 # define	PRICE_WIDTH			3				// Price bar width
 # define	VOLUME_WIDTH		5				// Volume bar width
+# define	AVERAGE_WIDTH		2				// Moving average width
+
+//============================================================================//
+//      Overlay settings                                                      //
+//============================================================================//
+# define	AVERAGE_PERIOD		50				// Period of moving average overlay
 
 //****************************************************************************//
 //      Cursor structure                                                  //
@@ -91,6 +100,7 @@ static	GtkToolItem	*ZoomOut;
 static	gsize		shift;
 static	gsize		psize;
 static	gdouble		scale;
+static	gdouble		*averages;
 static	gint		xpos;
 static	gint		ypos;
 static	GdkRGBA		background;
@@ -100,6 +110,7 @@ static	GdkRGBA		ltext;
 static	GdkRGBA		border;
 static	GdkRGBA		line;
 static	GdkRGBA		bar;
+static	GdkRGBA		average;
 
 //****************************************************************************//
 //      Adjust cursor position to graph region                                //
@@ -472,6 +483,57 @@ static void DrawPriceBars (cairo_t *cr, const quote_t array[], gsize size, gdoub
 	}
 }
 
+//****************************************************************************//
+//      Draw moving average line                                              //
+//****************************************************************************//
+static void DrawAverageLine (cairo_t *cr, const gdouble array[], gsize size, gdouble shift, gdouble step, gdouble width, gdouble height, gdouble delta, gdouble base, gdouble scale)
+{
+	// Save cairo presets
+	cairo_save (cr);
+
+	// Clip line to graph region
+	cairo_rectangle (cr, 0.0, 0.0, width, height);
+	cairo_clip (cr);
+
+	// Set line style
+	cairo_set_antialias (cr, CAIRO_ANTIALIAS_SUBPIXEL);
+	cairo_set_source_rgb (cr, average.red, average.green, average.blue);
+	cairo_set_line_width (cr, scale * AVERAGE_WIDTH);
+	cairo_set_line_cap (cr, CAIRO_LINE_CAP_ROUND);
+	cairo_set_line_join (cr, CAIRO_LINE_JOIN_ROUND);
+	cairo_set_dash (cr, NULL, 0, 0);
+
+	// Draw line through average values
+	gboolean drawing = FALSE;
+	while (size)
+	{
+		// Skip bars without enough history
+		if (Math::IsNaN (array[0]))
+			drawing = FALSE;
+		else
+		{
+			// Get average price
+			gdouble value = height - height * (array[0] - base) / delta;
+
+			// Add line point
+			if (drawing)
+				cairo_line_to (cr, shift, value);
+			else
+				cairo_move_to (cr, shift, value);
+			drawing = TRUE;
+		}
+
+		// Go to next bar
+		shift += step;
+		array--;
+		size--;
+	}
+	cairo_stroke (cr);
+
+	// Restore cairo presets
+	cairo_restore (cr);
+}
+
 //****************************************************************************//
 //      Draw volume bars                                                      //
 //****************************************************************************//
@@ -638,7 +700,7 @@ static void DrawScaleFactor (cairo_t *cr, gdouble scale, gdouble width, gdouble
 //****************************************************************************//
 //      Draw price graph                                                      //
 //****************************************************************************//
-static void DrawPriceGraph (cairo_t *cr, const quote_t array[], gsize size, gdouble bsize, gdouble width, gdouble height, gdouble scale, Cursor cursor)
+static void DrawPriceGraph (cairo_t *cr, const quote_t array[], const gdouble averages[], gsize size, gdouble bsize, gdouble width, gdouble height, gdouble scale, Cursor cursor)
 {
 	// Get min and max prices
 	gdouble min = RoundDown (MinPrice (array, size));
@@ -682,6 +744,9 @@ static void DrawPriceGraph (cairo_t *cr, const quote_t array[], gsize size, gdou
 	// Draw price bars
 	DrawPriceBars (cr, array, size, 0.5 * bsize, bsize, height, delta, min, scale, cursor);
 
+	// Draw moving average overlay
+	DrawAverageLine (cr, averages, size, 0.5 * bsize, bsize, width, height, delta, min, scale);
+
 	// Show graph frame
 	cairo_set_antialias (cr, CAIRO_ANTIALIAS_NONE);
 	cairo_set_source_rgb (cr, border.red, border.green, border.blue);
@@ -775,8 +840,8 @@ static gboolean DrawGraph (GtkWidget *widget, cairo_t *cr, gpointer data)
 	// Get quote list
 	QuoteList list = quotes -> GetQuoteList ();
 
-	// Adjust stock quotes
-	AdjustQuotes (list.array, list.size);
+	// Trace start of graph drawing
+	PROBE1 (draw__start, list.size);
 
 	// Get widget parameters
 	gint width = gtk_widget_get_allocated_width (GTK_WIDGET (widget));
@@ -809,7 +874,7 @@ static gboolean DrawGraph (GtkWidget *widget, cairo_t *cr, gpointer data)
 	cairo_translate(cr, PADDING_LEFT, PADDING_TOP);
 	cursor = {xpos, ypos};
 	AdjustCursor (&cursor, PADDING_LEFT, PADDING_TOP, gwidth, pheight);
-	DrawPriceGraph (cr, list.array + shift + count - 1, count, bsize, gwidth, pheight, scale, cursor);
+	DrawPriceGraph (cr, list.array + shift + count - 1, averages + shift + count - 1, count, bsize, gwidth, pheight, scale, cursor);
 	cairo_restore (cr);
 
 	// Draw volume graph
@@ -826,6 +891,9 @@ static gboolean DrawGraph (GtkWidget *widget, cairo_t *cr, gpointer data)
 	// Draw scale factor
 	DrawScaleFactor (cr, scale, width, height);
 
+	// Trace end of graph drawing
+	PROBE2 (draw__done, list.size, count);
+
 	// Return process event status
 	return FALSE;
 }
@@ -1126,6 +1194,19 @@ static GtkWidget* CreateDrawingArea (Quotes *quotes)
 	// Set default scale
 	scale = 1.0;
 
+	// Get quote list
+	QuoteList list = quotes -> GetQuoteList ();
+
+	// Adjust stock quotes
+	AdjustQuotes (list.array, list.size);
+
+	// Compute moving average overlay once for all redraws
+	gdouble *closes = g_new (gdouble, list.size);
+	averages = g_new (gdouble, list.size);
+	GetSeries (list.array, list.size, INDICATOR_CLOSE, closes);
+	SMA (closes, list.size, AVERAGE_PERIOD, averages);
+	g_free (closes);
+
 	// Set drawing colors
 	gdk_rgba_parse  (&background, BACKGROUND_COLOR);
 	gdk_rgba_parse  (&text, TEXT_COLOR);
@@ -1134,6 +1215,7 @@ static GtkWidget* CreateDrawingArea (Quotes *quotes)
 	gdk_rgba_parse  (&border, BORDER_COLOR);
 	gdk_rgba_parse  (&line, LINE_COLOR);
 	gdk_rgba_parse  (&bar, BAR_COLOR);
+	gdk_rgba_parse  (&average, AVERAGE_COLOR);
 
 	// Assign signal handlers
 	g_signal_connect (G_OBJECT (drawing), "draw", G_CALLBACK (DrawGraph), quotes);
@@ -1204,6 +1286,10 @@ gboolean ViewQuotesDialog (GtkWindow *parent, const gchar *path, const gchar *ti
 
 		// Destroy dialog widget
 		gtk_widget_destroy (GTK_WIDGET (window));
+
+		// Free moving average overlay
+		g_free (averages);
+		averages = NULL;
 	}
 
 	// Return operation status
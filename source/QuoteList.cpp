@@ -11,6 +11,10 @@
 # include	<QuoteList.h>
 # include	<Math.h>
 # include	<Numbers.h>
+# include	<glib/gstdio.h>
+# include	<unistd.h>
+# include	<errno.h>
+# include	<fcntl.h>
 
 //****************************************************************************//
 //      Internal constants                                                    //
@@ -50,6 +54,22 @@ static	GtkWidget	*treeview;
 //****************************************************************************//
 time_t ExtractDate (const gchar *string, GError **error)
 {
+	// Try to parse date in ISO format through calendar table
+	time_t date;
+	if (ParseDate (string, &date))
+	{
+		// Check if date is correct
+		if (date == static_cast <time_t> (TIME_ERROR))
+		{
+			// Set error message
+			g_set_error (error, G_FILE_ERROR, G_FILE_ERROR_IO, "Incorrect time stamp");
+			return TIME_ERROR;
+		}
+
+		// Return date value
+		return date;
+	}
+
 	// Current symbol position into string
 	gsize len;
 
@@ -105,7 +125,7 @@ time_t ExtractDate (const gchar *string, GError **error)
 	}
 
 	// Convert date to unix time
-	time_t date = Time::ConvertDate (day, mon, year, 0, 0, 0);
+	date = MakeDate (year, mon, day);
 	if (date == static_cast <time_t> (TIME_ERROR))
 	{
 		// Set error message
@@ -260,8 +280,7 @@ gboolean OpenQuoteList (Quotes *quotes, const gchar *fname, GError **error)
 gboolean SaveQuoteList (Quotes *quotes, const gchar *fname, GError **error)
 {
 	// Get quote directory
-	gchar *temp = g_strdup (fname);
-	*(g_utf8_strrchr (temp, -1, '/')) = '\0';
+	gchar *temp = g_path_get_dirname (fname);
 
 	// Make quote directory if does not exist
 	g_mkdir_with_parents (temp, 0755);
@@ -273,6 +292,230 @@ gboolean SaveQuoteList (Quotes *quotes, const gchar *fname, GError **error)
 	return quotes -> SaveList (fname, error);
 }
 
+//****************************************************************************//
+//      Staged quote file structure                                           //
+//****************************************************************************//
+struct StagedFile
+{
+	gchar		*fname;			// Original quote file name
+	gboolean	pending;		// Staged file was not committed yet
+};
+
+//****************************************************************************//
+//      Free staged quote file structure                                      //
+//****************************************************************************//
+static void FreeStaged (gpointer data)
+{
+	// Convert data pointer
+	StagedFile *file = reinterpret_cast <StagedFile*> (data);
+
+	// Remove staged file which was not committed
+	if (file -> pending)
+	{
+		// Get staged file name
+		gchar *temp = g_strconcat (file -> fname, QUOTE_STAGE_EXT, NULL);
+
+		// Remove staged file
+		g_unlink (temp);
+
+		// Free temporary string buffer
+		g_free (temp);
+	}
+
+	// Free staged file elements
+	g_free (file -> fname);
+
+	// Free staged file structure
+	g_free (file);
+}
+
+//****************************************************************************//
+//      Create list of staged quote files                                     //
+//****************************************************************************//
+GPtrArray* NewStagedLists (void)
+{
+	// Staged files are removed if list is released before commit
+	return g_ptr_array_new_with_free_func (FreeStaged);
+}
+
+//****************************************************************************//
+//      Stage quote list for batched commit                                   //
+//****************************************************************************//
+gboolean StageQuoteList (Quotes *quotes, const gchar *fname, GPtrArray *staged, GError **error)
+{
+	// Get quote directory
+	gchar *temp = g_path_get_dirname (fname);
+
+	// Make quote directory if does not exist
+	g_mkdir_with_parents (temp, 0755);
+
+	// Free temporary string buffer
+	g_free (temp);
+
+	// Create staged file next to original file
+	temp = g_strconcat (fname, QUOTE_STAGE_EXT, NULL);
+	gint fd = g_open (temp, O_WRONLY | O_CREAT | O_TRUNC, 0644);
+	if (fd < 0)
+	{
+		// Set error message
+		gint code = errno;
+		g_set_error (error, G_FILE_ERROR, g_file_error_from_errno (code), "Failed to create file '%s': %s", temp, g_strerror (code));
+
+		// Free temporary string buffer
+		g_free (temp);
+
+		// Return fail status
+		return FALSE;
+	}
+
+	// Write quote list into staged file
+	gboolean status = quotes -> WriteList (fd, error);
+
+	// Flush staged file to disk before it may replace original file,
+	// so no file descriptors are kept opened till commit
+	if (status && fsync (fd) != 0)
+	{
+		// Set error message
+		gint code = errno;
+		g_set_error (error, G_FILE_ERROR, g_file_error_from_errno (code), "Failed to write file '%s': %s", temp, g_strerror (code));
+
+		// Set fail status
+		status = FALSE;
+	}
+
+	// Close staged file
+	if (close (fd) != 0 && status)
+	{
+		// Set error message
+		gint code = errno;
+		g_set_error (error, G_FILE_ERROR, g_file_error_from_errno (code), "Failed to close file '%s': %s", temp, g_strerror (code));
+
+		// Set fail status
+		status = FALSE;
+	}
+
+	// Check file operation status
+	if (!status)
+	{
+		// Remove staged file
+		g_unlink (temp);
+
+		// Free temporary string buffer
+		g_free (temp);
+
+		// Return fail status
+		return FALSE;
+	}
+
+	// Add staged file to commit list
+	StagedFile *file = g_new (StagedFile, 1);
+	file -> fname = g_strdup (fname);
+	file -> pending = TRUE;
+	g_ptr_array_add (staged, file);
+
+	// Free temporary string buffer
+	g_free (temp);
+
+	// Return success state
+	return TRUE;
+}
+
+//****************************************************************************//
+//      Commit staged quote lists                                             //
+//****************************************************************************//
+gboolean CommitQuoteLists (GPtrArray *staged, GError **error)
+{
+	// Operation status
+	gboolean status = TRUE;
+
+	// Replace original files by staged files
+	for (guint i = 0; i < staged -> len; i++)
+	{
+		// Get staged file
+		StagedFile *file = reinterpret_cast <StagedFile*> (g_ptr_array_index (staged, i));
+		gchar *temp = g_strconcat (file -> fname, QUOTE_STAGE_EXT, NULL);
+
+		// Rename staged file which was flushed to disk on staging
+		gint code = g_rename (temp, file -> fname) == 0 ? 0 : errno;
+		file -> pending = FALSE;
+
+		// Check if commit of file failed
+		if (code)
+		{
+			// Remove staged file
+			g_unlink (temp);
+
+			// Set error message of first failed file
+			if (status)
+				g_set_error (error, G_FILE_ERROR, g_file_error_from_errno (code), "Can not commit quote file '%s': %s", file -> fname, g_strerror (code));
+
+			// Set fail status
+			status = FALSE;
+		}
+
+		// Free temporary string buffer
+		g_free (temp);
+	}
+
+	// Flush renames of quote directory to disk at once
+	if (staged -> len)
+	{
+		// Get quote directory
+		StagedFile *file = reinterpret_cast <StagedFile*> (g_ptr_array_index (staged, 0));
+		gchar *temp = g_path_get_dirname (file -> fname);
+
+		// Sync directory entries
+		gint fd = g_open (temp, O_RDONLY, 0);
+		if (fd >= 0)
+		{
+			fsync (fd);
+			close (fd);
+		}
+
+		// Free temporary string buffer
+		g_free (temp);
+	}
+
+	// Clear staged list
+	g_ptr_array_set_size (staged, 0);
+
+	// Return file operation status
+	return status;
+}
+
+//****************************************************************************//
+//      Remove staged quote files left by interrupted commit                  //
+//****************************************************************************//
+void RemoveStagedLists (const gchar *fname)
+{
+	// Get quote directory
+	gchar *path = GetQuotesPath (fname, "");
+
+	// Try to open quote directory
+	GDir *dir = g_dir_open (path, 0, NULL);
+	if (dir)
+	{
+		// Iterate through all directory entries
+		const gchar *name;
+		while ((name = g_dir_read_name (dir)))
+		{
+			// Remove staged quote file
+			if (g_str_has_suffix (name, QUOTE_STAGE_EXT))
+			{
+				gchar *temp = g_strconcat (path, name, NULL);
+				g_unlink (temp);
+				g_free (temp);
+			}
+		}
+
+		// Close quote directory
+		g_dir_close (dir);
+	}
+
+	// Free temporary string buffer
+	g_free (path);
+}
+
 //****************************************************************************//
 //      Check if date unique                                                  //
 //****************************************************************************//
@@ -398,6 +641,8 @@ static void ExportQuotes (GtkToolButton *toolbutton, gpointer data)
 		// Create file filter
 		GtkFileFilter *filter = gtk_file_filter_new ();
 		gtk_file_filter_add_pattern (GTK_FILE_FILTER (filter), "*.tsv");
+		gtk_file_filter_add_pattern (GTK_FILE_FILTER (filter), "*.csv");
+		gtk_file_filter_add_pattern (GTK_FILE_FILTER (filter), "*.bin");
 
 		// Add file filter to file chooser
 		gtk_file_chooser_set_filter (GTK_FILE_CHOOSER (dialog), GTK_FILE_FILTER (filter));
@@ -0,0 +1,224 @@
+/*                                                             QuoteProvider.cpp
+################################################################################
+# Encoding: UTF-8                                                  Tab size: 4 #
+#                                                                              #
+#                             QUOTE PROVIDER CLASS                             #
+#                                                                              #
+# License: LGPLv3+                               Copyleft (Ɔ) 2014, Jack Black #
+################################################################################
+*/
+# include	<QuoteList.h>
+# include	<QuoteProvider.h>
+# include	<Profile.h>
+
+//****************************************************************************//
+//      Constructor                                                           //
+//****************************************************************************//
+QuoteProvider::QuoteProvider (void)
+{
+	// Set provider elements to default values
+	array = NULL;
+	size = 0;
+	unchanged = FALSE;
+}
+
+//****************************************************************************//
+//      Destructor                                                            //
+//****************************************************************************//
+QuoteProvider::~QuoteProvider (void)
+{
+	// Free provider elements
+	g_free (array);
+
+	// Set provider elements to default values
+	array = NULL;
+	size = 0;
+}
+
+//****************************************************************************//
+//      Parse quotes from CSV string buffer                                   //
+//****************************************************************************//
+gboolean QuoteProvider::ParseQuotes (const gchar *buffer, time_t start, time_t end, GError **error)
+{
+	// Create accumulator object
+	Accumulator accumulator (0);
+
+	// Parse quotes into temporary accumulator
+	return ParseQuotes (buffer, &accumulator, start, end, error);
+}
+
+//****************************************************************************//
+//      Parse quotes from CSV string buffer using external accumulator        //
+//****************************************************************************//
+gboolean QuoteProvider::ParseQuotes (const gchar *buffer, Accumulator *accumulator, time_t start, time_t end, GError **error)
+{
+	// Skip quotes header
+	const gchar *pos = g_utf8_strchr (buffer, -1, '\n');
+	if (pos == NULL)
+	{
+		// Set error message
+		g_set_error (error, G_FILE_ERROR, G_FILE_ERROR_IO, "Quote list is empty");
+
+		// Return fail status
+		return FALSE;
+	}
+
+	// Go to first quote row
+	pos += sizeof (gchar);
+
+	// Extract quotes from string buffer
+	gint64 time = ProfileStart ();
+	gsize count = ExtractQuotes (pos, accumulator, error);
+	ProfileStop (PROFILE_PARSE, time, count == static_cast <gsize> (-1) ? 0 : count * sizeof (quote_t));
+	if (count == static_cast <gsize> (-1))
+		return FALSE;
+
+	// Check quotes and keep quotes from date range
+	return SetQuotes (reinterpret_cast <const quote_t*> (accumulator -> Data ()), count, start, end, error);
+}
+
+//****************************************************************************//
+//      Check quotes and keep quotes from date range                          //
+//****************************************************************************//
+gboolean QuoteProvider::SetQuotes (const quote_t *quotes, gsize count, time_t start, time_t end, GError **error)
+{
+	// Check stock quotes for errors
+	gint64 time = ProfileStart ();
+	QuoteList result = CheckQuotes (quotes, count, error);
+	ProfileStop (PROFILE_VALIDATE, time, count * sizeof (quote_t));
+	if (result.size == static_cast <gsize> (-1))
+		return FALSE;
+
+	// Skip quotes which are newer than end date
+	gsize first = 0;
+	while (first < result.size && result.array[first].date > end)
+		first++;
+
+	// Skip quotes which are older than start date
+	gsize last = result.size;
+	while (last > first && result.array[last-1].date < start)
+		last--;
+
+	// Move quotes from date range to the beginning of quotes array
+	if (first)
+		memmove (result.array, result.array + first, (last - first) * sizeof (quote_t));
+
+	// Free quote elements
+	g_free (array);
+
+	// Set new quote elements
+	array = result.array;
+	size = last - first;
+
+	// Return success state
+	return TRUE;
+}
+
+//****************************************************************************//
+//      Begin batch of requests                                               //
+//****************************************************************************//
+gboolean QuoteProvider::Begin (const gchar* const tickers[], gsize count, GError **error)
+{
+	// Providers without batch support have nothing to prepare
+	return TRUE;
+}
+
+//****************************************************************************//
+//      End batch of requests                                                 //
+//****************************************************************************//
+gboolean QuoteProvider::End (GError **error)
+{
+	// Providers without batch support have nothing to finish
+	return TRUE;
+}
+
+//****************************************************************************//
+//      Get request statistics                                                //
+//****************************************************************************//
+gchar* QuoteProvider::GetStatistics (void) const
+{
+	// Providers without remote requests have no statistics
+	return NULL;
+}
+
+//****************************************************************************//
+//      Check if provider requests quotes from quote server                   //
+//****************************************************************************//
+gboolean QuoteProvider::IsRemote (void) const
+{
+	// Providers read local files by default
+	return FALSE;
+}
+
+//****************************************************************************//
+//      Set callback which is called while waiting between requests           //
+//****************************************************************************//
+void QuoteProvider::SetWaitFunc (GSourceFunc func, gpointer data)
+{
+	// Providers without remote requests never wait
+}
+
+//****************************************************************************//
+//      Get quote list                                                        //
+//****************************************************************************//
+QuoteList QuoteProvider::GetQuoteList (void) const
+{
+	return {array, size};
+}
+
+//****************************************************************************//
+//      Get quotes count                                                      //
+//****************************************************************************//
+gint QuoteProvider::GetCount (void) const
+{
+	return size;
+}
+
+//****************************************************************************//
+//      Check if quotes were not modified since previous request              //
+//****************************************************************************//
+gboolean QuoteProvider::IsUnchanged (void) const
+{
+	return unchanged;
+}
+
+//****************************************************************************//
+//      Get first quote date                                                  //
+//****************************************************************************//
+time_t QuoteProvider::GetFirstDate (void) const
+{
+	// Check if quotes array has stock quotes
+	if (size)
+	{
+		// Return first quote date
+		return array[size-1].date;
+	}
+	else
+	{
+		// In case of error return TIME_ERROR
+		return TIME_ERROR;
+	}
+}
+
+//****************************************************************************//
+//      Get last quote date                                                   //
+//****************************************************************************//
+time_t QuoteProvider::GetLastDate (void) const
+{
+	// Check if quotes array has stock quotes
+	if (size)
+	{
+		// Return last quote date
+		return array[0].date;
+	}
+	else
+	{
+		// In case of error return TIME_ERROR
+		return TIME_ERROR;
+	}
+}
+/*
+################################################################################
+#                                 END OF FILE                                  #
+################################################################################
+*/
@@ -12,6 +12,12 @@
 # include	<Math.h>
 # include	<Array.h>
 # include	<Statistics.h>
+# include	<Writer.h>
+# include	<Profile.h>
+# include	<Probes.h>
+# include	<string.h>
+# include	<unistd.h>
+# include	<errno.h>
 
 //****************************************************************************//
 //      Internal functions                                                    //
@@ -30,52 +36,113 @@ static sint64_t QuoteCompare (const void *key1, const void *key2)
 	return Math::Compare (ptr1 -> date, ptr2 -> date);
 }
 
+//============================================================================//
+//      Get violation mask of quotes block                                    //
+//============================================================================//
+//
+// Bit i of the mask is set if quote i has incorrect prices, is not older than
+// previous quote or falls on a week end. All conditions are evaluated without
+// branches, so the loop over fixed size block is unrolled and vectorized by
+// compiler. Only blocks with nonzero mask need the precise scalar check.
+//
+static guint ScanQuotes (const quote_t array[], gsize size, time_t prev)
+{
+	// Violation mask
+	guint mask = 0;
+
+	// Check all quotes of block
+	for (gsize i = 0; i < size; i++)
+	{
+		// Get quote fields
+		time_t date = array[i].date;
+		gfloat open = array[i].open;
+		gfloat high = array[i].high;
+		gfloat low = array[i].low;
+		gfloat close = array[i].close;
+
+		// Check prices like IsQuoteCorrect does
+		guint bad = (low <= 0) | (open < low) | (open > high) | (close < low) | (close > high);
+
+		// Check quote time stamp
+		bad |= (date >= prev) | (date < 0);
+
+		// Check for week end (1970-01-01 is Thursday)
+		bad |= (date / TIME_DAY + 3) % 7 >= 5;
+
+		// Update violation mask
+		mask |= bad << i;
+
+		// Set previous time stamp
+		prev = date;
+	}
+
+	// Return violation mask
+	return mask;
+}
+
 //============================================================================//
 //      Check quote list for errors                                           //
 //============================================================================//
-static gsize CheckQuoteslist (const quote_t *list[], gsize size, GError **error)
+static gsize CheckQuoteslist (quote_t list[], gsize size, GError **error)
 {
 	// Set target and source pointers
-	const quote_t **target = list;
-	const quote_t **source = list;
+	quote_t *target = list;
+	const quote_t *source = list;
 
 	// Set previous time stamp
 	time_t prev = TIME_ERROR - 1;
 
-	// Check all quotes
+	// Check all quotes block by block
 	while (size)
 	{
-		// Check quote time stamp
-		if (source[0] -> date >= prev)
+		// Get violation mask of next block
+		gsize count = MIN (size, CHECK_BLOCK);
+		if (ScanQuotes (source, count, prev) == 0)
 		{
-			// Set error message
-			date_struct curdate = Time::ExtractDate (source[0] -> date);
-			g_set_error (error, G_FILE_ERROR, G_FILE_ERROR_IO, "Found duplicate timestamp %.4i-%.2d-%.2d", curdate.year, curdate.mon, curdate.day);
-
-			// Return fail status
-			return -1;
+			// Keep whole block of correct working day quotes
+			if (target != source)
+				memmove (target, source, count * sizeof (quote_t));
+			target += count;
 		}
-
-		// Check if quote correct
-		if (!IsQuoteCorrect (source[0] -> date, source[0] -> open, source[0] -> high, source[0] -> low, source[0] -> close, error))
+		else
 		{
-			// Return fail status
-			return -1;
-		}
+			// Check block quote by quote to find offending quote
+			for (gsize i = 0; i < count; i++)
+			{
+				// Check quote time stamp
+				if (source[i].date >= prev)
+				{
+					// Set error message
+					date_struct curdate = Time::ExtractDate (source[i].date);
+					g_set_error (error, G_FILE_ERROR, G_FILE_ERROR_IO, "Found duplicate timestamp %.4i-%.2d-%.2d", curdate.year, curdate.mon, curdate.day);
 
-		// Remove indicative quotes for week ends
-		if (static_cast <uint8_t> (Time::WeekDay (source[0] -> date) - 1) < 5)
-		{
-			target[0] = source[0];
-			target++;
-		}
+					// Return fail status
+					return -1;
+				}
 
-		// Set previous time stamp
-		prev = source[0] -> date;
+				// Check if quote correct
+				if (!IsQuoteCorrect (source[i].date, source[i].open, source[i].high, source[i].low, source[i].close, error))
+				{
+					// Return fail status
+					return -1;
+				}
 
-		// Go to next stock quote
-		source++;
-		size--;
+				// Remove indicative quotes for week ends
+				if (static_cast <uint8_t> (Time::WeekDay (source[i].date) - 1) < 5)
+				{
+					target[0] = source[i];
+					target++;
+				}
+
+				// Set previous time stamp
+				prev = source[i].date;
+			}
+		}
+
+		// Go to next block of stock quotes
+		prev = source[count-1].date;
+		source += count;
+		size -= count;
 	}
 
 	// Return corrected list size
@@ -87,9 +154,9 @@ static gsize CheckQuoteslist (const quote_t *list[], gsize size, GError **error)
 //****************************************************************************//
 
 //============================================================================//
-//      Extract quotes from string buffer                                     //
+//      Extract quote records from string buffer                              //
 //============================================================================//
-gsize ExtractQuotes (const gchar *buffer, Accumulator *accumulator, GError **error)
+static gsize ExtractRecords (const gchar *buffer, Accumulator *accumulator, GError **error)
 {
 	// Init records count
 	gsize count = 0;
@@ -315,11 +382,41 @@ gsize ExtractQuotes (const gchar *buffer, Accumulator *accumulator, GError **err
 	return count;
 }
 
+//============================================================================//
+//      Extract quotes from string buffer                                     //
+//============================================================================//
+gsize ExtractQuotes (const gchar *buffer, Accumulator *accumulator, GError **error)
+{
+	// Trace start of quotes extraction
+	PROBE1 (extract__start, buffer);
+
+	// Extract quote records
+	gsize count = ExtractRecords (buffer, accumulator, error);
+
+	// Trace end of quotes extraction
+	PROBE2 (extract__done, buffer, count);
+
+	// Return records count
+	return count;
+}
+
 //============================================================================//
 //      Check quotes array for errors                                         //
 //============================================================================//
 QuoteList CheckQuotes (const quote_t *array, gsize size, GError **error)
 {
+	// Allocate checked quotes on heap
+	return CheckQuotes (array, size, NULL, error);
+}
+
+//****************************************************************************//
+//      Check stock quotes for errors using arena memory                      //
+//****************************************************************************//
+QuoteList CheckQuotes (const quote_t *array, gsize size, Arena *arena, GError **error)
+{
+	// Trace start of quotes check
+	PROBE1 (check__start, size);
+
 	// Init result structure
 	QuoteList result = {NULL, static_cast <gsize> (-1)};
 
@@ -341,34 +438,143 @@ QuoteList CheckQuotes (const quote_t *array, gsize size, GError **error)
 	// Sort quotes by date
 	Array::QuickSortDsc (reinterpret_cast <const void**> (ptr), size, QuoteCompare);
 
+	// Allocate memory for quotes array
+	gsize bytes = size * sizeof (quote_t);
+	quote_t *quotes = reinterpret_cast <quote_t*> (arena ? arena -> Alloc (bytes) : g_malloc (bytes));
+
+	// Copy sorted quotes into quotes array
+	const quote_t **sptr = ptr;
+	quote_t *tptr = quotes;
+	count = size;
+	while (count)
+	{
+		tptr[0] = *sptr[0];
+		sptr++;
+		tptr++;
+		count--;
+	}
+
 	// Check quotes list for errors
-	size = CheckQuoteslist (ptr, size, error);
+	size = CheckQuoteslist (quotes, size, error);
 	if (size != static_cast <gsize> (-1))
 	{
-		// Allocate memory for quotes array
-		quote_t *quotes = reinterpret_cast <quote_t*> (g_malloc (size * sizeof (quote_t)));
-
-		// Copy sorted quotes into quotes array
-		const quote_t **sptr = ptr;
-		quote_t *tptr = quotes;
-		count = size;
-		while (count)
-		{
-			tptr[0] = *sptr[0];
-			sptr++;
-			tptr++;
-			count--;
-		}
-
 		// Set result structure fields
 		result.array = quotes;
 		result.size = size;
 	}
+	else
+	{
+		// Free quotes array
+		if (arena == NULL)
+			g_free (quotes);
+	}
+
+	// Trace end of quotes check
+	PROBE1 (check__done, result.size);
 
 	// Normal exit
 	return result;
 }
 
+//****************************************************************************//
+//      Verify sorted stock quotes in place without copying them              //
+//****************************************************************************//
+//
+// Quotes must be sorted by date in descending order as they are stored in
+// quote files. If they are not, then G_FILE_ERROR_INVAL error is set and the
+// caller should fall back to CheckQuotes, which sorts a copy of quotes.
+//
+gboolean VerifyQuotes (const quote_t *array, gsize size, QuoteSummary *summary, GError **error)
+{
+	// Init summary structure
+	summary -> count = 0;
+	summary -> first = TIME_ERROR;
+	summary -> last = TIME_ERROR;
+	summary -> price = 0;
+
+	// Set previous time stamp
+	time_t prev = TIME_ERROR - 1;
+
+	// Check all quotes block by block
+	const quote_t *ptr = array;
+	while (size)
+	{
+		// Get violation mask of next block
+		gsize count = MIN (size, CHECK_BLOCK);
+		if (ScanQuotes (ptr, count, prev) == 0)
+		{
+			// Remember latest quote
+			if (summary -> count == 0)
+			{
+				summary -> last = ptr[0].date;
+				summary -> price = ptr[0].close;
+			}
+
+			// Count whole block of correct working day quotes
+			summary -> first = ptr[count-1].date;
+			summary -> count += count;
+		}
+		else
+		{
+			// Check block quote by quote to find offending quote
+			for (gsize i = 0; i < count; i++)
+			{
+				// Check quote time stamp
+				if (ptr[i].date > prev)
+				{
+					// Set error message
+					g_set_error (error, G_FILE_ERROR, G_FILE_ERROR_INVAL, "Quotes are not sorted by date");
+
+					// Return fail status
+					return FALSE;
+				}
+				if (ptr[i].date == prev)
+				{
+					// Set error message
+					date_struct curdate = Time::ExtractDate (ptr[i].date);
+					g_set_error (error, G_FILE_ERROR, G_FILE_ERROR_IO, "Found duplicate timestamp %.4i-%.2d-%.2d", curdate.year, curdate.mon, curdate.day);
+
+					// Return fail status
+					return FALSE;
+				}
+
+				// Check if quote correct
+				if (!IsQuoteCorrect (ptr[i].date, ptr[i].open, ptr[i].high, ptr[i].low, ptr[i].close, error))
+				{
+					// Return fail status
+					return FALSE;
+				}
+
+				// Count only working day quotes like CheckQuotes does
+				if (static_cast <uint8_t> (Time::WeekDay (ptr[i].date) - 1) < 5)
+				{
+					// Remember latest quote
+					if (summary -> count == 0)
+					{
+						summary -> last = ptr[i].date;
+						summary -> price = ptr[i].close;
+					}
+
+					// Update first quote date
+					summary -> first = ptr[i].date;
+					summary -> count++;
+				}
+
+				// Set previous time stamp
+				prev = ptr[i].date;
+			}
+		}
+
+		// Go to next block of stock quotes
+		prev = ptr[count-1].date;
+		ptr += count;
+		size -= count;
+	}
+
+	// Return success state
+	return TRUE;
+}
+
 //****************************************************************************//
 //      Constructor                                                           //
 //****************************************************************************//
@@ -378,6 +584,7 @@ Quotes::Quotes (void)
 	array = NULL;
 	size = 0;
 	synctime = TIME_ERROR;
+	arena = NULL;
 }
 
 //****************************************************************************//
@@ -386,7 +593,7 @@ Quotes::Quotes (void)
 Quotes::~Quotes (void)
 {
 	// Free quote elements
-	g_free (array);
+	Release ();
 
 	// Set quote elements to default values
 	array = NULL;
@@ -394,13 +601,47 @@ Quotes::~Quotes (void)
 	synctime = TIME_ERROR;
 }
 
+//****************************************************************************//
+//      Allocate memory for quotes                                            //
+//****************************************************************************//
+quote_t* Quotes::Allocate (gsize count)
+{
+	// Take memory from arena if it is set
+	gsize bytes = count * sizeof (quote_t);
+	return reinterpret_cast <quote_t*> (arena ? arena -> Alloc (bytes) : g_malloc (bytes));
+}
+
+//****************************************************************************//
+//      Release memory of quotes                                              //
+//****************************************************************************//
+void Quotes::Release (void)
+{
+	// Arena memory is released by arena owner
+	if (arena == NULL)
+		g_free (array);
+}
+
+//****************************************************************************//
+//      Set arena for quotes memory                                           //
+//****************************************************************************//
+void Quotes::SetArena (Arena *arena)
+{
+	// Free quote elements
+	Release ();
+
+	// Set new quote elements
+	array = NULL;
+	size = 0;
+	this -> arena = arena;
+}
+
 //****************************************************************************//
 //      Create new quote list                                                 //
 //****************************************************************************//
 void Quotes::NewList (time_t stime)
 {
 	// Free quote elements
-	g_free (array);
+	Release ();
 
 	// Set new quote elements
 	array = NULL;
@@ -413,15 +654,23 @@ void Quotes::NewList (time_t stime)
 //****************************************************************************//
 gboolean Quotes::OpenList (const gchar *fname, GError **error)
 {
+	// Trace start of quotes opening
+	PROBE1 (open__start, fname);
+
 	// Try to load file content into string buffer
 	gchar *content;
-	gsize bytes;
-	gboolean status = g_file_get_contents (fname, &content, &bytes, error);
+	gsize bytes = 0;
+	gboolean status;
+	gint64 start = ProfileStart ();
+	if (arena)
+		status = (content = arena -> LoadFile (fname, &bytes, error)) != NULL;
+	else
+		status = g_file_get_contents (fname, &content, &bytes, error);
+	ProfileStop (PROFILE_READ, start, bytes);
 	if (status)
 	{
 		// Check file size
-		bytes -= sizeof (time_t);
-		if (bytes % sizeof (quote_t))
+		if (bytes < sizeof (time_t) || (bytes - sizeof (time_t)) % sizeof (quote_t))
 		{
 			// Set error message
 			g_set_error (error, G_FILE_ERROR, G_FILE_ERROR_IO, "Quotes file is corrupted");
@@ -432,8 +681,10 @@ gboolean Quotes::OpenList (const gchar *fname, GError **error)
 		else
 		{
 			// Check stock quotes for errors
-			bytes /= sizeof (quote_t);
-			QuoteList result = CheckQuotes (reinterpret_cast <const quote_t*> (content), bytes, error);
+			bytes = (bytes - sizeof (time_t)) / sizeof (quote_t);
+			start = ProfileStart ();
+			QuoteList result = CheckQuotes (reinterpret_cast <const quote_t*> (content), bytes, arena, error);
+			ProfileStop (PROFILE_VALIDATE, start, bytes * sizeof (quote_t));
 			if (result.size == static_cast <gsize> (-1))
 			{
 				// Set fail status
@@ -442,7 +693,7 @@ gboolean Quotes::OpenList (const gchar *fname, GError **error)
 			else
 			{
 				// Free quote elements
-				g_free (array);
+				Release ();
 
 				// Set new quote elements
 				array = const_cast <quote_t*> (result.array);
@@ -452,9 +703,13 @@ gboolean Quotes::OpenList (const gchar *fname, GError **error)
 		}
 
 		// Free temporary string buffer
-		g_free (content);
+		if (arena == NULL)
+			g_free (content);
 	}
 
+	// Trace end of quotes opening
+	PROBE3 (open__done, fname, status, status ? size : 0);
+
 	// Return file operation status
 	return status;
 }
@@ -464,25 +719,77 @@ gboolean Quotes::OpenList (const gchar *fname, GError **error)
 //****************************************************************************//
 gboolean Quotes::SaveList (const gchar *fname, GError **error)
 {
-	// Create string buffer
-	GString *string = g_string_new (NULL);
+	// Create file buffer of exact size
+	gsize bytes = size * sizeof (quote_t);
+	gchar *buffer = reinterpret_cast <gchar*> (arena ? arena -> Alloc (bytes + sizeof (time_t)) : g_malloc (bytes + sizeof (time_t)));
 
-	// Store quotes array into string buffer
-	string = g_string_append_len (string, reinterpret_cast <const gchar*> (array), size * sizeof (quote_t));
+	// Store quotes array into file buffer
+	memcpy (buffer, array, bytes);
 
 	// Store sync time
-	string = g_string_append_len (string, reinterpret_cast <const gchar*> (&synctime), sizeof (time_t));
+	memcpy (buffer + bytes, &synctime, sizeof (time_t));
 
-	// Try to save string buffer into file
-	gboolean status = g_file_set_contents (fname, string -> str, string -> len, error);
+	// Try to save file buffer into file
+	gint64 start = ProfileStart ();
+	gboolean status = g_file_set_contents (fname, buffer, bytes + sizeof (time_t), error);
+	ProfileStop (PROFILE_WRITE, start, bytes + sizeof (time_t));
 
-	// Relase string buffer
-	g_string_free (string, TRUE);
+	// Relase file buffer
+	if (arena == NULL)
+		g_free (buffer);
 
 	// Return file operation status
 	return status;
 }
 
+//****************************************************************************//
+//      Write quote list into opened file                                     //
+//****************************************************************************//
+gboolean Quotes::WriteList (gint fd, GError **error)
+{
+	// Create file buffer of exact size
+	gsize bytes = size * sizeof (quote_t);
+	gsize total = bytes + sizeof (time_t);
+	gchar *buffer = reinterpret_cast <gchar*> (arena ? arena -> Alloc (total) : g_malloc (total));
+
+	// Store quotes array and sync time into file buffer
+	memcpy (buffer, array, bytes);
+	memcpy (buffer + bytes, &synctime, sizeof (time_t));
+
+	// Write file buffer into file
+	gint64 start = ProfileStart ();
+	gsize done = 0;
+	gint code = 0;
+	while (code == 0 && done < total)
+	{
+		gssize count = write (fd, buffer + done, total - done);
+		if (count < 0 && errno == EINTR)
+			continue;
+		if (count <= 0)
+			code = count ? errno : EIO;
+		else
+			done += count;
+	}
+	ProfileStop (PROFILE_WRITE, start, done);
+
+	// Relase file buffer
+	if (arena == NULL)
+		g_free (buffer);
+
+	// Check if write failed
+	if (code)
+	{
+		// Set error message
+		g_set_error (error, G_FILE_ERROR, g_file_error_from_errno (code), "Failed to write quote file: %s", g_strerror (code));
+
+		// Return fail status
+		return FALSE;
+	}
+
+	// Return success state
+	return TRUE;
+}
+
 //****************************************************************************//
 //      Import quote list from file                                           //
 //****************************************************************************//
@@ -522,7 +829,7 @@ gboolean Quotes::ImportList (const gchar *fname, GError **error)
 			else
 			{
 				// Check stock quotes for errors
-				QuoteList result = CheckQuotes (reinterpret_cast <const quote_t*> (accumulator.Data ()), count, error);
+				QuoteList result = CheckQuotes (reinterpret_cast <const quote_t*> (accumulator.Data ()), count, arena, error);
 				if (result.size == static_cast <gsize> (-1))
 				{
 					// Set fail status
@@ -531,7 +838,7 @@ gboolean Quotes::ImportList (const gchar *fname, GError **error)
 				else
 				{
 					// Free quote elements
-					g_free (array);
+					Release ();
 
 					// Set new quote elements
 					array = const_cast <quote_t*> (result.array);
@@ -553,34 +860,54 @@ gboolean Quotes::ImportList (const gchar *fname, GError **error)
 //****************************************************************************//
 gboolean Quotes::ExportList (const gchar *fname, GError **error)
 {
-	// Create string buffer
-	GString *string = g_string_new (NULL);
-
-	// Append quotes header
-	g_string_append_printf (string, "Date\tOpen\tHigh\tLow\tClose\tVolume\tAdjusted close\n");
+	// Try to open export file
+	Writer writer;
+	guint format = Writer::GetFormat (fname);
+	if (!writer.Open (fname, format, error))
+		return FALSE;
 
-	// Fill string buffer
-	quote_t *ptr = array;
-	gsize count = size;
-	while (count)
+	// Check if quotes should be exported as raw records
+	if (format == WRITER_BINARY)
 	{
-		// Append quote information into string buffer
-		date_struct curdate = Time::ExtractDate (ptr[0].date);
-		g_string_append_printf (string, "%.4i-%.2d-%.2d\t%.2f\t%.2f\t%.2f\t%.2f\t%ld\t%.2f\n", curdate.year, curdate.mon, curdate.day, ptr[0].open, ptr[0].high, ptr[0].low, ptr[0].close, ptr[0].volume, ptr[0].adjclose);
-
-		// Go to next stock quote
-		ptr++;
-		count--;
+		// Append quotes and sync time like quote files store them
+		writer.AddData (array, size * sizeof (quote_t));
+		writer.AddData (&synctime, sizeof (time_t));
 	}
+	else
+	{
+		// Append quotes header
+		writer.AddString ("Date");
+		writer.AddString ("Open");
+		writer.AddString ("High");
+		writer.AddString ("Low");
+		writer.AddString ("Close");
+		writer.AddString ("Volume");
+		writer.AddString ("Adjusted close");
+		writer.EndRow ();
+
+		// Fill export file
+		quote_t *ptr = array;
+		gsize count = size;
+		while (count)
+		{
+			// Append quote information into export file
+			writer.AddDate (ptr[0].date);
+			writer.AddNumber (ptr[0].open, 2);
+			writer.AddNumber (ptr[0].high, 2);
+			writer.AddNumber (ptr[0].low, 2);
+			writer.AddNumber (ptr[0].close, 2);
+			writer.AddInt (ptr[0].volume);
+			writer.AddNumber (ptr[0].adjclose, 2);
+			writer.EndRow ();
 
-	// Try to save string buffer into file
-	gboolean status = g_file_set_contents (fname, string -> str, string -> len, error);
-
-	// Relase string buffer
-	g_string_free (string, TRUE);
+			// Go to next stock quote
+			ptr++;
+			count--;
+		}
+	}
 
-	// Return file operation status
-	return status;
+	// Close export file
+	return writer.Close (error);
 }
 
 //****************************************************************************//
@@ -620,14 +947,14 @@ gboolean Quotes::AddQuotes (QuoteList newlist, time_t stime, GError **error)
 	else
 	{
 		// Allocate memory for quotes array
-		quote_t *quotes = reinterpret_cast <quote_t*> (g_malloc ((size + newlist.size) * sizeof (quote_t)));
+		quote_t *quotes = Allocate (size + newlist.size);
 
 		// Copy quotes into new quotes array
 		Array::Copy (quotes, newlist.array, newlist.size * sizeof (quote_t));
 		Array::Copy (quotes + newlist.size, array, size * sizeof (quote_t));
 
 		// Free quote elements
-		g_free (array);
+		Release ();
 
 		// Set new quote elements
 		array = quotes;
@@ -671,11 +998,11 @@ gboolean Quotes::SetQuotes (GtkListStore *list, GError **error)
 	}
 
 	// Check stock quotes for errors
-	QuoteList result = CheckQuotes (temp, count, error);
+	QuoteList result = CheckQuotes (temp, count, arena, error);
 	if (result.size != static_cast <gsize> (-1))
 	{
 		// Free quote elements
-		g_free (array);
+		Release ();
 
 		// Set new quote elements
 		array = const_cast <quote_t*> (result.array);
@@ -735,6 +1062,14 @@ gint Quotes::GetCount (void) const
 	return size;
 }
 
+//****************************************************************************//
+//      Set quotes sync time                                                  //
+//****************************************************************************//
+void Quotes::SetSyncTime (time_t stime)
+{
+	synctime = stime;
+}
+
 //****************************************************************************//
 //      Get quotes sync time                                                  //
 //****************************************************************************//
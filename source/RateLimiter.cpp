@@ -0,0 +1,147 @@
+/*                                                               RateLimiter.cpp
+################################################################################
+# Encoding: UTF-8                                                  Tab size: 4 #
+#                                                                              #
+#                              RATE LIMITER CLASS                              #
+#                                                                              #
+# License: LGPLv3+                               Copyleft (Ɔ) 2014, Jack Black #
+################################################################################
+*/
+# include	<RateLimiter.h>
+
+//****************************************************************************//
+//      Constructor                                                           //
+//****************************************************************************//
+RateLimiter::RateLimiter (void)
+{
+	// Set limiter elements to default values
+	func = NULL;
+	data = NULL;
+	Reset ();
+}
+
+//****************************************************************************//
+//      Reset limiter state and statistics                                    //
+//****************************************************************************//
+void RateLimiter::Reset (void)
+{
+	// Set limiter elements to default values
+	rate = RATE_START;
+	tokens = RATE_BURST;
+	backoff = 0.0;
+	stamp = g_get_monotonic_time ();
+	pause = stamp;
+	start = stamp;
+	requests = 0;
+	throttled = 0;
+	bytes = 0;
+}
+
+//****************************************************************************//
+//      Set callback which is called while waiting                            //
+//****************************************************************************//
+void RateLimiter::SetWaitFunc (GSourceFunc func, gpointer data)
+{
+	this -> func = func;
+	this -> data = data;
+}
+
+//****************************************************************************//
+//      Wait until next request is allowed                                    //
+//****************************************************************************//
+gboolean RateLimiter::Wait (void)
+{
+	while (TRUE)
+	{
+		// Refill token bucket with tokens earned since last refill
+		gint64 now = g_get_monotonic_time ();
+		tokens = MIN (tokens + rate * (now - stamp) / G_USEC_PER_SEC, RATE_BURST);
+		stamp = now;
+
+		// Compute time to wait for next request
+		gint64 delay;
+		if (now < pause)
+			delay = pause - now;
+		else if (tokens < 1.0)
+			delay = static_cast <gint64> ((1.0 - tokens) * G_USEC_PER_SEC / rate) + 1;
+		else
+		{
+			// Take token for new request
+			tokens -= 1.0;
+
+			// Count new request
+			if (requests == 0)
+				start = now;
+			requests++;
+
+			// Return success status
+			return TRUE;
+		}
+
+		// Sleep for a short time slice
+		g_usleep (MIN (delay, RATE_WAIT_SLICE));
+
+		// Let caller process its events and check if waiting was cancelled
+		if (func && !func (data))
+			return FALSE;
+	}
+}
+
+//****************************************************************************//
+//      Adjust request rate by result of request                              //
+//****************************************************************************//
+void RateLimiter::Update (gboolean throttle, guint64 size)
+{
+	// Count received bytes
+	bytes += size;
+
+	// Check if server throttled request
+	if (throttle)
+	{
+		// Halve request rate and drop all saved tokens
+		rate = MAX (rate / 2.0, RATE_MIN);
+		tokens = 0.0;
+
+		// Double backoff delay and pause requests
+		backoff = backoff > 0.0 ? MIN (backoff * 2.0, RATE_BACKOFF_MAX) : RATE_BACKOFF_MIN;
+		pause = g_get_monotonic_time () + static_cast <gint64> (backoff * G_USEC_PER_SEC);
+
+		// Count throttled request
+		throttled++;
+	}
+	else
+	{
+		// Slowly increase request rate and reset backoff delay
+		rate = MIN (rate + RATE_STEP, RATE_MAX);
+		backoff = 0.0;
+	}
+}
+
+//****************************************************************************//
+//      Request statistics                                                    //
+//****************************************************************************//
+gchar* RateLimiter::GetStatistics (void) const
+{
+	// Get duration of requests
+	gdouble elapsed = static_cast <gdouble> (g_get_monotonic_time () - start) / G_USEC_PER_SEC;
+
+	// Get average request rate
+	gdouble speed = elapsed > 0.0 ? requests / elapsed : 0.0;
+
+	// Convert received bytes into string
+	gchar *size = g_format_size (bytes);
+
+	// Compose statistics string
+	gchar *result = g_strdup_printf ("%u requests, %.2f requests/s, %u throttled, %s received", requests, speed, throttled, size);
+
+	// Free temporary string buffer
+	g_free (size);
+
+	// Return statistics string
+	return result;
+}
+/*
+################################################################################
+#                                 END OF FILE                                  #
+################################################################################
+*/
@@ -0,0 +1,74 @@
+/*                                                                   Results.cpp
+################################################################################
+# Encoding: UTF-8                                                  Tab size: 4 #
+#                                                                              #
+#                                RESULTS CLASS                                 #
+#                                                                              #
+# License: LGPLv3+                               Copyleft (Ɔ) 2014, Jack Black #
+################################################################################
+*/
+# include	<Results.h>
+
+//****************************************************************************//
+//      Constructor                                                           //
+//****************************************************************************//
+Results::Results (void)
+{
+	// Set result elements to default values
+	array = g_array_new (FALSE, FALSE, sizeof (Result));
+}
+
+//****************************************************************************//
+//      Destructor                                                            //
+//****************************************************************************//
+Results::~Results (void)
+{
+	// Free result elements
+	g_array_free (array, TRUE);
+
+	// Set result elements to default values
+	array = NULL;
+}
+
+//****************************************************************************//
+//      Add new result                                                        //
+//****************************************************************************//
+void Results::Add (guint index, guint status)
+{
+	// Append new result to the end of array
+	Result result = {index, status};
+	g_array_append_val (array, result);
+}
+
+//****************************************************************************//
+//      Remove all results                                                    //
+//****************************************************************************//
+void Results::Clear (void)
+{
+	g_array_set_size (array, 0);
+}
+
+//****************************************************************************//
+//      Get count of results                                                  //
+//****************************************************************************//
+guint Results::GetSize (void) const
+{
+	return array -> len;
+}
+
+//****************************************************************************//
+//      Get result by its number                                              //
+//****************************************************************************//
+const Result* Results::GetResult (guint number) const
+{
+	// Check if result number is valid
+	if (number < array -> len)
+		return &g_array_index (array, Result, number);
+	else
+		return NULL;
+}
+/*
+################################################################################
+#                                 END OF FILE                                  #
+################################################################################
+*/
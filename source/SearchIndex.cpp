@@ -0,0 +1,287 @@
+/*                                                               SearchIndex.cpp
+################################################################################
+# Encoding: UTF-8                                                  Tab size: 4 #
+#                                                                              #
+#                               SEARCH INDEX CLASS                             #
+#                                                                              #
+# License: LGPLv3+                               Copyleft (Ɔ) 2014, Jack Black #
+################################################################################
+*/
+# include	<StockList.h>
+# include	<SearchIndex.h>
+# include	<string.h>
+
+//****************************************************************************//
+//      Internal functions                                                    //
+//****************************************************************************//
+
+//============================================================================//
+//      Free search index object                                              //
+//============================================================================//
+static void FreeSearchIndex (gpointer data)
+{
+	delete reinterpret_cast <SearchIndex*> (data);
+}
+
+//============================================================================//
+//      Compare search entries by value                                       //
+//============================================================================//
+static gint CompareEntries (gconstpointer a, gconstpointer b)
+{
+	// Convert entry pointers
+	const SearchEntry *ea = reinterpret_cast <const SearchEntry*> (a);
+	const SearchEntry *eb = reinterpret_cast <const SearchEntry*> (b);
+
+	// Compare folded values
+	return strcmp (ea -> value, eb -> value);
+}
+
+//============================================================================//
+//      Get length of prefix if pattern is prefix pattern                     //
+//============================================================================//
+static gssize GetPrefixLength (const gchar *pattern, gboolean *exact)
+{
+	// Find first wildcard symbol
+	gsize length = strcspn (pattern, "*?");
+
+	// Pattern without wildcards matches exact value
+	*exact = pattern[length] == '\0';
+	if (*exact)
+		return length;
+
+	// Pattern with the only trailing '*' matches prefix
+	if (pattern[length] == '*' && pattern[length + 1] == '\0')
+		return length;
+
+	// Pattern should be matched by glob matching
+	return -1;
+}
+
+//****************************************************************************//
+//      Constructor                                                           //
+//****************************************************************************//
+SearchIndex::SearchIndex (void)
+{
+	// Set search index elements to default values
+	model = NULL;
+	strings = g_string_chunk_new (0x10000);
+	for (guint i = 0; i < SEARCH_COLUMNS; i++)
+		entries [i] = g_array_new (FALSE, FALSE, sizeof (SearchEntry));
+	matches = g_array_new (FALSE, FALSE, sizeof (guint));
+	flags = g_byte_array_new ();
+	dirty = TRUE;
+}
+
+//****************************************************************************//
+//      Destructor                                                            //
+//****************************************************************************//
+SearchIndex::~SearchIndex (void)
+{
+	// Free search index elements
+	g_string_chunk_free (strings);
+	for (guint i = 0; i < SEARCH_COLUMNS; i++)
+		g_array_free (entries [i], TRUE);
+	g_array_free (matches, TRUE);
+	g_byte_array_free (flags, TRUE);
+
+	// Set search index elements to default values
+	model = NULL;
+	strings = NULL;
+	matches = NULL;
+	flags = NULL;
+}
+
+//****************************************************************************//
+//      Rebuild index from stock list                                         //
+//****************************************************************************//
+void SearchIndex::Build (void)
+{
+	// Clear old index
+	g_string_chunk_clear (strings);
+	for (guint i = 0; i < SEARCH_COLUMNS; i++)
+		g_array_set_size (entries [i], 0);
+
+	// Get iterator position
+	GtkTreeIter iter;
+	if (gtk_tree_model_get_iter_first (model, &iter))
+	{
+		// Iterate through all elements
+		do {
+			// Get stock fields
+			gchar *fields [SEARCH_COLUMNS];
+			guint index;
+			gtk_tree_model_get (model, &iter, STOCK_TICKER_ID, &fields [0], STOCK_NAME_ID, &fields [1], STOCK_COUNTRY_ID, &fields [2], STOCK_SECTOR_ID, &fields [3], STOCK_INDUSTRY_ID, &fields [4], STOCK_INDEX_ID, &index, -1);
+
+			// Add folded values into index
+			for (guint i = 0; i < SEARCH_COLUMNS; i++)
+			{
+				gchar *folded = g_utf8_casefold (fields [i] ? fields [i] : "", -1);
+				SearchEntry entry = {g_string_chunk_insert_const (strings, folded), index};
+				g_array_append_val (entries [i], entry);
+				g_free (folded);
+				g_free (fields [i]);
+			}
+
+			// Change iterator position to next element
+		} while (gtk_tree_model_iter_next (model, &iter));
+	}
+
+	// Sort entries of all columns by value
+	for (guint i = 0; i < SEARCH_COLUMNS; i++)
+		g_array_sort (entries [i], CompareEntries);
+
+	// Index is up to date
+	dirty = FALSE;
+}
+
+//****************************************************************************//
+//      Add found stock                                                       //
+//****************************************************************************//
+void SearchIndex::AddMatch (guint index)
+{
+	// Add stock to found stocks
+	g_array_append_val (matches, index);
+
+	// Set match flag of stock
+	if (index >= flags -> len)
+		g_byte_array_set_size (flags, index + 1);
+	flags -> data [index] = TRUE;
+}
+
+//****************************************************************************//
+//      Signal handler for changes of stock list                              //
+//****************************************************************************//
+void SearchIndex::ListChanged (GtkTreeModel *model, GtkTreePath *path, GtkTreeIter *iter, gpointer data)
+{
+	reinterpret_cast <SearchIndex*> (data) -> dirty = TRUE;
+}
+
+//****************************************************************************//
+//      Signal handler for "row-deleted" signal of stock list                 //
+//****************************************************************************//
+void SearchIndex::RowDeleted (GtkTreeModel *model, GtkTreePath *path, gpointer data)
+{
+	reinterpret_cast <SearchIndex*> (data) -> dirty = TRUE;
+}
+
+//****************************************************************************//
+//      Attach search index to stock list                                     //
+//****************************************************************************//
+void SearchIndex::Attach (GtkListStore *list)
+{
+	// Set indexed stock list
+	model = GTK_TREE_MODEL (list);
+
+	// Rebuild index after any change of stock list
+	g_signal_connect (G_OBJECT (list), "row-changed", G_CALLBACK (ListChanged), this);
+	g_signal_connect (G_OBJECT (list), "row-inserted", G_CALLBACK (ListChanged), this);
+	g_signal_connect (G_OBJECT (list), "row-deleted", G_CALLBACK (RowDeleted), this);
+
+	// Stock list frees search index with itself
+	g_object_set_data_full (G_OBJECT (list), SEARCH_INDEX_DATA, this, FreeSearchIndex);
+}
+
+//****************************************************************************//
+//      Find stocks by glob-style pattern                                     //
+//****************************************************************************//
+guint SearchIndex::Find (guint column, const gchar *pattern)
+{
+	// Clear previous search results
+	Clear ();
+
+	// Check column id
+	if (column >= SEARCH_COLUMNS)
+		return 0;
+
+	// Rebuild index if stock list was changed
+	if (dirty)
+		Build ();
+
+	// Convert pattern to case independent representation
+	gchar *ipattern = g_utf8_casefold (pattern, -1);
+
+	// Get search entries of column
+	const SearchEntry *array = reinterpret_cast <const SearchEntry*> (entries [column] -> data);
+	guint size = entries [column] -> len;
+
+	// Check if pattern is exact value or prefix
+	gboolean exact;
+	gssize length = GetPrefixLength (ipattern, &exact);
+	if (length >= 0)
+	{
+		// Find first entry which is not less than prefix
+		ipattern[length] = '\0';
+		guint low = 0;
+		guint high = size;
+		while (low < high)
+		{
+			guint middle = low + (high - low) / 2;
+			if (strcmp (array[middle].value, ipattern) < 0)
+				low = middle + 1;
+			else
+				high = middle;
+		}
+
+		// Add all entries which have the prefix
+		for (guint i = low; i < size; i++)
+		{
+			// Check prefix of entry value
+			if (strncmp (array[i].value, ipattern, length))
+				break;
+
+			// Add entry which matches pattern
+			if (!exact || array[i].value[length] == '\0')
+				AddMatch (array[i].index);
+		}
+	}
+	else
+	{
+		// Create glob-style pattern object
+		GPatternSpec *gpattern = g_pattern_spec_new (ipattern);
+
+		// Match all folded values
+		for (guint i = 0; i < size; i++)
+			if (g_pattern_match_string (gpattern, array[i].value))
+				AddMatch (array[i].index);
+
+		// Free glob-style pattern object
+		g_pattern_spec_free (gpattern);
+	}
+
+	// Free temporary string buffer
+	g_free (ipattern);
+
+	// Return count of found stocks
+	return matches -> len;
+}
+
+//****************************************************************************//
+//      Clear found stocks                                                    //
+//****************************************************************************//
+void SearchIndex::Clear (void)
+{
+	g_array_set_size (matches, 0);
+	if (flags -> len)
+		memset (flags -> data, 0, flags -> len);
+}
+
+//****************************************************************************//
+//      Get selection indices of found stocks                                 //
+//****************************************************************************//
+const GArray* SearchIndex::GetMatches (void) const
+{
+	return matches;
+}
+
+//****************************************************************************//
+//      Check if stock was found                                              //
+//****************************************************************************//
+gboolean SearchIndex::IsMatch (guint index) const
+{
+	return index < flags -> len && flags -> data [index];
+}
+/*
+################################################################################
+#                                 END OF FILE                                  #
+################################################################################
+*/
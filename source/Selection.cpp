@@ -0,0 +1,273 @@
+/*                                                                 Selection.cpp
+################################################################################
+# Encoding: UTF-8                                                  Tab size: 4 #
+#                                                                              #
+#                               SELECTION CLASS                                #
+#                                                                              #
+# License: LGPLv3+                               Copyleft (Ɔ) 2014, Jack Black #
+################################################################################
+*/
+# include	<Selection.h>
+# include	<string.h>
+
+//****************************************************************************//
+//      Selection constants                                                   //
+//****************************************************************************//
+# define	WORD_BITS		64			// Count of bits in one bitset word
+# define	WORD_SHIFT		6			// Shift to convert row index into word index
+# define	WORD_MASK		63			// Mask to extract bit position from row index
+
+//****************************************************************************//
+//      Internal functions                                                    //
+//****************************************************************************//
+
+//============================================================================//
+//      Get count of words to hold row indices                                //
+//============================================================================//
+static inline guint WordCount (guint size)
+{
+	return (size + WORD_BITS - 1) >> WORD_SHIFT;
+}
+
+//============================================================================//
+//      Get bit mask of row index                                             //
+//============================================================================//
+static inline guint64 BitMask (guint index)
+{
+	return G_GUINT64_CONSTANT (1) << (index & WORD_MASK);
+}
+
+//****************************************************************************//
+//      Constructor                                                           //
+//****************************************************************************//
+Selection::Selection (void)
+{
+	// Set selection elements to default values
+	marks = NULL;
+	rows = NULL;
+	size = 0;
+	words = 0;
+	count = 0;
+}
+
+//****************************************************************************//
+//      Destructor                                                            //
+//****************************************************************************//
+Selection::~Selection (void)
+{
+	// Free selection elements
+	g_free (marks);
+	g_free (rows);
+
+	// Set selection elements to default values
+	marks = NULL;
+	rows = NULL;
+	size = 0;
+	words = 0;
+	count = 0;
+}
+
+//****************************************************************************//
+//      Reserve space for row indices                                         //
+//****************************************************************************//
+void Selection::Reserve (guint capacity)
+{
+	// Check if bitsets are large enough
+	guint need = WordCount (capacity);
+	if (need <= words)
+		return;
+
+	// Grow bitsets geometrically
+	guint grow = MAX (need, words * 2);
+	marks = g_renew (guint64, marks, grow);
+	rows = g_renew (guint64, rows, grow);
+
+	// Clear new words
+	memset (marks + words, 0, (grow - words) * sizeof (guint64));
+	memset (rows + words, 0, (grow - words) * sizeof (guint64));
+
+	// Set new bitset size
+	words = grow;
+}
+
+//****************************************************************************//
+//      Count selected rows                                                   //
+//****************************************************************************//
+void Selection::Recount (void)
+{
+	// Sum population counts of all words
+	guint total = 0;
+	for (guint i = 0; i < WordCount (size); i++)
+		total += __builtin_popcountll (marks[i]);
+
+	// Set new count of selected rows
+	count = total;
+}
+
+//****************************************************************************//
+//      Set count of rows and clear selection                                 //
+//****************************************************************************//
+void Selection::Resize (guint rcount)
+{
+	// Reserve space for row indices
+	Reserve (rcount);
+
+	// Clear all bits
+	if (words)
+	{
+		memset (marks, 0, words * sizeof (guint64));
+		memset (rows, 0, words * sizeof (guint64));
+	}
+
+	// Mark all rows as existing
+	guint full = rcount >> WORD_SHIFT;
+	memset (rows, 0xFF, full * sizeof (guint64));
+	if (rcount & WORD_MASK)
+		rows[full] = BitMask (rcount) - 1;
+
+	// Set new selection size
+	size = rcount;
+	count = 0;
+}
+
+//****************************************************************************//
+//      Add new unselected row and get its index                              //
+//****************************************************************************//
+guint Selection::Append (void)
+{
+	// Reserve space for new row index
+	Reserve (size + 1);
+
+	// Mark new row as existing
+	guint index = size++;
+	rows[index >> WORD_SHIFT] |= BitMask (index);
+
+	// Return index of new row
+	return index;
+}
+
+//****************************************************************************//
+//      Remove row from selection                                             //
+//****************************************************************************//
+void Selection::Remove (guint index)
+{
+	// Check if row index is valid
+	if (index < size)
+	{
+		// Unselect row
+		Set (index, FALSE);
+
+		// Mark row as removed
+		rows[index >> WORD_SHIFT] &= ~BitMask (index);
+	}
+}
+
+//****************************************************************************//
+//      Get row state                                                         //
+//****************************************************************************//
+gboolean Selection::Get (guint index) const
+{
+	// Check if row index is valid
+	if (index < size)
+		return (marks[index >> WORD_SHIFT] & BitMask (index)) != 0;
+	else
+		return FALSE;
+}
+
+//****************************************************************************//
+//      Set row state                                                         //
+//****************************************************************************//
+void Selection::Set (guint index, gboolean state)
+{
+	// Check if row index is valid and row exists
+	if (index < size && (rows[index >> WORD_SHIFT] & BitMask (index)))
+	{
+		// Get word with row bit
+		guint64 *word = marks + (index >> WORD_SHIFT);
+		guint64 mask = BitMask (index);
+
+		// Change row state and count of selected rows
+		if (state && !(*word & mask))
+		{
+			*word |= mask;
+			count++;
+		}
+		else if (!state && (*word & mask))
+		{
+			*word &= ~mask;
+			count--;
+		}
+	}
+}
+
+//****************************************************************************//
+//      Select all rows                                                       //
+//****************************************************************************//
+void Selection::SelectAll (void)
+{
+	// Copy bits of existing rows
+	memcpy (marks, rows, WordCount (size) * sizeof (guint64));
+
+	// Count selected rows
+	Recount ();
+}
+
+//****************************************************************************//
+//      Unselect all rows                                                     //
+//****************************************************************************//
+void Selection::UnselectAll (void)
+{
+	// Clear all bits
+	memset (marks, 0, WordCount (size) * sizeof (guint64));
+
+	// Set count of selected rows
+	count = 0;
+}
+
+//****************************************************************************//
+//      Invert selection                                                      //
+//****************************************************************************//
+void Selection::Invert (void)
+{
+	// Switch bits of existing rows
+	for (guint i = 0; i < WordCount (size); i++)
+		marks[i] = ~marks[i] & rows[i];
+
+	// Count selected rows
+	Recount ();
+}
+
+//****************************************************************************//
+//      Select rows of bitset only                                            //
+//****************************************************************************//
+void Selection::Assign (const guint64 bits[], guint bwords)
+{
+	// Copy bits of existing rows
+	guint total = WordCount (size);
+	for (guint i = 0; i < total; i++)
+		marks[i] = i < bwords ? bits[i] & rows[i] : 0;
+
+	// Count selected rows
+	Recount ();
+}
+
+//****************************************************************************//
+//      Get count of selected rows                                            //
+//****************************************************************************//
+guint Selection::GetCount (void) const
+{
+	return count;
+}
+
+//****************************************************************************//
+//      Get count of row indices                                              //
+//****************************************************************************//
+guint Selection::GetSize (void) const
+{
+	return size;
+}
+/*
+################################################################################
+#                                 END OF FILE                                  #
+################################################################################
+*/
@@ -0,0 +1,191 @@
+/*                                                                  SortKeys.cpp
+################################################################################
+# Encoding: UTF-8                                                  Tab size: 4 #
+#                                                                              #
+#                                SORT KEYS CLASS                               #
+#                                                                              #
+# License: LGPLv3+                               Copyleft (Ɔ) 2014, Jack Black #
+################################################################################
+*/
+# include	<StockList.h>
+# include	<SortKeys.h>
+# include	<string.h>
+
+//****************************************************************************//
+//      Internal functions                                                    //
+//****************************************************************************//
+
+//============================================================================//
+//      Free sort keys object                                                 //
+//============================================================================//
+static void FreeSortKeys (gpointer data)
+{
+	delete reinterpret_cast <SortKeys*> (data);
+}
+
+//****************************************************************************//
+//      Constructor                                                           //
+//****************************************************************************//
+SortKeys::SortKeys (void)
+{
+	// Set sort keys elements to default values
+	for (guint i = 0; i < SORT_COLUMNS; i++)
+	{
+		keys [i] = g_ptr_array_new_with_free_func (g_free);
+		columns [i].keys = this;
+		columns [i].column = i;
+	}
+	secondary = SORT_NONE;
+}
+
+//****************************************************************************//
+//      Destructor                                                            //
+//****************************************************************************//
+SortKeys::~SortKeys (void)
+{
+	// Free sort keys elements
+	for (guint i = 0; i < SORT_COLUMNS; i++)
+	{
+		g_ptr_array_free (keys [i], TRUE);
+		keys [i] = NULL;
+	}
+}
+
+//****************************************************************************//
+//      Get collation key of row                                              //
+//****************************************************************************//
+const gchar* SortKeys::GetKey (GtkTreeModel *model, GtkTreeIter *iter, guint index, guint column)
+{
+	// Grow keys array up to row index
+	GPtrArray *array = keys [column];
+	if (index >= array -> len)
+		g_ptr_array_set_size (array, index + 1);
+
+	// Make collation key if row does not have it yet
+	gchar *key = reinterpret_cast <gchar*> (g_ptr_array_index (array, index));
+	if (key == NULL)
+	{
+		// Get field value
+		gchar *value;
+		gtk_tree_model_get (model, iter, column, &value, -1);
+
+		// Make collation key
+		key = g_utf8_collate_key (value ? value : "", -1);
+		g_ptr_array_index (array, index) = key;
+
+		// Free temporary string buffer
+		g_free (value);
+	}
+
+	// Return collation key
+	return key;
+}
+
+//****************************************************************************//
+//      Compare stocks by collation keys                                      //
+//****************************************************************************//
+gint SortKeys::Compare (GtkTreeModel *model, GtkTreeIter *a, GtkTreeIter *b, gpointer data)
+{
+	// Convert data pointer
+	const SortColumn *sort = reinterpret_cast <const SortColumn*> (data);
+	SortKeys *keys = sort -> keys;
+
+	// Get selection indices of stocks
+	guint aindex, bindex;
+	gtk_tree_model_get (model, a, STOCK_INDEX_ID, &aindex, -1);
+	gtk_tree_model_get (model, b, STOCK_INDEX_ID, &bindex, -1);
+
+	// Compare stocks by sort column
+	gint result = strcmp (keys -> GetKey (model, a, aindex, sort -> column), keys -> GetKey (model, b, bindex, sort -> column));
+	if (result)
+		return result;
+
+	// Compare stocks by secondary column
+	gint column = keys -> secondary;
+	if (column != SORT_NONE && column != static_cast <gint> (sort -> column))
+	{
+		result = strcmp (keys -> GetKey (model, a, aindex, column), keys -> GetKey (model, b, bindex, column));
+		if (result)
+			return result;
+	}
+
+	// Keep order of equal stocks stable
+	return aindex < bindex ? -1 : aindex > bindex;
+}
+
+//****************************************************************************//
+//      Signal handler for "row-changed" signal of stock list                 //
+//****************************************************************************//
+void SortKeys::RowChanged (GtkTreeModel *model, GtkTreePath *path, GtkTreeIter *iter, gpointer data)
+{
+	// Get selection index of stock
+	guint index;
+	gtk_tree_model_get (model, iter, STOCK_INDEX_ID, &index, -1);
+
+	// Drop keys of changed row
+	reinterpret_cast <SortKeys*> (data) -> Invalidate (index);
+}
+
+//****************************************************************************//
+//      Attach sort keys to stock list                                        //
+//****************************************************************************//
+void SortKeys::Attach (GtkListStore *list)
+{
+	// Sort text columns by collation keys
+	for (guint i = 0; i < SORT_COLUMNS; i++)
+		gtk_tree_sortable_set_sort_func (GTK_TREE_SORTABLE (list), i, Compare, &columns [i], NULL);
+
+	// Drop keys of changed rows
+	g_signal_connect (G_OBJECT (list), "row-changed", G_CALLBACK (RowChanged), this);
+
+	// Stock list frees sort keys with itself
+	g_object_set_data_full (G_OBJECT (list), SORT_KEYS_DATA, this, FreeSortKeys);
+}
+
+//****************************************************************************//
+//      Drop keys of changed row                                              //
+//****************************************************************************//
+void SortKeys::Invalidate (guint index)
+{
+	// Free keys of row in all columns
+	for (guint i = 0; i < SORT_COLUMNS; i++)
+	{
+		GPtrArray *array = keys [i];
+		if (index < array -> len)
+		{
+			g_free (g_ptr_array_index (array, index));
+			g_ptr_array_index (array, index) = NULL;
+		}
+	}
+}
+
+//****************************************************************************//
+//      Drop keys of row which is going to be changed                         //
+//****************************************************************************//
+void SortKeys::Invalidate (GtkTreeModel *model, GtkTreeIter *iter)
+{
+	// Get sort keys of stock list
+	SortKeys *keys = reinterpret_cast <SortKeys*> (g_object_get_data (G_OBJECT (model), SORT_KEYS_DATA));
+	if (keys)
+	{
+		// Get selection index of stock
+		guint index;
+		gtk_tree_model_get (model, iter, STOCK_INDEX_ID, &index, -1);
+
+		// Drop keys of row
+		keys -> Invalidate (index);
+	}
+}
+
+//****************************************************************************//
+//      Set secondary sort column                                             //
+//****************************************************************************//
+void SortKeys::SetSecondary (gint column)
+{
+	secondary = column >= 0 && column < SORT_COLUMNS ? column : SORT_NONE;
+}
+/*
+################################################################################
+#                                 END OF FILE                                  #
+################################################################################
+*/
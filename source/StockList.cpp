@@ -9,17 +9,23 @@
 */
 # include	<Common.h>
 # include	<Stocks.h>
+# include	<SortKeys.h>
+# include	<SearchIndex.h>
+# include	<Facets.h>
 # include	<Quotes.h>
 # include	<StockList.h>
 # include	<QuoteList.h>
 # include	<CheckList.h>
 # include	<SyncList.h>
 # include	<AnalyzeList.h>
+# include	<Client.h>
+# include	<LocalProvider.h>
 
 //****************************************************************************//
 //      Internal constants                                                    //
 //****************************************************************************//
 # define	ENTRY_MAX_CHARS		60			// Max length of text entry
+# define	FIND_RESPONSE_NEXT	1			// Response id of "Next" button of find dialog
 
 //============================================================================//
 //      Quotes count range                                                    //
@@ -126,6 +132,8 @@ const gchar* StocksMenuOpenClose[] = {
 	MENU_STOCKS_INFO,
 	MENU_STOCKS_CHECK,
 	MENU_STOCKS_SYNC,
+	MENU_STOCKS_SYNC_LOCAL,
+	MENU_STOCKS_BULK_IMPORT,
 	MENU_STOCKS_ANALYZE
 };
 const gchar* QuotesMenuOpenClose[] = {
@@ -636,6 +644,9 @@ static gboolean OpenStocks (void)
 			ShowFileErrorMessage (GTK_WINDOW (dialog), "Can not open stock list", error);
 		else
 		{
+			// Remove staged quote files left by interrupted sync
+			RemoveStagedLists (path);
+
 			// Extract file name from path
 			gchar *fname = g_filename_display_basename (path);
 
@@ -1409,9 +1420,7 @@ static gboolean InsertStock (void)
 			else
 			{
 				// Add new element to list store object
-				GtkTreeIter iter;
-				gtk_list_store_append (GTK_LIST_STORE (model), &iter);
-				gtk_list_store_set (GTK_LIST_STORE (model), &iter, STOCK_TICKER_ID, upper, STOCK_NAME_ID, name, STOCK_COUNTRY_ID, country, STOCK_SECTOR_ID, sector, STOCK_INDUSTRY_ID, industry, STOCK_URL_ID, url, STOCK_CHECK_ID, FALSE, -1);
+				gtk_list_store_insert_with_values (GTK_LIST_STORE (model), NULL, -1, STOCK_TICKER_ID, upper, STOCK_NAME_ID, name, STOCK_COUNTRY_ID, country, STOCK_SECTOR_ID, sector, STOCK_INDUSTRY_ID, industry, STOCK_URL_ID, url, STOCK_INDEX_ID, stocks.GetSelection () -> Append (), -1);
 
 				// Change save state
 				ChangeSaveState (FALSE);
@@ -1462,13 +1471,16 @@ static gboolean RemoveStocks (void)
 
 			// Iterate through all elements
 			do {
-				// Get mark state
-				gboolean state;
-				gtk_tree_model_get (GTK_TREE_MODEL (model), &iter, STOCK_CHECK_ID, &state, -1);
+				// Get selection index
+				guint index;
+				gtk_tree_model_get (GTK_TREE_MODEL (model), &iter, STOCK_INDEX_ID, &index, -1);
 
 				// Check mark state
-				if (state)
+				if (stocks.GetSelection () -> Get (index))
 				{
+					// Remove stock from selection
+					stocks.GetSelection () -> Remove (index);
+
 					// If stock is marked, then remove it
 					flag = gtk_list_store_remove (GTK_LIST_STORE (model), &iter);
 
@@ -1507,36 +1519,17 @@ static gboolean SelectAllStocks (void)
 	gboolean status = FALSE;
 
 	// Get tree model object from tree view
-	GtkTreeSortable *model = GTK_TREE_SORTABLE (gtk_tree_view_get_model (GTK_TREE_VIEW (treeview)));
+	GtkTreeModel *model = gtk_tree_view_get_model (GTK_TREE_VIEW (treeview));
 	if (model)
 	{
-		// Get current sort order
-		gint id;
-		GtkSortType order;
-		gboolean issorted = gtk_tree_sortable_get_sort_column_id (GTK_TREE_SORTABLE (model), &id, &order);
+		// Set mark state of all stocks
+		stocks.GetSelection () -> SelectAll ();
 
-		// Change sort column
-		gtk_tree_sortable_set_sort_column_id (GTK_TREE_SORTABLE (model), STOCK_URL_ID, GTK_SORT_ASCENDING);
+		// Redraw stock list
+		RedrawStocks ();
 
-		// Get iterator position
-		GtkTreeIter iter;
-		if (gtk_tree_model_get_iter_first (GTK_TREE_MODEL (model), &iter))
-		{
-			// Iterate through all elements
-			do {
-				// Set mark state
-				gtk_list_store_set (GTK_LIST_STORE (model), &iter, STOCK_CHECK_ID, TRUE, -1);
-
-				// Change iterator position to next element
-			} while (gtk_tree_model_iter_next (GTK_TREE_MODEL (model), &iter));
-
-			// Set success state
-			status = TRUE;
-		}
-
-		// If stocks were sorted, then restore their sort order
-		if (issorted)
-			gtk_tree_sortable_set_sort_column_id (GTK_TREE_SORTABLE (model), id, order);
+		// Set success state
+		status = TRUE;
 	}
 
 	// Return operation status
@@ -1552,40 +1545,17 @@ static gboolean InvertSelection (void)
 	gboolean status = FALSE;
 
 	// Get tree model object from tree view
-	GtkTreeSortable *model = GTK_TREE_SORTABLE (gtk_tree_view_get_model (GTK_TREE_VIEW (treeview)));
+	GtkTreeModel *model = gtk_tree_view_get_model (GTK_TREE_VIEW (treeview));
 	if (model)
 	{
-		// Get current sort order
-		gint id;
-		GtkSortType order;
-		gboolean issorted = gtk_tree_sortable_get_sort_column_id (GTK_TREE_SORTABLE (model), &id, &order);
+		// Switch mark state of all stocks
+		stocks.GetSelection () -> Invert ();
 
-		// Change sort column
-		gtk_tree_sortable_set_sort_column_id (GTK_TREE_SORTABLE (model), STOCK_URL_ID, GTK_SORT_ASCENDING);
+		// Redraw stock list
+		RedrawStocks ();
 
-		// Get iterator position
-		GtkTreeIter iter;
-		if (gtk_tree_model_get_iter_first (GTK_TREE_MODEL (model), &iter))
-		{
-			// Iterate through all elements
-			do {
-				// Get old state
-				gboolean state;
-				gtk_tree_model_get (GTK_TREE_MODEL (model), &iter, STOCK_CHECK_ID, &state, -1);
-
-				// Switch mark state
-				gtk_list_store_set (GTK_LIST_STORE (model), &iter, STOCK_CHECK_ID, !state, -1);
-
-				// Change iterator position to next element
-			} while (gtk_tree_model_iter_next (GTK_TREE_MODEL (model), &iter));
-
-			// Set success state
-			status = TRUE;
-		}
-
-		// If stocks were sorted, then restore their sort order
-		if (issorted)
-			gtk_tree_sortable_set_sort_column_id (GTK_TREE_SORTABLE (model), id, order);
+		// Set success state
+		status = TRUE;
 	}
 
 	// Return operation status
@@ -1601,7 +1571,80 @@ gboolean UnselectAllStocks (void)
 	gboolean status = FALSE;
 
 	// Get tree model object from tree view
-	GtkTreeSortable *model = GTK_TREE_SORTABLE (gtk_tree_view_get_model (GTK_TREE_VIEW (treeview)));
+	GtkTreeModel *model = gtk_tree_view_get_model (GTK_TREE_VIEW (treeview));
+	if (model)
+	{
+		// Clear mark state of all stocks
+		stocks.GetSelection () -> UnselectAll ();
+
+		// Redraw stock list
+		RedrawStocks ();
+
+		// Set success state
+		status = TRUE;
+	}
+
+	// Return operation status
+	return status;
+}
+
+//****************************************************************************//
+//      Get mark state of stock                                               //
+//****************************************************************************//
+gboolean GetStockState (GtkTreeModel *model, GtkTreeIter *iter)
+{
+	// Get selection index
+	guint index;
+	gtk_tree_model_get (GTK_TREE_MODEL (model), iter, STOCK_INDEX_ID, &index, -1);
+
+	// Return mark state
+	return stocks.GetSelection () -> Get (index);
+}
+
+//****************************************************************************//
+//      Set mark state of stock                                               //
+//****************************************************************************//
+void SetStockState (GtkTreeModel *model, GtkTreeIter *iter, gboolean state)
+{
+	// Get selection index
+	guint index;
+	gtk_tree_model_get (GTK_TREE_MODEL (model), iter, STOCK_INDEX_ID, &index, -1);
+
+	// Set mark state
+	stocks.GetSelection () -> Set (index, state);
+}
+
+//****************************************************************************//
+//      Get mark state of stock by its selection index                        //
+//****************************************************************************//
+gboolean IsStockMarked (guint index)
+{
+	return stocks.GetSelection () -> Get (index);
+}
+
+//****************************************************************************//
+//      Set mark state of stock by its selection index                        //
+//****************************************************************************//
+void MarkStock (guint index, gboolean state)
+{
+	stocks.GetSelection () -> Set (index, state);
+}
+
+//****************************************************************************//
+//      Get count of selected stocks                                          //
+//****************************************************************************//
+gint GetSelectedCount (void)
+{
+	return stocks.GetSelection () -> GetCount ();
+}
+
+//****************************************************************************//
+//      Redraw stock list after batch change of mark states                   //
+//****************************************************************************//
+void RedrawStocks (void)
+{
+	// Get tree model object from tree view
+	GtkTreeModel *model = gtk_tree_view_get_model (GTK_TREE_VIEW (treeview));
 	if (model)
 	{
 		// Get current sort order
@@ -1609,32 +1652,111 @@ gboolean UnselectAllStocks (void)
 		GtkSortType order;
 		gboolean issorted = gtk_tree_sortable_get_sort_column_id (GTK_TREE_SORTABLE (model), &id, &order);
 
-		// Change sort column
-		gtk_tree_sortable_set_sort_column_id (GTK_TREE_SORTABLE (model), STOCK_URL_ID, GTK_SORT_ASCENDING);
+		// If stocks were sorted by mark state, then switch sort column to restore
+		// their sort order. Other sort columns do not depend on mark states
+		if (issorted && id == STOCK_INDEX_ID)
+		{
+			gtk_tree_sortable_set_sort_column_id (GTK_TREE_SORTABLE (model), STOCK_URL_ID, GTK_SORT_ASCENDING);
+			gtk_tree_sortable_set_sort_column_id (GTK_TREE_SORTABLE (model), id, order);
+		}
+	}
+
+	// Redraw stock list
+	gtk_widget_queue_draw (GTK_WIDGET (treeview));
+}
+
+//****************************************************************************//
+//      Find dialog data structure                                            //
+//****************************************************************************//
+struct FindData
+{
+	SearchIndex	*index;			// Search index of stock list
+	GtkWidget	*FindBox;		// Search field combo box
+	GtkWidget	*PatternEntry;	// Pattern text entry
+	GtkWidget	*MatchLabel;	// Count of found stocks label
+};
+
+//****************************************************************************//
+//      Find stocks by current dialog values                                  //
+//****************************************************************************//
+static guint FindMatches (FindData *data)
+{
+	// Get search field id
+	gint id = gtk_combo_box_get_active (GTK_COMBO_BOX (data -> FindBox));
+
+	// Get pattern value
+	const gchar *pattern = gtk_entry_get_text (GTK_ENTRY (data -> PatternEntry));
+
+	// Nothing is found if search field is not set or pattern value is empty
+	if (id == -1 || !g_utf8_strlen (pattern, -1))
+	{
+		data -> index -> Clear ();
+		return 0;
+	}
+
+	// Find stocks by pattern
+	return data -> index -> Find (id, pattern);
+}
+
+//****************************************************************************//
+//      Signal handler for "changed" signal of find dialog fields             //
+//****************************************************************************//
+static void FindChanged (GtkWidget *widget, gpointer data)
+{
+	// Convert data pointer
+	FindData *find = reinterpret_cast <FindData*> (data);
+
+	// Find stocks as pattern is typed
+	guint count = FindMatches (find);
+
+	// Show count of found stocks
+	gchar *text = g_strdup_printf ("%u", count);
+	gtk_label_set_text (GTK_LABEL (find -> MatchLabel), text);
+	g_free (text);
+}
+
+//****************************************************************************//
+//      Move cursor to next found stock                                       //
+//****************************************************************************//
+static void FindNext (GtkTreeModel *model, SearchIndex *index)
+{
+	// Get count of rows in stock list
+	gint rows = gtk_tree_model_iter_n_children (model, NULL);
+
+	// Get row of cursor position
+	gint start = -1;
+	GtkTreePath *path;
+	gtk_tree_view_get_cursor (GTK_TREE_VIEW (treeview), &path, NULL);
+	if (path)
+	{
+		start = gtk_tree_path_get_indices (path)[0];
+		gtk_tree_path_free (path);
+	}
 
+	// Check all rows after cursor with wrap around
+	for (gint i = 1; i <= rows; i++)
+	{
 		// Get iterator position
 		GtkTreeIter iter;
-		if (gtk_tree_model_get_iter_first (GTK_TREE_MODEL (model), &iter))
+		gint row = (start + i) % rows;
+		if (gtk_tree_model_iter_nth_child (model, &iter, NULL, row))
 		{
-			// Iterate through all elements
-			do {
-				// Clear mark state
-				gtk_list_store_set (GTK_LIST_STORE (model), &iter, STOCK_CHECK_ID, FALSE, -1);
+			// Get selection index
+			guint sindex;
+			gtk_tree_model_get (model, &iter, STOCK_INDEX_ID, &sindex, -1);
 
-				// Change iterator position to next element
-			} while (gtk_tree_model_iter_next (GTK_TREE_MODEL (model), &iter));
-
-			// Set success state
-			status = TRUE;
+			// Check if stock was found
+			if (index -> IsMatch (sindex))
+			{
+				// Move cursor to found stock and show it
+				path = gtk_tree_model_get_path (model, &iter);
+				gtk_tree_view_set_cursor (GTK_TREE_VIEW (treeview), path, NULL, FALSE);
+				gtk_tree_view_scroll_to_cell (GTK_TREE_VIEW (treeview), path, NULL, FALSE, 0, 0);
+				gtk_tree_path_free (path);
+				break;
+			}
 		}
-
-		// If stocks were sorted, then restore their sort order
-		if (issorted)
-			gtk_tree_sortable_set_sort_column_id (GTK_TREE_SORTABLE (model), id, order);
 	}
-
-	// Return operation status
-	return status;
 }
 
 //****************************************************************************//
@@ -1649,8 +1771,11 @@ static gboolean FindStocks (void)
 	GtkTreeSortable *model = GTK_TREE_SORTABLE (gtk_tree_view_get_model (GTK_TREE_VIEW (treeview)));
 	if (model)
 	{
+		// Get search index of stock list
+		SearchIndex *index = reinterpret_cast <SearchIndex*> (g_object_get_data (G_OBJECT (model), SEARCH_INDEX_DATA));
+
 		// Create dialog window
-		GtkWidget *dialog = gtk_dialog_new_with_buttons ("Find", GTK_WINDOW (window), GTK_DIALOG_MODAL, "_Cancel", GTK_RESPONSE_CANCEL, "_Find", GTK_RESPONSE_ACCEPT, NULL);
+		GtkWidget *dialog = gtk_dialog_new_with_buttons ("Find", GTK_WINDOW (window), GTK_DIALOG_MODAL, "_Cancel", GTK_RESPONSE_CANCEL, "_Next", FIND_RESPONSE_NEXT, "_Find", GTK_RESPONSE_ACCEPT, NULL);
 
 		// Get content area of dialog
 		GtkWidget *box = gtk_dialog_get_content_area (GTK_DIALOG (dialog));
@@ -1667,6 +1792,8 @@ static gboolean FindStocks (void)
 		// Create label fields
 		GtkWidget *FindLabel = gtk_label_new ("Search by");
 		GtkWidget *PatternLabel = gtk_label_new ("Pattern");
+		GtkWidget *CountLabel = gtk_label_new ("Found");
+		GtkWidget *MatchLabel = gtk_label_new ("0");
 
 		// Create combo box
 		GtkWidget *FindBox = gtk_combo_box_text_new ();
@@ -1684,6 +1811,8 @@ static gboolean FindStocks (void)
 		// Add labels to grid
 		gtk_grid_attach (GTK_GRID (grid), GTK_WIDGET (FindLabel), 0, 0, 1, 1);
 		gtk_grid_attach (GTK_GRID (grid), GTK_WIDGET (PatternLabel), 0, 1, 1, 1);
+		gtk_grid_attach (GTK_GRID (grid), GTK_WIDGET (CountLabel), 0, 2, 1, 1);
+		gtk_grid_attach (GTK_GRID (grid), GTK_WIDGET (MatchLabel), 1, 2, 1, 1);
 
 		// Add combo box to grid
 		gtk_grid_attach (GTK_GRID (grid), GTK_WIDGET (FindBox), 1, 0, 1, 1);
@@ -1704,10 +1833,16 @@ static gboolean FindStocks (void)
 		// Set label properties
 		gtk_label_set_selectable (GTK_LABEL (FindLabel), FALSE);
 		gtk_label_set_selectable (GTK_LABEL (PatternLabel), FALSE);
+		gtk_label_set_selectable (GTK_LABEL (CountLabel), FALSE);
+		gtk_label_set_selectable (GTK_LABEL (MatchLabel), FALSE);
 		gtk_label_set_single_line_mode (GTK_LABEL (FindLabel), TRUE);
 		gtk_label_set_single_line_mode (GTK_LABEL (PatternLabel), TRUE);
+		gtk_label_set_single_line_mode (GTK_LABEL (CountLabel), TRUE);
+		gtk_label_set_single_line_mode (GTK_LABEL (MatchLabel), TRUE);
 		gtk_widget_set_halign (GTK_WIDGET (FindLabel), GTK_ALIGN_END);
 		gtk_widget_set_halign (GTK_WIDGET (PatternLabel), GTK_ALIGN_END);
+		gtk_widget_set_halign (GTK_WIDGET (CountLabel), GTK_ALIGN_END);
+		gtk_widget_set_halign (GTK_WIDGET (MatchLabel), GTK_ALIGN_START);
 
 		// Set combo box properties
 		gtk_combo_box_set_button_sensitivity (GTK_COMBO_BOX (FindBox), GTK_SENSITIVITY_AUTO);
@@ -1729,11 +1864,21 @@ static gboolean FindStocks (void)
 		// Set default dialog button
 		gtk_dialog_set_default_response (GTK_DIALOG (dialog), GTK_RESPONSE_ACCEPT);
 
+		// Find stocks as pattern is typed
+		FindData data = {index, FindBox, PatternEntry, MatchLabel};
+		g_signal_connect (G_OBJECT (FindBox), "changed", G_CALLBACK (FindChanged), &data);
+		g_signal_connect (G_OBJECT (PatternEntry), "changed", G_CALLBACK (FindChanged), &data);
+
 		// Show all box elements
 		gtk_widget_show_all (GTK_WIDGET (box));
 
-		// Run dialog window
-		if (gtk_dialog_run (GTK_DIALOG (dialog)) == GTK_RESPONSE_ACCEPT)
+		// Run dialog window until it is closed
+		gint response;
+		while ((response = gtk_dialog_run (GTK_DIALOG (dialog))) == FIND_RESPONSE_NEXT)
+			FindNext (GTK_TREE_MODEL (model), index);
+
+		// Check if find button was pressed
+		if (response == GTK_RESPONSE_ACCEPT)
 		{
 			// Get search field id
 			gint id = gtk_combo_box_get_active (GTK_COMBO_BOX (FindBox));
@@ -1745,62 +1890,29 @@ static gboolean FindStocks (void)
 				// Check if pattern value is not empty
 				if (g_utf8_strlen (pattern, -1))
 				{
-					// Convert pattern value to case independent representation
-					gchar *ipattern = g_utf8_casefold (pattern, -1);
-
-					// Create glob-style pattern object
-					GPatternSpec *gpattern = g_pattern_spec_new (ipattern);
+					// Find stocks by pattern
+					FindMatches (&data);
 
 					// Change sort column
 					gtk_tree_sortable_set_sort_column_id (GTK_TREE_SORTABLE (model), STOCK_URL_ID, GTK_SORT_ASCENDING);
 
-					// Get iterator position
-					GtkTreeIter iter;
-					if (gtk_tree_model_get_iter_first (GTK_TREE_MODEL (model), &iter))
-					{
-						// Iterate through all elements
-						do {
-							// Get required stock field
-							gchar *value;
-							gtk_tree_model_get (GTK_TREE_MODEL (model), &iter, id, &value, -1);
-
-							// Convert field value to case independent representation
-							gchar *ivalue = g_utf8_casefold (value, -1);
-
-							// Check if value has required substring pattern
-							if (g_pattern_match_string (gpattern, ivalue))
-							{
-								// Set mark state
-								gtk_list_store_set (GTK_LIST_STORE (model), &iter, STOCK_CHECK_ID, TRUE, -1);
-							}
-							else
-							{
-								// Clear mark state
-								gtk_list_store_set (GTK_LIST_STORE (model), &iter, STOCK_CHECK_ID, FALSE, -1);
-							}
-
-							// Free temporary string buffers
-							g_free (value);
-							g_free (ivalue);
-
-							// Change iterator position to next element
-						} while (gtk_tree_model_iter_next (GTK_TREE_MODEL (model), &iter));
-
-						// Set search column for immediate search
-						gtk_tree_view_set_search_column (GTK_TREE_VIEW (treeview), id);
-
-						// Move found stocks on top of stock list
-						gtk_tree_sortable_set_sort_column_id (GTK_TREE_SORTABLE (model), STOCK_CHECK_ID, GTK_SORT_DESCENDING);
-
-						// Set success state
-						status = TRUE;
-					}
+					// Set mark state of found stocks only
+					const GArray *matches = index -> GetMatches ();
+					stocks.GetSelection () -> UnselectAll ();
+					for (guint i = 0; i < matches -> len; i++)
+						stocks.GetSelection () -> Set (g_array_index (matches, guint, i), TRUE);
+
+					// Set search column for immediate search
+					gtk_tree_view_set_search_column (GTK_TREE_VIEW (treeview), id);
 
-					// Free temporary string buffer
-					g_free (ipattern);
+					// Move found stocks on top of stock list
+					gtk_tree_sortable_set_sort_column_id (GTK_TREE_SORTABLE (model), STOCK_INDEX_ID, GTK_SORT_DESCENDING);
 
-					// Free glob-style pattern object
-					g_pattern_spec_free (gpattern);
+					// Redraw stock list
+					RedrawStocks ();
+
+					// Set success state
+					status = TRUE;
 				}
 			}
 		}
@@ -1813,6 +1925,195 @@ static gboolean FindStocks (void)
 	return status;
 }
 
+//****************************************************************************//
+//      Facets dialog data structure                                          //
+//****************************************************************************//
+struct FacetsData
+{
+	Facets		*facets;						// Facets of stock list
+	GtkWidget	*boxes [FACET_COLUMNS];			// Facet value combo boxes
+	GtkWidget	*MatchLabel;					// Count of found stocks label
+};
+
+//****************************************************************************//
+//      Find stocks by current facet values of dialog                         //
+//****************************************************************************//
+static guint FindFacets (FacetsData *data)
+{
+	// Get required facet values
+	const gchar *names [FACET_COLUMNS];
+	for (guint i = 0; i < FACET_COLUMNS; i++)
+	{
+		// First option matches any value
+		gint active = gtk_combo_box_get_active (GTK_COMBO_BOX (data -> boxes [i]));
+		if (active > 0)
+		{
+			const GPtrArray *values = data -> facets -> GetValues (i);
+			names [i] = reinterpret_cast <FacetValue*> (g_ptr_array_index (values, active - 1)) -> name;
+		}
+		else
+			names [i] = NULL;
+	}
+
+	// Intersect bitsets of facet values
+	return data -> facets -> Intersect (names);
+}
+
+//****************************************************************************//
+//      Signal handler for "changed" signal of facets dialog fields           //
+//****************************************************************************//
+static void FacetsChanged (GtkWidget *widget, gpointer data)
+{
+	// Convert data pointer
+	FacetsData *facets = reinterpret_cast <FacetsData*> (data);
+
+	// Find stocks as facet values are chosen
+	guint count = FindFacets (facets);
+
+	// Show count of found stocks
+	gchar *text = g_strdup_printf ("%u", count);
+	gtk_label_set_text (GTK_LABEL (facets -> MatchLabel), text);
+	g_free (text);
+}
+
+//****************************************************************************//
+//      Signal handler for "Facets" menu button                               //
+//****************************************************************************//
+static gboolean FacetStocks (void)
+{
+	// Operation status
+	gboolean status = FALSE;
+
+	// Get tree model object from tree view
+	GtkTreeSortable *model = GTK_TREE_SORTABLE (gtk_tree_view_get_model (GTK_TREE_VIEW (treeview)));
+	if (model)
+	{
+		// Get facets of stock list
+		Facets *facets = reinterpret_cast <Facets*> (g_object_get_data (G_OBJECT (model), FACETS_DATA));
+
+		// Create dialog window
+		GtkWidget *dialog = gtk_dialog_new_with_buttons ("Facets", GTK_WINDOW (window), GTK_DIALOG_MODAL, "_Cancel", GTK_RESPONSE_CANCEL, "_Select", GTK_RESPONSE_ACCEPT, NULL);
+
+		// Get content area of dialog
+		GtkWidget *box = gtk_dialog_get_content_area (GTK_DIALOG (dialog));
+
+		// Get action area of dialog
+		GtkWidget *action = gtk_dialog_get_action_area (GTK_DIALOG (dialog));
+
+		// Create alignment
+		GtkWidget *alignment = gtk_alignment_new (0, 0, 1, 1);
+
+		// Create grid
+		GtkWidget *grid = gtk_grid_new ();
+
+		// Create label fields
+		const gchar *labels [FACET_COLUMNS] = {STOCK_COUNTRY_LABEL, STOCK_SECTOR_LABEL, STOCK_INDUSTRY_LABEL};
+		GtkWidget *CountLabel = gtk_label_new ("Found");
+		GtkWidget *MatchLabel = gtk_label_new ("0");
+
+		// Create facet value combo boxes
+		FacetsData data;
+		data.facets = facets;
+		data.MatchLabel = MatchLabel;
+		for (guint i = 0; i < FACET_COLUMNS; i++)
+		{
+			// Create label and combo box
+			GtkWidget *label = gtk_label_new (labels [i]);
+			data.boxes [i] = gtk_combo_box_text_new ();
+
+			// Add options to combo box with count of stocks which have the value
+			const GPtrArray *values = facets -> GetValues (i);
+			gtk_combo_box_text_append_text (GTK_COMBO_BOX_TEXT (data.boxes [i]), "Any");
+			for (guint j = 0; j < values -> len; j++)
+			{
+				const FacetValue *value = reinterpret_cast <const FacetValue*> (g_ptr_array_index (values, j));
+				gchar *text = g_strdup_printf ("%s (%u)", value -> name, value -> count);
+				gtk_combo_box_text_append_text (GTK_COMBO_BOX_TEXT (data.boxes [i]), text);
+				g_free (text);
+			}
+
+			// Add label and combo box to grid
+			gtk_grid_attach (GTK_GRID (grid), GTK_WIDGET (label), 0, i, 1, 1);
+			gtk_grid_attach (GTK_GRID (grid), GTK_WIDGET (data.boxes [i]), 1, i, 1, 1);
+
+			// Set label properties
+			gtk_label_set_selectable (GTK_LABEL (label), FALSE);
+			gtk_label_set_single_line_mode (GTK_LABEL (label), TRUE);
+			gtk_widget_set_halign (GTK_WIDGET (label), GTK_ALIGN_END);
+
+			// Set combo box properties
+			gtk_combo_box_set_button_sensitivity (GTK_COMBO_BOX (data.boxes [i]), GTK_SENSITIVITY_AUTO);
+			gtk_combo_box_set_active (GTK_COMBO_BOX (data.boxes [i]), 0);
+			gtk_combo_box_set_popup_fixed_width (GTK_COMBO_BOX (data.boxes [i]), TRUE);
+			gtk_widget_set_hexpand (GTK_WIDGET (data.boxes [i]), TRUE);
+			gtk_widget_set_tooltip_text (GTK_WIDGET (data.boxes [i]), "Required field value and count of stocks which have it");
+		}
+
+		// Add count labels to grid
+		gtk_grid_attach (GTK_GRID (grid), GTK_WIDGET (CountLabel), 0, FACET_COLUMNS, 1, 1);
+		gtk_grid_attach (GTK_GRID (grid), GTK_WIDGET (MatchLabel), 1, FACET_COLUMNS, 1, 1);
+
+		// Add grid to alignment
+		gtk_container_add (GTK_CONTAINER (alignment), grid);
+
+		// Add alignment to dialog content area
+		gtk_box_pack_start (GTK_BOX (box), GTK_WIDGET (alignment), TRUE, TRUE, 0);
+
+		// Set count label properties
+		gtk_label_set_selectable (GTK_LABEL (CountLabel), FALSE);
+		gtk_label_set_selectable (GTK_LABEL (MatchLabel), FALSE);
+		gtk_label_set_single_line_mode (GTK_LABEL (CountLabel), TRUE);
+		gtk_label_set_single_line_mode (GTK_LABEL (MatchLabel), TRUE);
+		gtk_widget_set_halign (GTK_WIDGET (CountLabel), GTK_ALIGN_END);
+		gtk_widget_set_halign (GTK_WIDGET (MatchLabel), GTK_ALIGN_START);
+
+		// Set grid properties
+		guint box_border = gtk_container_get_border_width (GTK_CONTAINER (box));
+		guint action_border = gtk_container_get_border_width (GTK_CONTAINER (action));
+		gtk_container_set_border_width (GTK_CONTAINER (grid), action_border);
+		gtk_grid_set_column_spacing (GTK_GRID (grid), box_border + action_border);
+
+		// Set default dialog button
+		gtk_dialog_set_default_response (GTK_DIALOG (dialog), GTK_RESPONSE_ACCEPT);
+
+		// Show count of found stocks as facet values are chosen
+		for (guint i = 0; i < FACET_COLUMNS; i++)
+			g_signal_connect (G_OBJECT (data.boxes [i]), "changed", G_CALLBACK (FacetsChanged), &data);
+		FacetsChanged (NULL, &data);
+
+		// Show all box elements
+		gtk_widget_show_all (GTK_WIDGET (box));
+
+		// Run dialog window
+		if (gtk_dialog_run (GTK_DIALOG (dialog)) == GTK_RESPONSE_ACCEPT)
+		{
+			// Find stocks by facet values
+			FindFacets (&data);
+
+			// Change sort column
+			gtk_tree_sortable_set_sort_column_id (GTK_TREE_SORTABLE (model), STOCK_URL_ID, GTK_SORT_ASCENDING);
+
+			// Set mark state of found stocks only
+			stocks.GetSelection () -> Assign (facets -> GetResult (), facets -> GetWords ());
+
+			// Move found stocks on top of stock list
+			gtk_tree_sortable_set_sort_column_id (GTK_TREE_SORTABLE (model), STOCK_INDEX_ID, GTK_SORT_DESCENDING);
+
+			// Redraw stock list
+			RedrawStocks ();
+
+			// Set success state
+			status = TRUE;
+		}
+
+		// Destroy dialog widget
+		gtk_widget_destroy (GTK_WIDGET (dialog));
+	}
+
+	// Return operation status
+	return status;
+}
+
 //****************************************************************************//
 //      Signal handler for "Sort" menu button                                 //
 //****************************************************************************//
@@ -1842,9 +2143,11 @@ static gboolean SortStocks (void)
 
 		// Create label fields
 		GtkWidget *SortLabel = gtk_label_new ("Sort stocks by");
+		GtkWidget *ThenLabel = gtk_label_new ("Then by");
 
-		// Create combo box
+		// Create combo boxes
 		GtkWidget *SortBox = gtk_combo_box_text_new ();
+		GtkWidget *ThenBox = gtk_combo_box_text_new ();
 
 		// Create radio buttons
 		GtkWidget *AscOrder = gtk_radio_button_new_with_label (NULL, "Ascending order");
@@ -1856,19 +2159,28 @@ static gboolean SortStocks (void)
 		gtk_combo_box_text_append_text (GTK_COMBO_BOX_TEXT (SortBox), STOCK_COUNTRY_LABEL);
 		gtk_combo_box_text_append_text (GTK_COMBO_BOX_TEXT (SortBox), STOCK_SECTOR_LABEL);
 		gtk_combo_box_text_append_text (GTK_COMBO_BOX_TEXT (SortBox), STOCK_INDUSTRY_LABEL);
+		gtk_combo_box_text_append_text (GTK_COMBO_BOX_TEXT (ThenBox), "None");
+		gtk_combo_box_text_append_text (GTK_COMBO_BOX_TEXT (ThenBox), STOCK_TICKER_LABEL);
+		gtk_combo_box_text_append_text (GTK_COMBO_BOX_TEXT (ThenBox), STOCK_NAME_LABEL);
+		gtk_combo_box_text_append_text (GTK_COMBO_BOX_TEXT (ThenBox), STOCK_COUNTRY_LABEL);
+		gtk_combo_box_text_append_text (GTK_COMBO_BOX_TEXT (ThenBox), STOCK_SECTOR_LABEL);
+		gtk_combo_box_text_append_text (GTK_COMBO_BOX_TEXT (ThenBox), STOCK_INDUSTRY_LABEL);
 
-		// Add label to grid
+		// Add labels to grid
 		gtk_grid_attach (GTK_GRID (grid), GTK_WIDGET (SortLabel), 0, 0, 1, 1);
+		gtk_grid_attach (GTK_GRID (grid), GTK_WIDGET (ThenLabel), 0, 1, 1, 1);
 
-		// Add combo box to grid
+		// Add combo boxes to grid
 		gtk_grid_attach (GTK_GRID (grid), GTK_WIDGET (SortBox), 1, 0, 1, 1);
+		gtk_grid_attach (GTK_GRID (grid), GTK_WIDGET (ThenBox), 1, 1, 1, 1);
 
 		// Add radio buttons to grid
-		gtk_grid_attach (GTK_GRID (grid), GTK_WIDGET (AscOrder), 0, 1, 2, 1);
-		gtk_grid_attach (GTK_GRID (grid), GTK_WIDGET (DscOrder), 0, 2, 2, 1);
+		gtk_grid_attach (GTK_GRID (grid), GTK_WIDGET (AscOrder), 0, 2, 2, 1);
+		gtk_grid_attach (GTK_GRID (grid), GTK_WIDGET (DscOrder), 0, 3, 2, 1);
 
-		// Add tooltip text to combo box and radio buttons
+		// Add tooltip text to combo boxes and radio buttons
 		gtk_widget_set_tooltip_text (GTK_WIDGET (SortBox), "Stock field to sort by");
+		gtk_widget_set_tooltip_text (GTK_WIDGET (ThenBox), "Stock field to sort stocks with equal first field");
 		gtk_widget_set_tooltip_text (GTK_WIDGET (AscOrder), "Sort stocks in ascending order");
 		gtk_widget_set_tooltip_text (GTK_WIDGET (DscOrder), "Sort stocks in descending order");
 
@@ -1882,12 +2194,19 @@ static gboolean SortStocks (void)
 		gtk_label_set_selectable (GTK_LABEL (SortLabel), FALSE);
 		gtk_label_set_single_line_mode (GTK_LABEL (SortLabel), TRUE);
 		gtk_widget_set_halign (GTK_WIDGET (SortLabel), GTK_ALIGN_END);
+		gtk_label_set_selectable (GTK_LABEL (ThenLabel), FALSE);
+		gtk_label_set_single_line_mode (GTK_LABEL (ThenLabel), TRUE);
+		gtk_widget_set_halign (GTK_WIDGET (ThenLabel), GTK_ALIGN_END);
 
 		// Set combo box properties
 		gtk_combo_box_set_button_sensitivity (GTK_COMBO_BOX (SortBox), GTK_SENSITIVITY_AUTO);
 		gtk_combo_box_set_active (GTK_COMBO_BOX (SortBox), STOCK_TICKER_ID);
 		gtk_combo_box_set_popup_fixed_width (GTK_COMBO_BOX (SortBox), TRUE);
 		gtk_widget_set_hexpand (GTK_WIDGET (SortBox), TRUE);
+		gtk_combo_box_set_button_sensitivity (GTK_COMBO_BOX (ThenBox), GTK_SENSITIVITY_AUTO);
+		gtk_combo_box_set_active (GTK_COMBO_BOX (ThenBox), 0);
+		gtk_combo_box_set_popup_fixed_width (GTK_COMBO_BOX (ThenBox), TRUE);
+		gtk_widget_set_hexpand (GTK_WIDGET (ThenBox), TRUE);
 
 		// Set grid properties
 		guint box_border = gtk_container_get_border_width (GTK_CONTAINER (box));
@@ -1913,6 +2232,17 @@ static gboolean SortStocks (void)
 				if (gtk_toggle_button_get_active (GTK_TOGGLE_BUTTON (DscOrder)))
 					order = GTK_SORT_DESCENDING;
 
+				// Set secondary sort field (first option is "None")
+				SortKeys *keys = reinterpret_cast <SortKeys*> (g_object_get_data (G_OBJECT (model), SORT_KEYS_DATA));
+				if (keys)
+				{
+					// Change secondary sort field
+					keys -> SetSecondary (gtk_combo_box_get_active (GTK_COMBO_BOX (ThenBox)) - 1);
+
+					// Drop current sort order, so stocks are sorted again even by the same field
+					gtk_tree_sortable_set_sort_column_id (GTK_TREE_SORTABLE (model), GTK_TREE_SORTABLE_UNSORTED_SORT_COLUMN_ID, order);
+				}
+
 				// Set search column for immediate search
 				gtk_tree_view_set_search_column (GTK_TREE_VIEW (treeview), id);
 
@@ -2310,8 +2640,8 @@ static gboolean CheckStocks (void)
 			AskToSaveStockList ();
 		else
 		{
-			// Run check quotes dialog
-			status = CheckQuotesDialog (GTK_WINDOW (window), GTK_TREE_MODEL (model), file_name);
+			// Run check quotes dialog which validates mapped quote files
+			status = CheckQuotesDialog (GTK_WINDOW (window), GTK_TREE_MODEL (model), file_name, CHECK_MAPPED);
 		}
 	}
 
@@ -2336,8 +2666,142 @@ static gboolean SyncStocks (void)
 			AskToSaveStockList ();
 		else
 		{
+			// Create client object for quote server
+			Client client;
+
+			// Keep validators of server responses next to quote files
+			gchar *cache = GetQuotesPath (file_name, CLIENT_CACHE_FILE);
+			client.SetCacheFile (cache);
+			g_free (cache);
+
 			// Run sync quotes dialog
-			status = SyncQuotesDialog (GTK_WINDOW (window), GTK_TREE_MODEL (model), file_name, time_zone);
+			status = SyncQuotesDialog (GTK_WINDOW (window), GTK_TREE_MODEL (model), file_name, time_zone, &client);
+		}
+	}
+
+	// Return operation status
+	return status;
+}
+
+//****************************************************************************//
+//      Signal handler for "Sync from folder" menu button                     //
+//****************************************************************************//
+static gboolean SyncLocalStocks (void)
+{
+	// Operation status
+	gboolean status = FALSE;
+
+	// Get tree model object from tree view
+	GtkTreeModel *model = gtk_tree_view_get_model (GTK_TREE_VIEW (treeview));
+	if (model)
+	{
+		// Check if stock list is saved
+		if (file_name == NULL)
+			AskToSaveStockList ();
+		else
+		{
+			// Create file chooser dialog
+			GtkWidget *dialog = gtk_file_chooser_dialog_new ("Sync quotes from folder...", GTK_WINDOW (window), GTK_FILE_CHOOSER_ACTION_SELECT_FOLDER, "_Cancel", GTK_RESPONSE_CANCEL, "_Sync", GTK_RESPONSE_ACCEPT, NULL);
+
+			// Set file chooser properties
+			gtk_file_chooser_set_show_hidden (GTK_FILE_CHOOSER (dialog), FALSE);
+			gtk_file_chooser_set_local_only (GTK_FILE_CHOOSER (dialog), TRUE);
+			gtk_file_chooser_set_select_multiple (GTK_FILE_CHOOSER (dialog), FALSE);
+
+			// Set default dialog button
+			gtk_dialog_set_default_response (GTK_DIALOG (dialog), GTK_RESPONSE_ACCEPT);
+
+			// Run dialog window
+			if (gtk_dialog_run (GTK_DIALOG (dialog)) == GTK_RESPONSE_ACCEPT)
+			{
+				// Get chosen folder name
+				gchar *path = gtk_file_chooser_get_filename (GTK_FILE_CHOOSER (dialog));
+
+				// Destroy dialog widget
+				gtk_widget_destroy (GTK_WIDGET (dialog));
+
+				// Create local provider for quotes folder
+				LocalProvider provider;
+				provider.SetPath (path);
+
+				// Run sync quotes dialog
+				status = SyncQuotesDialog (GTK_WINDOW (window), GTK_TREE_MODEL (model), file_name, time_zone, &provider);
+
+				// Free temporary string buffer
+				g_free (path);
+			}
+			else
+			{
+				// Destroy dialog widget
+				gtk_widget_destroy (GTK_WIDGET (dialog));
+			}
+		}
+	}
+
+	// Return operation status
+	return status;
+}
+
+//****************************************************************************//
+//      Signal handler for "Bulk import" menu button                          //
+//****************************************************************************//
+static gboolean BulkImportStocks (void)
+{
+	// Operation status
+	gboolean status = FALSE;
+
+	// Get tree model object from tree view
+	GtkTreeModel *model = gtk_tree_view_get_model (GTK_TREE_VIEW (treeview));
+	if (model)
+	{
+		// Check if stock list is saved
+		if (file_name == NULL)
+			AskToSaveStockList ();
+		else
+		{
+			// Create file chooser dialog
+			GtkWidget *dialog = gtk_file_chooser_dialog_new ("Import quotes of all stocks from...", GTK_WINDOW (window), GTK_FILE_CHOOSER_ACTION_OPEN, "_Cancel", GTK_RESPONSE_CANCEL, "_Import", GTK_RESPONSE_ACCEPT, NULL);
+
+			// Create file filter
+			GtkFileFilter *filter = gtk_file_filter_new ();
+			gtk_file_filter_add_pattern (GTK_FILE_FILTER (filter), "*.csv");
+			gtk_file_filter_add_pattern (GTK_FILE_FILTER (filter), "*.txt");
+
+			// Add file filter to file chooser
+			gtk_file_chooser_set_filter (GTK_FILE_CHOOSER (dialog), GTK_FILE_FILTER (filter));
+
+			// Set file chooser properties
+			gtk_file_chooser_set_show_hidden (GTK_FILE_CHOOSER (dialog), FALSE);
+			gtk_file_chooser_set_local_only (GTK_FILE_CHOOSER (dialog), TRUE);
+			gtk_file_chooser_set_select_multiple (GTK_FILE_CHOOSER (dialog), FALSE);
+
+			// Set default dialog button
+			gtk_dialog_set_default_response (GTK_DIALOG (dialog), GTK_RESPONSE_ACCEPT);
+
+			// Run dialog window
+			if (gtk_dialog_run (GTK_DIALOG (dialog)) == GTK_RESPONSE_ACCEPT)
+			{
+				// Get chosen file name
+				gchar *path = gtk_file_chooser_get_filename (GTK_FILE_CHOOSER (dialog));
+
+				// Destroy dialog widget
+				gtk_widget_destroy (GTK_WIDGET (dialog));
+
+				// Create local provider for bulk quotes file
+				LocalProvider provider;
+				provider.SetPath (path);
+
+				// Run sync quotes dialog
+				status = SyncQuotesDialog (GTK_WINDOW (window), GTK_TREE_MODEL (model), file_name, time_zone, &provider);
+
+				// Free temporary string buffer
+				g_free (path);
+			}
+			else
+			{
+				// Destroy dialog widget
+				gtk_widget_destroy (GTK_WIDGET (dialog));
+			}
 		}
 	}
 
@@ -2382,6 +2846,7 @@ static gboolean AnalyzeStocks (void)
 			GtkWidget *LiquidityLabel = gtk_label_new ("Min liquidity");
 			GtkWidget *VolatilityLabel = gtk_label_new ("Min volatility");
 			GtkWidget *PriceLabel = gtk_label_new ("Min price");
+			GtkWidget *FilterLabel = gtk_label_new ("Filter");
 
 			// Create spin buttons
 			GtkWidget *QuotesSpin = gtk_spin_button_new_with_range (QUOTES_MIN, QUOTES_MAX, QUOTES_STEP);
@@ -2389,11 +2854,15 @@ static gboolean AnalyzeStocks (void)
 			GtkWidget *VolatilitySpin = gtk_spin_button_new_with_range (VOLATILITY_MIN, VOLATILITY_MAX, VOLATILITY_STEP);
 			GtkWidget *PriceSpin = gtk_spin_button_new_with_range (PRICE_MIN, PRICE_MAX, PRICE_STEP);
 
+			// Create entry fields
+			GtkWidget *FilterEntry = gtk_entry_new ();
+
 			// Add labels to grid
 			gtk_grid_attach (GTK_GRID (grid), GTK_WIDGET (QuotesLabel), 0, 0, 1, 1);
 			gtk_grid_attach (GTK_GRID (grid), GTK_WIDGET (LiquidityLabel), 0, 1, 1, 1);
 			gtk_grid_attach (GTK_GRID (grid), GTK_WIDGET (VolatilityLabel), 0, 2, 1, 1);
 			gtk_grid_attach (GTK_GRID (grid), GTK_WIDGET (PriceLabel), 0, 3, 1, 1);
+			gtk_grid_attach (GTK_GRID (grid), GTK_WIDGET (FilterLabel), 0, 4, 1, 1);
 
 			// Add spin buttons to grid
 			gtk_grid_attach (GTK_GRID (grid), GTK_WIDGET (QuotesSpin), 1, 0, 1, 1);
@@ -2401,11 +2870,15 @@ static gboolean AnalyzeStocks (void)
 			gtk_grid_attach (GTK_GRID (grid), GTK_WIDGET (VolatilitySpin), 1, 2, 1, 1);
 			gtk_grid_attach (GTK_GRID (grid), GTK_WIDGET (PriceSpin), 1, 3, 1, 1);
 
+			// Add entry fields to grid
+			gtk_grid_attach (GTK_GRID (grid), GTK_WIDGET (FilterEntry), 1, 4, 1, 1);
+
 			// Add tooltip text to spin buttons
 			gtk_widget_set_tooltip_text (GTK_WIDGET (QuotesSpin), "Min count of quotes to analyze");
 			gtk_widget_set_tooltip_text (GTK_WIDGET (LiquiditySpin), "Min stock liquidity");
 			gtk_widget_set_tooltip_text (GTK_WIDGET (VolatilitySpin), "Min stock volatility");
 			gtk_widget_set_tooltip_text (GTK_WIDGET (PriceSpin), "Min stock price");
+			gtk_widget_set_tooltip_text (GTK_WIDGET (FilterEntry), "Extra filter expression, for example: atr_pct(20) > 2 && close > sma(50)");
 
 			// Add grid to alignment
 			gtk_container_add (GTK_CONTAINER (alignment), grid);
@@ -2418,14 +2891,17 @@ static gboolean AnalyzeStocks (void)
 			gtk_label_set_selectable (GTK_LABEL (LiquidityLabel), FALSE);
 			gtk_label_set_selectable (GTK_LABEL (VolatilityLabel), FALSE);
 			gtk_label_set_selectable (GTK_LABEL (PriceLabel), FALSE);
+			gtk_label_set_selectable (GTK_LABEL (FilterLabel), FALSE);
 			gtk_label_set_single_line_mode (GTK_LABEL (QuotesLabel), TRUE);
 			gtk_label_set_single_line_mode (GTK_LABEL (LiquidityLabel), TRUE);
 			gtk_label_set_single_line_mode (GTK_LABEL (VolatilityLabel), TRUE);
 			gtk_label_set_single_line_mode (GTK_LABEL (PriceLabel), TRUE);
+			gtk_label_set_single_line_mode (GTK_LABEL (FilterLabel), TRUE);
 			gtk_widget_set_halign (GTK_WIDGET (QuotesLabel), GTK_ALIGN_END);
 			gtk_widget_set_halign (GTK_WIDGET (LiquidityLabel), GTK_ALIGN_END);
 			gtk_widget_set_halign (GTK_WIDGET (VolatilityLabel), GTK_ALIGN_END);
 			gtk_widget_set_halign (GTK_WIDGET (PriceLabel), GTK_ALIGN_END);
+			gtk_widget_set_halign (GTK_WIDGET (FilterLabel), GTK_ALIGN_END);
 
 			// Set spin button properties
 			gtk_spin_button_set_value (GTK_SPIN_BUTTON (QuotesSpin), QUOTES_DEFAULT);
@@ -2461,6 +2937,11 @@ static gboolean AnalyzeStocks (void)
 			gtk_widget_set_hexpand (GTK_WIDGET (VolatilitySpin), TRUE);
 			gtk_widget_set_hexpand (GTK_WIDGET (PriceSpin), TRUE);
 
+			// Set entry field properties
+			gtk_entry_set_placeholder_text (GTK_ENTRY (FilterEntry), "Not obligatory");
+			gtk_entry_set_activates_default (GTK_ENTRY (FilterEntry), TRUE);
+			gtk_widget_set_hexpand (GTK_WIDGET (FilterEntry), TRUE);
+
 			// Set grid properties
 			guint box_border = gtk_container_get_border_width (GTK_CONTAINER (box));
 			guint action_border = gtk_container_get_border_width (GTK_CONTAINER (action));
@@ -2481,6 +2962,7 @@ static gboolean AnalyzeStocks (void)
 			gsize liquidity = gtk_spin_button_get_value_as_int (GTK_SPIN_BUTTON (LiquiditySpin));
 			gfloat volatility = gtk_spin_button_get_value (GTK_SPIN_BUTTON (VolatilitySpin));
 			gfloat price = gtk_spin_button_get_value (GTK_SPIN_BUTTON (PriceSpin));
+			gchar *custom = g_strstrip (g_strdup (gtk_entry_get_text (GTK_ENTRY (FilterEntry))));
 
 			// Destroy dialog widget
 			gtk_widget_destroy (GTK_WIDGET (dialog));
@@ -2488,9 +2970,42 @@ static gboolean AnalyzeStocks (void)
 			// Check if user chose to analyze stock list
 			if (response == GTK_RESPONSE_ACCEPT)
 			{
-				// Run analyze quotes dialog
-				status = AnalyzeQuotesDialog (GTK_WINDOW (window), GTK_TREE_MODEL (model), file_name, quotes, liquidity, volatility * 0.01, price);
+				// Convert float settings to locale independent strings
+				gchar vstr [G_ASCII_DTOSTR_BUF_SIZE];
+				gchar pstr [G_ASCII_DTOSTR_BUF_SIZE];
+				g_ascii_dtostr (vstr, sizeof (vstr), volatility);
+				g_ascii_dtostr (pstr, sizeof (pstr), price);
+
+				// Compose filter expression from stock filter settings
+				gchar *expression = g_strdup_printf ("count >= %i && median_vol(%i) >= %" G_GSIZE_FORMAT " && volatility(%i) >= %s && close >= %s", quotes, quotes, liquidity, quotes, vstr, pstr);
+
+				// Append custom filter expression
+				if (*custom)
+				{
+					gchar *temp = g_strdup_printf ("%s && (%s)", expression, custom);
+					g_free (expression);
+					expression = temp;
+				}
+
+				// Create error object
+				GError *error = NULL;
+
+				// Compile filter expression once for all stocks
+				Filter filter;
+				if (!filter.Compile (expression, &error))
+					ShowErrorMessage (GTK_WINDOW (window), "Incorrect filter expression", error);
+				else
+				{
+					// Run analyze quotes dialog
+					status = AnalyzeQuotesDialog (GTK_WINDOW (window), GTK_TREE_MODEL (model), file_name, quotes, &filter);
+				}
+
+				// Free temporary string buffer
+				g_free (expression);
 			}
+
+			// Free temporary string buffer
+			g_free (custom);
 		}
 	}
 
@@ -2633,6 +3148,15 @@ static void ColumnHandler (GtkTreeViewColumn *column, gpointer data)
 	gtk_tree_view_set_search_column (GTK_TREE_VIEW (treeview), GPOINTER_TO_UINT (data));
 }
 
+//****************************************************************************//
+//      Render function for "Check" cell                                      //
+//****************************************************************************//
+static void CheckRenderFunc (GtkTreeViewColumn *column, GtkCellRenderer *cell, GtkTreeModel *model, GtkTreeIter *iter, gpointer data)
+{
+	// Set check button state from stock selection
+	g_object_set (G_OBJECT (cell), "active", GetStockState (model, iter), NULL);
+}
+
 //****************************************************************************//
 //      Signal handler for "Check" cell                                       //
 //****************************************************************************//
@@ -2646,12 +3170,15 @@ static void CheckCellHandler (GtkCellRendererToggle *cell, gchar *path, gpointer
 		GtkTreeIter iter;
 		if (gtk_tree_model_get_iter_from_string (GTK_TREE_MODEL (model), &iter, path))
 		{
-			// Get mark state
-			gboolean state;
-			gtk_tree_model_get (GTK_TREE_MODEL (model), &iter, GPOINTER_TO_UINT (data), &state, -1);
+			// Get selection index
+			guint index;
+			gtk_tree_model_get (GTK_TREE_MODEL (model), &iter, STOCK_INDEX_ID, &index, -1);
 
 			// Switch mark state
-			gtk_list_store_set (GTK_LIST_STORE (model), &iter, GPOINTER_TO_UINT (data), !state, -1);
+			MarkStock (index, !IsStockMarked (index));
+
+			// Store the same index to emit "row-changed" and move row to its sort position
+			gtk_list_store_set (GTK_LIST_STORE (model), &iter, STOCK_INDEX_ID, index, -1);
 		}
 	}
 }
@@ -2696,6 +3223,7 @@ static void TickerCellHandler (GtkCellRendererText *cell, gchar *path, gchar *ne
 					else
 					{
 						// Set value
+						SortKeys::Invalidate (GTK_TREE_MODEL (model), &iter);
 						gtk_list_store_set (GTK_LIST_STORE (model), &iter, GPOINTER_TO_UINT (data), upper, -1);
 
 						// Change save state
@@ -2745,6 +3273,7 @@ static void NameCellHandler (GtkCellRendererText *cell, gchar *path, gchar *newv
 				if (g_utf8_collate (oname, newval))
 				{
 					// Set value
+					SortKeys::Invalidate (GTK_TREE_MODEL (model), &iter);
 					gtk_list_store_set (GTK_LIST_STORE (model), &iter, GPOINTER_TO_UINT (data), newval, -1);
 
 					// Change save state
@@ -2782,6 +3311,7 @@ static void CellHandler (GtkCellRendererText *cell, gchar *path, gchar *newval,
 			if (g_utf8_collate (oldval, newval))
 			{
 				// Set value
+				SortKeys::Invalidate (GTK_TREE_MODEL (model), &iter);
 				gtk_list_store_set (GTK_LIST_STORE (model), &iter, GPOINTER_TO_UINT (data), newval, -1);
 
 				// Change save state
@@ -2928,6 +3458,7 @@ static void CreateEditSubMenu (void)
 	GtkWidget *UnselectAll = gtk_menu_item_new_with_mnemonic (MENU_EDIT_UNSELECT_ALL);
 	GtkWidget *Separator2 = gtk_separator_menu_item_new ();
 	GtkWidget *Find = gtk_menu_item_new_with_mnemonic (MENU_EDIT_FIND);
+	GtkWidget *Facet = gtk_menu_item_new_with_mnemonic (MENU_EDIT_FACETS);
 	GtkWidget *Sort = gtk_menu_item_new_with_mnemonic (MENU_EDIT_SORT);
 
 	// Add elements to submenu
@@ -2939,6 +3470,7 @@ static void CreateEditSubMenu (void)
 	gtk_menu_shell_append (GTK_MENU_SHELL (editmenu), GTK_WIDGET (UnselectAll));
 	gtk_menu_shell_append (GTK_MENU_SHELL (editmenu), GTK_WIDGET (Separator2));
 	gtk_menu_shell_append (GTK_MENU_SHELL (editmenu), GTK_WIDGET (Find));
+	gtk_menu_shell_append (GTK_MENU_SHELL (editmenu), GTK_WIDGET (Facet));
 	gtk_menu_shell_append (GTK_MENU_SHELL (editmenu), GTK_WIDGET (Sort));
 
 	// Add accelerators to menu buttons
@@ -2948,6 +3480,7 @@ static void CreateEditSubMenu (void)
 	gtk_widget_add_accelerator (GTK_WIDGET (Invert), "activate", GTK_ACCEL_GROUP (accelgroup), 'X', GDK_CONTROL_MASK, GTK_ACCEL_VISIBLE);
 	gtk_widget_add_accelerator (GTK_WIDGET (UnselectAll), "activate", GTK_ACCEL_GROUP (accelgroup), 'U', GDK_CONTROL_MASK, GTK_ACCEL_VISIBLE);
 	gtk_widget_add_accelerator (GTK_WIDGET (Find), "activate", GTK_ACCEL_GROUP (accelgroup), 'F', GDK_CONTROL_MASK, GTK_ACCEL_VISIBLE);
+	gtk_widget_add_accelerator (GTK_WIDGET (Facet), "activate", GTK_ACCEL_GROUP (accelgroup), 'G', GDK_CONTROL_MASK, GTK_ACCEL_VISIBLE);
 	gtk_widget_add_accelerator (GTK_WIDGET (Sort), "activate", GTK_ACCEL_GROUP (accelgroup), 'T', GDK_CONTROL_MASK, GTK_ACCEL_VISIBLE);
 
 	// Set submenu element properties
@@ -2957,6 +3490,7 @@ static void CreateEditSubMenu (void)
 	gtk_menu_item_set_use_underline (GTK_MENU_ITEM (Invert), TRUE);
 	gtk_menu_item_set_use_underline (GTK_MENU_ITEM (UnselectAll), TRUE);
 	gtk_menu_item_set_use_underline (GTK_MENU_ITEM (Find), TRUE);
+	gtk_menu_item_set_use_underline (GTK_MENU_ITEM (Facet), TRUE);
 	gtk_menu_item_set_use_underline (GTK_MENU_ITEM (Sort), TRUE);
 
 	// Assign signal handlers for "select" signal
@@ -2966,6 +3500,7 @@ static void CreateEditSubMenu (void)
 	g_signal_connect (G_OBJECT (Invert), "select", G_CALLBACK (MenuSelect), const_cast <char*> ("Invert selection mark for all stocks"));
 	g_signal_connect (G_OBJECT (UnselectAll), "select", G_CALLBACK (MenuSelect), const_cast <char*> ("Unselect all stocks"));
 	g_signal_connect (G_OBJECT (Find), "select", G_CALLBACK (MenuSelect), const_cast <char*> ("Find stocks in the list by attribute"));
+	g_signal_connect (G_OBJECT (Facet), "select", G_CALLBACK (MenuSelect), const_cast <char*> ("Select stocks by country, sector and industry"));
 	g_signal_connect (G_OBJECT (Sort), "select", G_CALLBACK (MenuSelect), const_cast <char*> ("Sort stock list by attribute"));
 
 	// Assign signal handlers for "deselect" signal
@@ -2975,6 +3510,7 @@ static void CreateEditSubMenu (void)
 	g_signal_connect (G_OBJECT (Invert), "deselect", G_CALLBACK (MenuDeselect), NULL);
 	g_signal_connect (G_OBJECT (UnselectAll), "deselect", G_CALLBACK (MenuDeselect), NULL);
 	g_signal_connect (G_OBJECT (Find), "deselect", G_CALLBACK (MenuDeselect), NULL);
+	g_signal_connect (G_OBJECT (Facet), "deselect", G_CALLBACK (MenuDeselect), NULL);
 	g_signal_connect (G_OBJECT (Sort), "deselect", G_CALLBACK (MenuDeselect), NULL);
 
 	// Assign signal handlers for "activate" signal
@@ -2984,6 +3520,7 @@ static void CreateEditSubMenu (void)
 	g_signal_connect (G_OBJECT (Invert), "activate", G_CALLBACK (InvertSelection), NULL);
 	g_signal_connect (G_OBJECT (UnselectAll), "activate", G_CALLBACK (UnselectAllStocks), NULL);
 	g_signal_connect (G_OBJECT (Find), "activate", G_CALLBACK (FindStocks), NULL);
+	g_signal_connect (G_OBJECT (Facet), "activate", G_CALLBACK (FacetStocks), NULL);
 	g_signal_connect (G_OBJECT (Sort), "activate", G_CALLBACK (SortStocks), NULL);
 }
 
@@ -3021,12 +3558,16 @@ static void CreateStocksSubMenu (void)
 	GtkWidget *Info = gtk_menu_item_new_with_mnemonic (MENU_STOCKS_INFO);
 	GtkWidget *Check = gtk_menu_item_new_with_mnemonic (MENU_STOCKS_CHECK);
 	GtkWidget *Sync = gtk_menu_item_new_with_mnemonic (MENU_STOCKS_SYNC);
+	GtkWidget *SyncLocal = gtk_menu_item_new_with_mnemonic (MENU_STOCKS_SYNC_LOCAL);
+	GtkWidget *BulkImport = gtk_menu_item_new_with_mnemonic (MENU_STOCKS_BULK_IMPORT);
 	GtkWidget *Analyze = gtk_menu_item_new_with_mnemonic (MENU_STOCKS_ANALYZE);
 
 	// Add elements to submenu
 	gtk_menu_shell_append (GTK_MENU_SHELL (stocksmenu), GTK_WIDGET (Info));
 	gtk_menu_shell_append (GTK_MENU_SHELL (stocksmenu), GTK_WIDGET (Check));
 	gtk_menu_shell_append (GTK_MENU_SHELL (stocksmenu), GTK_WIDGET (Sync));
+	gtk_menu_shell_append (GTK_MENU_SHELL (stocksmenu), GTK_WIDGET (SyncLocal));
+	gtk_menu_shell_append (GTK_MENU_SHELL (stocksmenu), GTK_WIDGET (BulkImport));
 	gtk_menu_shell_append (GTK_MENU_SHELL (stocksmenu), GTK_WIDGET (Analyze));
 
 	// Add accelerators to menu buttons
@@ -3039,24 +3580,32 @@ static void CreateStocksSubMenu (void)
 	gtk_menu_item_set_use_underline (GTK_MENU_ITEM (Info), TRUE);
 	gtk_menu_item_set_use_underline (GTK_MENU_ITEM (Check), TRUE);
 	gtk_menu_item_set_use_underline (GTK_MENU_ITEM (Sync), TRUE);
+	gtk_menu_item_set_use_underline (GTK_MENU_ITEM (SyncLocal), TRUE);
+	gtk_menu_item_set_use_underline (GTK_MENU_ITEM (BulkImport), TRUE);
 	gtk_menu_item_set_use_underline (GTK_MENU_ITEM (Analyze), TRUE);
 
 	// Assign signal handlers for "select" signal
 	g_signal_connect (G_OBJECT (Info), "select", G_CALLBACK (MenuSelect), const_cast <char*> ("Show stock details"));
 	g_signal_connect (G_OBJECT (Check), "select", G_CALLBACK (MenuSelect), const_cast <char*> ("Check stock quotes for errors"));
 	g_signal_connect (G_OBJECT (Sync), "select", G_CALLBACK (MenuSelect), const_cast <char*> ("Sync stock quotes with quotes server"));
+	g_signal_connect (G_OBJECT (SyncLocal), "select", G_CALLBACK (MenuSelect), const_cast <char*> ("Sync stock quotes with local quote files"));
+	g_signal_connect (G_OBJECT (BulkImport), "select", G_CALLBACK (MenuSelect), const_cast <char*> ("Import quotes of all stocks from single end-of-day file"));
 	g_signal_connect (G_OBJECT (Analyze), "select", G_CALLBACK (MenuSelect), const_cast <char*> ("Analyze stocks quotes for trading"));
 
 	// Assign signal handlers for "deselect" signal
 	g_signal_connect (G_OBJECT (Info), "deselect", G_CALLBACK (MenuDeselect), NULL);
 	g_signal_connect (G_OBJECT (Check), "deselect", G_CALLBACK (MenuDeselect), NULL);
 	g_signal_connect (G_OBJECT (Sync), "deselect", G_CALLBACK (MenuDeselect), NULL);
+	g_signal_connect (G_OBJECT (SyncLocal), "deselect", G_CALLBACK (MenuDeselect), NULL);
+	g_signal_connect (G_OBJECT (BulkImport), "deselect", G_CALLBACK (MenuDeselect), NULL);
 	g_signal_connect (G_OBJECT (Analyze), "deselect", G_CALLBACK (MenuDeselect), NULL);
 
 	// Assign signal handlers for "activate" signal
 	g_signal_connect (G_OBJECT (Info), "activate", G_CALLBACK (StockInfo), NULL);
 	g_signal_connect (G_OBJECT (Check), "activate", G_CALLBACK (CheckStocks), NULL);
 	g_signal_connect (G_OBJECT (Sync), "activate", G_CALLBACK (SyncStocks), NULL);
+	g_signal_connect (G_OBJECT (SyncLocal), "activate", G_CALLBACK (SyncLocalStocks), NULL);
+	g_signal_connect (G_OBJECT (BulkImport), "activate", G_CALLBACK (BulkImportStocks), NULL);
 	g_signal_connect (G_OBJECT (Analyze), "activate", G_CALLBACK (AnalyzeStocks), NULL);
 }
 
@@ -3354,7 +3903,7 @@ static GtkWidget* CreateStockList (void)
 	GtkCellRenderer *IndustryCell = gtk_cell_renderer_text_new ();
 
 	// Create columns for tree view
-	GtkTreeViewColumn *CheckColumn = gtk_tree_view_column_new_with_attributes (STOCK_CHECK_LABEL, GTK_CELL_RENDERER (CheckCell), "active", STOCK_CHECK_ID, NULL);
+	GtkTreeViewColumn *CheckColumn = gtk_tree_view_column_new_with_attributes (STOCK_CHECK_LABEL, GTK_CELL_RENDERER (CheckCell), NULL);
 	GtkTreeViewColumn *TickerColumn = gtk_tree_view_column_new_with_attributes (STOCK_TICKER_LABEL, GTK_CELL_RENDERER (TickerCell), "text", STOCK_TICKER_ID, NULL);
 	GtkTreeViewColumn *NameColumn = gtk_tree_view_column_new_with_attributes (STOCK_NAME_LABEL, GTK_CELL_RENDERER (NameCell), "text", STOCK_NAME_ID, NULL);
 	GtkTreeViewColumn *CountryColumn = gtk_tree_view_column_new_with_attributes (STOCK_COUNTRY_LABEL, GTK_CELL_RENDERER (CountryCell), "text", STOCK_COUNTRY_ID, NULL);
@@ -3373,6 +3922,7 @@ static GtkWidget* CreateStockList (void)
 	gtk_container_add (GTK_CONTAINER (scrolled), GTK_WIDGET (treeview));
 
 	// Set cell properties
+	gtk_tree_view_column_set_cell_data_func (GTK_TREE_VIEW_COLUMN (CheckColumn), GTK_CELL_RENDERER (CheckCell), CheckRenderFunc, NULL, NULL);
 	gtk_cell_renderer_set_alignment (GTK_CELL_RENDERER (TickerCell), 0.0, 0.0);
 	gtk_cell_renderer_set_alignment (GTK_CELL_RENDERER (NameCell), 0.0, 0.0);
 	gtk_cell_renderer_set_alignment (GTK_CELL_RENDERER (CountryCell), 0.0, 0.0);
@@ -3405,7 +3955,7 @@ static GtkWidget* CreateStockList (void)
 	gtk_tree_view_column_set_reorderable (GTK_TREE_VIEW_COLUMN (IndustryColumn), TRUE);
 
 	// Set tree view sort properties
-	gtk_tree_view_column_set_sort_column_id (GTK_TREE_VIEW_COLUMN (CheckColumn), STOCK_CHECK_ID);
+	gtk_tree_view_column_set_sort_column_id (GTK_TREE_VIEW_COLUMN (CheckColumn), STOCK_INDEX_ID);
 	gtk_tree_view_column_set_sort_column_id (GTK_TREE_VIEW_COLUMN (TickerColumn), STOCK_TICKER_ID);
 	gtk_tree_view_column_set_sort_column_id (GTK_TREE_VIEW_COLUMN (NameColumn), STOCK_NAME_ID);
 	gtk_tree_view_column_set_sort_column_id (GTK_TREE_VIEW_COLUMN (CountryColumn), STOCK_COUNTRY_ID);
@@ -3430,7 +3980,7 @@ static GtkWidget* CreateStockList (void)
 	g_signal_connect (G_OBJECT (selection), "changed", G_CALLBACK (SelectionChanged), NULL);
 
 	// Assign signal handlers for cells
-	g_signal_connect (G_OBJECT (CheckCell), "toggled", G_CALLBACK (CheckCellHandler), GUINT_TO_POINTER (STOCK_CHECK_ID));
+	g_signal_connect (G_OBJECT (CheckCell), "toggled", G_CALLBACK (CheckCellHandler), GUINT_TO_POINTER (STOCK_INDEX_ID));
 	g_signal_connect (G_OBJECT (TickerCell), "edited", G_CALLBACK (TickerCellHandler), GUINT_TO_POINTER (STOCK_TICKER_ID));
 	g_signal_connect (G_OBJECT (NameCell), "edited", G_CALLBACK (NameCellHandler), GUINT_TO_POINTER (STOCK_NAME_ID));
 	g_signal_connect (G_OBJECT (CountryCell), "edited", G_CALLBACK (CellHandler), GUINT_TO_POINTER (STOCK_COUNTRY_ID));
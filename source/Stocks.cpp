@@ -9,6 +9,12 @@
 */
 # include	<StockList.h>
 # include	<Stocks.h>
+# include	<SortKeys.h>
+# include	<SearchIndex.h>
+# include	<Facets.h>
+# include	<glib/gstdio.h>
+# include	<string.h>
+# include	<errno.h>
 
 //****************************************************************************//
 //      Stock constants                                                       //
@@ -32,6 +38,13 @@
 # define	STOCK_URL_ATTR		"url"
 # define	STOCK_FILE_ATTR		"file"
 
+//============================================================================//
+//      Stock list snapshot                                                   //
+//============================================================================//
+# define	STOCK_SNAPSHOT_EXT		".cache"		// Extension of snapshot file
+# define	STOCK_SNAPSHOT_MAGIC	"STOCKS01"		// Signature of snapshot file
+# define	STOCK_SNAPSHOT_FIELDS	6				// Count of string fields in snapshot row
+
 //****************************************************************************//
 //      Stock list structure                                                  //
 //****************************************************************************//
@@ -41,10 +54,268 @@ struct StockList
 	gchar			*tzone;		// Stock time zone
 };
 
+//****************************************************************************//
+//      Snapshot header structure                                             //
+//****************************************************************************//
+struct SnapshotHeader
+{
+	gchar		magic [8];		// Signature of snapshot file
+	guint32		count;			// Count of stock rows
+	guint32		bytes;			// Size of string table
+	guint32		tzone;			// Offset of time zone file name in string table
+	guint32		reserved;		// Reserved field for data alignment
+	gint64		size;			// Size of stock list file
+	gint64		mtime;			// Modification time of stock list file
+};
+
+//****************************************************************************//
+//      Snapshot row structure                                                //
+//****************************************************************************//
+struct SnapshotRow
+{
+	guint32		fields [STOCK_SNAPSHOT_FIELDS];	// Offsets of stock fields in string table
+};
+
 //****************************************************************************//
 //      Internal functions                                                    //
 //****************************************************************************//
 
+//============================================================================//
+//      Compare stocks by selection state                                     //
+//============================================================================//
+static gint CompareSelection (GtkTreeModel *model, GtkTreeIter *a, GtkTreeIter *b, gpointer data)
+{
+	// Convert data pointer
+	const Selection *selection = reinterpret_cast <const Selection*> (data);
+
+	// Get selection indices of stocks
+	guint aindex, bindex;
+	gtk_tree_model_get (model, a, STOCK_INDEX_ID, &aindex, -1);
+	gtk_tree_model_get (model, b, STOCK_INDEX_ID, &bindex, -1);
+
+	// Compare selection states
+	return selection -> Get (aindex) - selection -> Get (bindex);
+}
+
+//============================================================================//
+//      Create empty stock list                                               //
+//============================================================================//
+static GtkListStore* CreateStockList (Selection *selection)
+{
+	// Create new stock list
+	GtkListStore *list = gtk_list_store_new (STOCK_COLUMNS, G_TYPE_STRING, G_TYPE_STRING, G_TYPE_STRING, G_TYPE_STRING, G_TYPE_STRING, G_TYPE_STRING, G_TYPE_UINT);
+
+	// Sort selection column by selection state instead of row index
+	gtk_tree_sortable_set_sort_func (GTK_TREE_SORTABLE (list), STOCK_INDEX_ID, CompareSelection, selection, NULL);
+
+	// Sort text columns by collation keys
+	SortKeys *keys = new SortKeys ();
+	keys -> Attach (list);
+
+	// Find stocks by search index
+	SearchIndex *index = new SearchIndex ();
+	index -> Attach (list);
+
+	// Select stocks by facets
+	Facets *facets = new Facets ();
+	facets -> Attach (list);
+
+	// Return new stock list
+	return list;
+}
+
+//============================================================================//
+//      Get next selection index of stock list                                //
+//============================================================================//
+static guint NextIndex (GtkListStore *list)
+{
+	return gtk_tree_model_iter_n_children (GTK_TREE_MODEL (list), NULL);
+}
+
+//============================================================================//
+//      Get snapshot file name of stock list                                  //
+//============================================================================//
+static gchar* GetSnapshotFile (const gchar *fname)
+{
+	return g_strconcat (fname, STOCK_SNAPSHOT_EXT, NULL);
+}
+
+//============================================================================//
+//      Add string to snapshot string table                                   //
+//============================================================================//
+static guint32 AddSnapshotString (GString *table, GHashTable *strings, const gchar *string)
+{
+	// Check if the same string is already in string table
+	gpointer offset;
+	if (g_hash_table_lookup_extended (strings, string, NULL, &offset))
+		return GPOINTER_TO_UINT (offset);
+
+	// Append new string with its end of string marker
+	guint32 result = table -> len;
+	g_string_append_len (table, string, strlen (string) + 1);
+
+	// Remember offset of new string
+	g_hash_table_insert (strings, g_strdup (string), GUINT_TO_POINTER (result));
+
+	// Return string offset
+	return result;
+}
+
+//============================================================================//
+//      Save stock list snapshot                                              //
+//============================================================================//
+static gboolean SaveSnapshot (const gchar *fname, GtkTreeModel *list, const gchar *tzone, GError **error)
+{
+	// Get stock list file properties
+	GStatBuf info;
+	if (g_stat (fname, &info) != 0)
+	{
+		// Set error message
+		g_set_error (error, G_FILE_ERROR, g_file_error_from_errno (errno), "Can not read properties of file '%s'", fname);
+
+		// Return fail status
+		return FALSE;
+	}
+
+	// Create string table and its index
+	GString *table = g_string_new (NULL);
+	GHashTable *strings = g_hash_table_new_full (g_str_hash, g_str_equal, g_free, NULL);
+
+	// Create array of snapshot rows
+	GArray *rows = g_array_new (FALSE, FALSE, sizeof (SnapshotRow));
+
+	// Get iterator position
+	GtkTreeIter iter;
+	if (gtk_tree_model_get_iter_first (list, &iter))
+	{
+		// Iterate through all elements
+		do {
+			// Get stock details
+			gchar *fields [STOCK_SNAPSHOT_FIELDS];
+			gtk_tree_model_get (list, &iter, STOCK_TICKER_ID, &fields[0], STOCK_NAME_ID, &fields[1], STOCK_COUNTRY_ID, &fields[2], STOCK_SECTOR_ID, &fields[3], STOCK_INDUSTRY_ID, &fields[4], STOCK_URL_ID, &fields[5], -1);
+
+			// Add stock fields to string table
+			SnapshotRow row;
+			for (gint i = 0; i < STOCK_SNAPSHOT_FIELDS; i++)
+			{
+				row.fields[i] = AddSnapshotString (table, strings, fields[i] ? fields[i] : "");
+				g_free (fields[i]);
+			}
+
+			// Append new row to snapshot rows
+			g_array_append_val (rows, row);
+
+			// Change iterator position to next element
+		} while (gtk_tree_model_iter_next (list, &iter));
+	}
+
+	// Fill snapshot header
+	SnapshotHeader header;
+	memcpy (header.magic, STOCK_SNAPSHOT_MAGIC, sizeof (header.magic));
+	header.count = rows -> len;
+	header.tzone = AddSnapshotString (table, strings, tzone ? tzone : "");
+	header.bytes = table -> len;
+	header.reserved = 0;
+	header.size = info.st_size;
+	header.mtime = info.st_mtime;
+
+	// Compose snapshot file content
+	GString *content = g_string_sized_new (sizeof (SnapshotHeader) + rows -> len * sizeof (SnapshotRow) + table -> len);
+	g_string_append_len (content, reinterpret_cast <const gchar*> (&header), sizeof (SnapshotHeader));
+	g_string_append_len (content, rows -> data, rows -> len * sizeof (SnapshotRow));
+	g_string_append_len (content, table -> str, table -> len);
+
+	// Try to save snapshot into file
+	gchar *sname = GetSnapshotFile (fname);
+	gboolean status = g_file_set_contents (sname, content -> str, content -> len, error);
+
+	// Release snapshot elements
+	g_free (sname);
+	g_string_free (content, TRUE);
+	g_string_free (table, TRUE);
+	g_hash_table_destroy (strings);
+	g_array_free (rows, TRUE);
+
+	// Return file operation status
+	return status;
+}
+
+//============================================================================//
+//      Load stock list snapshot                                              //
+//============================================================================//
+static gboolean LoadSnapshot (const gchar *fname, StockList *slist)
+{
+	// Get stock list file properties
+	GStatBuf info;
+	if (g_stat (fname, &info) != 0)
+		return FALSE;
+
+	// Try to map snapshot file into memory
+	gchar *sname = GetSnapshotFile (fname);
+	GMappedFile *file = g_mapped_file_new (sname, FALSE, NULL);
+	g_free (sname);
+	if (file == NULL)
+		return FALSE;
+
+	// Get snapshot content
+	const gchar *data = g_mapped_file_get_contents (file);
+	gsize length = g_mapped_file_get_length (file);
+
+	// Check if snapshot was saved for current stock list file
+	gboolean status = FALSE;
+	SnapshotHeader header;
+	if (length >= sizeof (SnapshotHeader))
+	{
+		// Copy snapshot header
+		memcpy (&header, data, sizeof (SnapshotHeader));
+
+		// Check snapshot signature and stock list file properties
+		if (memcmp (header.magic, STOCK_SNAPSHOT_MAGIC, sizeof (header.magic)) == 0 && header.size == static_cast <gint64> (info.st_size) && header.mtime == static_cast <gint64> (info.st_mtime))
+		{
+			// Check snapshot size and string table bounds
+			gsize rsize = static_cast <gsize> (header.count) * sizeof (SnapshotRow);
+			if (length == sizeof (SnapshotHeader) + rsize + header.bytes && header.bytes && header.tzone < header.bytes && data [length - 1] == '\0')
+				status = TRUE;
+		}
+	}
+
+	// Check if snapshot is valid
+	if (status)
+	{
+		// Get snapshot rows and string table
+		const SnapshotRow *rows = reinterpret_cast <const SnapshotRow*> (data + sizeof (SnapshotHeader));
+		const gchar *table = data + sizeof (SnapshotHeader) + header.count * sizeof (SnapshotRow);
+
+		// Check that all fields point into string table
+		for (guint32 i = 0; i < header.count && status; i++)
+			for (gint j = 0; j < STOCK_SNAPSHOT_FIELDS; j++)
+				if (rows[i].fields[j] >= header.bytes)
+					status = FALSE;
+
+		// Load stock rows into stock list
+		for (guint32 i = 0; i < header.count && status; i++)
+		{
+			// Get stock fields
+			const guint32 *fields = rows[i].fields;
+
+			// Add new element to list store object
+			gtk_list_store_insert_with_values (GTK_LIST_STORE (slist -> list), NULL, -1, STOCK_TICKER_ID, table + fields[0], STOCK_NAME_ID, table + fields[1], STOCK_COUNTRY_ID, table + fields[2], STOCK_SECTOR_ID, table + fields[3], STOCK_INDUSTRY_ID, table + fields[4], STOCK_URL_ID, table + fields[5], STOCK_INDEX_ID, i, -1);
+		}
+
+		// Set time zone file name
+		if (status && table [header.tzone] != '\0')
+			slist -> tzone = g_strdup (table + header.tzone);
+		else
+			status = FALSE;
+	}
+
+	// Release mapped snapshot file
+	g_mapped_file_unref (file);
+
+	// Return snapshot loading status
+	return status;
+}
+
 //============================================================================//
 //      Parse stock list line                                                 //
 //============================================================================//
@@ -108,9 +379,7 @@ static void ParseLine (const gchar *string, gpointer data, GError **error)
 		gchar *upper = g_utf8_strup (ticker, -1);
 
 		// Add new element to list store object
-		GtkTreeIter iter;
-		gtk_list_store_append (GTK_LIST_STORE (list), &iter);
-		gtk_list_store_set (GTK_LIST_STORE (list), &iter, STOCK_TICKER_ID, upper, STOCK_NAME_ID, name, STOCK_COUNTRY_ID, country, STOCK_SECTOR_ID, sector, STOCK_INDUSTRY_ID, industry, STOCK_URL_ID, url, STOCK_CHECK_ID, FALSE, -1);
+		gtk_list_store_insert_with_values (GTK_LIST_STORE (list), NULL, -1, STOCK_TICKER_ID, upper, STOCK_NAME_ID, name, STOCK_COUNTRY_ID, country, STOCK_SECTOR_ID, sector, STOCK_INDUSTRY_ID, industry, STOCK_URL_ID, url, STOCK_INDEX_ID, NextIndex (list), -1);
 
 		// Free temporary string buffer
 		g_free (upper);
@@ -157,9 +426,7 @@ static void ParseElement (GMarkupParseContext *context, const gchar *element_nam
 			gchar *upper = g_utf8_strup (ticker, -1);
 
 			// Add new element to list store object
-			GtkTreeIter iter;
-			gtk_list_store_append (GTK_LIST_STORE (slist -> list), &iter);
-			gtk_list_store_set (GTK_LIST_STORE (slist -> list), &iter, STOCK_TICKER_ID, upper, STOCK_NAME_ID, name, STOCK_COUNTRY_ID, country, STOCK_SECTOR_ID, sector, STOCK_INDUSTRY_ID, industry, STOCK_URL_ID, url, STOCK_CHECK_ID, FALSE, -1);
+			gtk_list_store_insert_with_values (GTK_LIST_STORE (slist -> list), NULL, -1, STOCK_TICKER_ID, upper, STOCK_NAME_ID, name, STOCK_COUNTRY_ID, country, STOCK_SECTOR_ID, sector, STOCK_INDUSTRY_ID, industry, STOCK_URL_ID, url, STOCK_INDEX_ID, NextIndex (slist -> list), -1);
 
 			// Free temporary string buffer
 			g_free (upper);
@@ -291,8 +558,9 @@ void Stocks::NewList (const gchar *tzone)
 	g_free (timezone);
 
 	// Set new stock elements
-	list = gtk_list_store_new (STOCK_COLUMNS, G_TYPE_STRING, G_TYPE_STRING, G_TYPE_STRING, G_TYPE_STRING, G_TYPE_STRING, G_TYPE_STRING, G_TYPE_BOOLEAN);
+	list = CreateStockList (&selection);
 	timezone = g_strdup (tzone);
+	selection.Resize (0);
 
 	// Sort stocks by ticker
 	gtk_tree_sortable_set_sort_column_id (GTK_TREE_SORTABLE (list), STOCK_TICKER_ID, GTK_SORT_ASCENDING);
@@ -319,6 +587,7 @@ void Stocks::ClearList (void)
 	// Set stock elements to default values
 	list = NULL;
 	timezone = NULL;
+	selection.Resize (0);
 }
 
 //****************************************************************************//
@@ -326,6 +595,49 @@ void Stocks::ClearList (void)
 //****************************************************************************//
 gboolean Stocks::OpenList (const gchar *fname, GError **error)
 {
+	// Create new stock list for snapshot
+	GtkListStore *snaplist = CreateStockList (&selection);
+
+	// Create new stock list structure
+	StockList snapshot = {snaplist, NULL};
+
+	// Try to load stock list snapshot if it is up to date
+	if (LoadSnapshot (fname, &snapshot))
+	{
+		// Sort stocks by ticker
+		gtk_tree_sortable_set_sort_column_id (GTK_TREE_SORTABLE (snaplist), STOCK_TICKER_ID, GTK_SORT_ASCENDING);
+
+		// Free stock elements
+		if (list)
+		{
+			// Clear stock list
+			gtk_list_store_clear (list);
+
+			// Decrement reference count to stock list
+			g_object_unref (list);
+		}
+
+		// Free string buffer
+		g_free (timezone);
+
+		// Set new stock elements
+		list = snaplist;
+		selection.Resize (NextIndex (snaplist));
+		timezone = snapshot.tzone;
+
+		// Return success state
+		return TRUE;
+	}
+
+	// Free temporary string buffer
+	g_free (snapshot.tzone);
+
+	// Clear snapshot stock list
+	gtk_list_store_clear (snaplist);
+
+	// Decrement reference count to snapshot stock list
+	g_object_unref (snaplist);
+
 	// Try to load file content into string buffer
 	gchar *content;
 	gsize bytes;
@@ -333,7 +645,7 @@ gboolean Stocks::OpenList (const gchar *fname, GError **error)
 	if (status)
 	{
 		// Create new stock list
-		GtkListStore *newlist = gtk_list_store_new (STOCK_COLUMNS, G_TYPE_STRING, G_TYPE_STRING, G_TYPE_STRING, G_TYPE_STRING, G_TYPE_STRING, G_TYPE_STRING, G_TYPE_BOOLEAN);
+		GtkListStore *newlist = CreateStockList (&selection);
 
 		// Create new stock list structure
 		StockList slist = {newlist, NULL};
@@ -396,6 +708,7 @@ gboolean Stocks::OpenList (const gchar *fname, GError **error)
 
 				// Set new stock elements
 				list = newlist;
+				selection.Resize (NextIndex (newlist));
 				timezone = slist.tzone;
 
 				// Return success state
@@ -476,6 +789,18 @@ gboolean Stocks::SaveList (const gchar *fname, GError **error)
 	// Relase string buffer
 	g_string_free (string, TRUE);
 
+	// Save stock list snapshot for fast opening
+	if (status && list)
+	{
+		// Snapshot is optional, so drop it if it can not be saved
+		if (!SaveSnapshot (fname, GTK_TREE_MODEL (list), timezone, NULL))
+		{
+			gchar *sname = GetSnapshotFile (fname);
+			g_unlink (sname);
+			g_free (sname);
+		}
+	}
+
 	// Return file operation status
 	return status;
 }
@@ -492,7 +817,7 @@ gboolean Stocks::ImportList (const gchar *fname, GError **error)
 	if (status)
 	{
 		// Create new stock list
-		GtkListStore *newlist = gtk_list_store_new (STOCK_COLUMNS, G_TYPE_STRING, G_TYPE_STRING, G_TYPE_STRING, G_TYPE_STRING, G_TYPE_STRING, G_TYPE_STRING, G_TYPE_BOOLEAN);
+		GtkListStore *newlist = CreateStockList (&selection);
 
 		// Split file content into lines
 		gchar **lines = g_strsplit_set (content, "\n", 0);
@@ -553,6 +878,7 @@ gboolean Stocks::ImportList (const gchar *fname, GError **error)
 
 			// Set new stock elements
 			list = newlist;
+			selection.Resize (NextIndex (newlist));
 
 			// Return success state
 			return TRUE;
@@ -627,6 +953,14 @@ GtkListStore* Stocks::GetStockList (void) const
 	return list;
 }
 
+//****************************************************************************//
+//      Get selection of stocks                                               //
+//****************************************************************************//
+Selection* Stocks::GetSelection (void)
+{
+	return &selection;
+}
+
 //****************************************************************************//
 //      Get stock time zone property                                          //
 //****************************************************************************//
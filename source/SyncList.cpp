@@ -8,12 +8,17 @@
 ################################################################################
 */
 # include	<Common.h>
+# include	<Writer.h>
+# include	<Profile.h>
 # include	<Quotes.h>
-# include	<Client.h>
+# include	<QuoteProvider.h>
 # include	<TimeZone.h>
 # include	<StockList.h>
 # include	<QuoteList.h>
 # include	<SyncList.h>
+# include	<Panel.h>
+# include	<Journal.h>
+# include	<TradingCalendar.h>
 
 //****************************************************************************//
 //      Sync result structure                                                 //
@@ -24,72 +29,135 @@ struct SyncResult
 	gint		count;			// Quotes count
 	time_t		start;			// Start quote date
 	time_t		end;			// End quote date
+	gboolean	current;		// Quotes already had latest session
 };
 
 //****************************************************************************//
-//      Sync stock quotes with quote server                                   //
+//      Sync retry structure                                                  //
 //****************************************************************************//
-SyncResult SyncQuotes (const gchar *fname, const gchar* ticker, TimeZone *timezone, Client *client, GError **error)
+struct SyncRetry
+{
+	gchar		*ticker;		// Stock ticker
+	guint		index;			// Selection index of stock
+	gint		attempts;		// Count of sync attempts
+};
+
+//****************************************************************************//
+//      Free sync retry structure                                             //
+//****************************************************************************//
+static void FreeRetry (gpointer data)
+{
+	// Convert data pointer
+	SyncRetry *retry = reinterpret_cast <SyncRetry*> (data);
+
+	// Free retry elements
+	g_free (retry -> ticker);
+
+	// Free retry structure
+	g_free (retry);
+}
+
+//****************************************************************************//
+//      Sync stock quotes with quote provider                                 //
+//****************************************************************************//
+SyncResult SyncQuotes (const gchar *fname, const gchar* ticker, TimeZone *timezone, TradingCalendar *calendar, QuoteProvider *provider, GPtrArray *staged, Panel *panel, Arena *arena, GError **error)
 {
 	// Init result structure
 	SyncResult result = {
 		static_cast <gboolean> (FALSE),
 		static_cast <gint> (-1),
 		static_cast <time_t> (TIME_ERROR),
-		static_cast <time_t> (TIME_ERROR)
+		static_cast <time_t> (TIME_ERROR),
+		static_cast <gboolean> (FALSE)
 	};
 
 	// Get quotes file name
-	gchar* path = GetQuotesFile (fname, ticker);
+	gchar* path = GetQuotesFile (fname, ticker, arena);
 
-	// Create quotes object
+	// Create quotes object which takes memory from arena
 	Quotes quotes;
+	quotes.SetArena (arena);
 
 	// Try to open quotes
 	if (OpenQuoteList (&quotes, path, error))
 	{
+		// Get current time in time zone
+		time_t curr = timezone -> GetCurrentTime ();
+
+		// Skip server requests if stored quotes already have latest trading
+		// session. Imports of local files are always read
+		if (provider -> IsRemote () && calendar -> IsCovered (quotes.GetLastDate (), quotes.GetSyncTime (), curr))
+		{
+			// Set result structure fields
+			result.status = TRUE;
+			result.count = 0;
+			result.current = TRUE;
+
+			// Normal exit
+			return result;
+		}
+
 		// Get last quote date
+		gboolean reset = FALSE;
 		time_t last = quotes.GetLastDate ();
 		if (last == static_cast <time_t> (TIME_ERROR))
 			last = MIN_DATE;
 		else
 			last += TIME_DAY;
 
-		// Get current time in time zone
-		time_t curr = timezone -> GetCurrentTime ();
-
 		// Check quotes for splits and dividends
-		if (client -> CheckSplits (ticker, last, curr, error))
+		if (provider -> CheckSplits (ticker, last, curr, error))
 		{
 			// Clear stock quotes
 			quotes.NewList (curr);
+			reset = TRUE;
 
 			// Set last quote date min date
 			last = static_cast <time_t> (MIN_DATE);
 		}
 
-		// Get new quotes
-		if (client -> GetQuotes (ticker, last, curr, error))
+		// Get new quotes if splits check did not fail
+		if ((error == NULL || *error == NULL) && provider -> GetQuotes (ticker, last, curr, error))
 		{
+			// Stored quotes can not be kept when there are none of them
+			if (provider -> IsUnchanged () && quotes.GetCount () == 0)
+				g_set_error (error, G_FILE_ERROR, G_FILE_ERROR_IO, "Quote server did not send quotes of empty quote list");
+
+			// Check if quotes were not modified since previous request
+			else if (provider -> IsUnchanged ())
+			{
+				// Update sync time only
+				quotes.SetSyncTime (curr);
+
+				// Try to save quotes for batched commit
+				if (StageQuoteList (&quotes, path, staged, error))
+				{
+					// Set result structure fields
+					result.status = TRUE;
+					result.count = 0;
+					result.current = TRUE;
+				}
+			}
+
 			// Add new quotes
-			if (quotes.AddQuotes (client -> GetQuoteList (), curr, error))
+			else if (quotes.AddQuotes (provider -> GetQuoteList (), curr, error))
 			{
-				// Try to save quotes
-				if (SaveQuoteList (&quotes, path, error))
+				// Try to save quotes for batched commit
+				if (StageQuoteList (&quotes, path, staged, error))
 				{
 					// Set result structure fields
 					result.status = TRUE;
-					result.count = client -> GetCount ();
-					result.start = client -> GetFirstDate ();
-					result.end = client -> GetLastDate ();
+					result.count = provider -> GetCount ();
+					result.start = provider -> GetFirstDate ();
+					result.end = provider -> GetLastDate ();
+
+					// Add new quotes to stock panel
+					panel -> AddQuotes (ticker, quotes.GetQuoteList (), reset);
 				}
 			}
 		}
 	}
 
-	// Free temporary string buffer
-	g_free (path);
-
 	// Normal exit
 	return result;
 }
@@ -99,14 +167,21 @@ SyncResult SyncQuotes (const gchar *fname, const gchar* ticker, TimeZone *timezo
 //****************************************************************************//
 static gboolean SaveSyncReport (const gchar *fname, GtkTreeModel *model, GError **error)
 {
-	// Create string buffer
-	GString *string = g_string_new (NULL);
+	// Try to open report file
+	Writer writer;
+	if (!writer.Open (fname, Writer::GetTextFormat (fname), error))
+		return FALSE;
 
 	// Check if report is set
 	if (model)
 	{
 		// Append report header
-		g_string_append_printf (string, SYNC_TICKER_LABEL "\t" SYNC_QUOTES_LABEL "\t" SYNC_START_LABEL "\t" SYNC_END_LABEL "\t" SYNC_STATUS_LABEL "\n");
+		writer.AddString (SYNC_TICKER_LABEL);
+		writer.AddString (SYNC_QUOTES_LABEL);
+		writer.AddString (SYNC_START_LABEL);
+		writer.AddString (SYNC_END_LABEL);
+		writer.AddString (SYNC_STATUS_LABEL);
+		writer.EndRow ();
 
 		// Get iterator position
 		GtkTreeIter iter;
@@ -120,24 +195,28 @@ static gboolean SaveSyncReport (const gchar *fname, GtkTreeModel *model, GError
 				time_t start, end;
 				gtk_tree_model_get (GTK_TREE_MODEL (model), &iter, SYNC_TICKER_ID, &ticker, SYNC_QUOTES_ID, &count, SYNC_START_ID, &start, SYNC_END_ID, &end, SYNC_STATUS_ID, &status, -1);
 
-				// Append quote information into string buffer
-				date_struct sdate = Time::ExtractDate (start);
-				date_struct edate = Time::ExtractDate (end);
-				g_string_append_printf (string, "%s\t%i\t%.4i-%.2d-%.2d\t%.4i-%.2d-%.2d\t%s\n", ticker, count, sdate.year, sdate.mon, sdate.day, edate.year, edate.mon, edate.day, status);
+				// Append quote information into report
+				writer.AddString (ticker);
+				writer.AddInt (count);
+				writer.AddDate (start);
+				writer.AddDate (end);
+				writer.AddString (status);
+				writer.EndRow ();
+
+				// Free temporary string buffers
+				g_free (ticker);
+				g_free (status);
 
 				// Change iterator position to next element
 			} while (gtk_tree_model_iter_next (GTK_TREE_MODEL (model), &iter));
 		}
-	}
 
-	// Try to save string buffer into file
-	gboolean status = g_file_set_contents (fname, string -> str, string -> len, error);
-
-	// Relase string buffer
-	g_string_free (string, TRUE);
+		// Append stage measurements of run
+		WriteProfile (&writer);
+	}
 
-	// Return file operation status
-	return status;
+	// Close report file
+	return writer.Close (error);
 }
 
 //****************************************************************************//
@@ -239,10 +318,102 @@ static GtkWidget* CreateSyncList (GtkTreeModel *model)
 	return scrolled;
 }
 
+//****************************************************************************//
+//      Add quotes of synced stock to panel                                   //
+//****************************************************************************//
+static void AddPanelQuotes (const gchar *fname, const gchar *ticker, Panel *panel, Arena *arena)
+{
+	// Get quotes file name
+	gchar* path = GetQuotesFile (fname, ticker, arena);
+
+	// Create quotes object which takes memory from arena
+	Quotes quotes;
+	quotes.SetArena (arena);
+
+	// Add quotes to stock panel if they are opened
+	if (quotes.OpenList (path, NULL))
+		panel -> AddQuotes (ticker, quotes.GetQuoteList (), FALSE);
+}
+
+//****************************************************************************//
+//      Check if stock was synced for session by previous run                 //
+//****************************************************************************//
+static gboolean IsSynced (const Journal *journal, const gchar *ticker)
+{
+	// Get job entry of ticker
+	const JournalEntry *entry = journal -> Find (ticker);
+
+	// Check job state
+	return entry && entry -> state == JOURNAL_DONE;
+}
+
+//****************************************************************************//
+//      Process pending events while quote provider waits between requests   //
+//****************************************************************************//
+static gboolean WaitProgress (gpointer data)
+{
+	// Convert data pointer
+	gboolean *terminate = reinterpret_cast <gboolean*> (data);
+
+	// Process pending events
+	while (gtk_events_pending ())
+		gtk_main_iteration ();
+
+	// Continue waiting until sync is terminated
+	return !*terminate;
+}
+
+//****************************************************************************//
+//      Commit synced quote files and then their journal entries              //
+//****************************************************************************//
+static gboolean CommitBatch (GtkWindow *parent, GPtrArray *staged, Journal *journal)
+{
+	// Create error object
+	GError *error = NULL;
+
+	// Journal entries are written only after their quote files
+	if (CommitQuoteLists (staged, &error) && journal -> Flush (&error))
+		return TRUE;
+
+	// Show error message
+	ShowErrorMessage (GTK_WINDOW (parent), "Stock synchronization failed", error);
+
+	// Return fail status
+	return FALSE;
+}
+
+//****************************************************************************//
+//      Add sync result to report                                             //
+//****************************************************************************//
+static gboolean AddSyncResult (GtkListStore *list, Results *results, Journal *journal, guint attempts, guint index, const gchar *ticker, const SyncResult *result, GError *error)
+{
+	// Set status message
+	const gchar *status = result -> status ? STRING_OK : error -> message;
+
+	// Add finished job to sync journal
+	if (journal)
+		journal -> Add (ticker, result -> status ? JOURNAL_DONE : JOURNAL_FAILED, attempts, result -> count, result -> start, result -> end, result -> status ? NULL : status);
+
+	// Add stock to results
+	results -> Add (index, result -> status ? RESULT_GOOD : RESULT_BAD);
+
+	// Add new element to list store object
+	gint64 start = ProfileStart ();
+	gtk_list_store_insert_with_values (GTK_LIST_STORE (list), NULL, -1, SYNC_TICKER_ID, ticker, SYNC_QUOTES_ID, result -> count, SYNC_START_ID, result -> start, SYNC_END_ID, result -> end, SYNC_STATUS_ID, status, -1);
+	ProfileStop (PROFILE_MODEL, start, 0);
+
+	// Release error object
+	if (error)
+		g_error_free (error);
+
+	// Return sync status
+	return result -> status;
+}
+
 //****************************************************************************//
 //      Sync quotes dialog                                                    //
 //****************************************************************************//
-gboolean SyncQuotesDialog (GtkWindow *parent, GtkTreeModel *model, const gchar *fname, const gchar *tzone)
+gboolean SyncQuotesDialog (GtkWindow *parent, GtkTreeModel *model, const gchar *fname, const gchar *tzone, QuoteProvider *provider)
 {
 	// Operation status
 	gboolean status = FALSE;
@@ -254,128 +425,348 @@ gboolean SyncQuotesDialog (GtkWindow *parent, GtkTreeModel *model, const gchar *
 		// Create time zone object
 		TimeZone timezone;
 
-		// Create client object for quote server
-		Client client;
+		// Create trading calendar of stock list exchange
+		TradingCalendar calendar;
+		calendar.Init (tzone);
+
+		// Create sync journal object
+		Journal journal;
 
 		// Create error object
 		GError *error = NULL;
 
-		// Load time zone and init quote client
-		if (!timezone.Init (tzone, &error) || !client.Init (&error))
+		// Clear stage measurements of previous run
+		ResetProfile ();
+
+		// Load time zone and open sync journal of latest trading session,
+		// so a run after session close starts a fresh journal. Imports of
+		// local files do not use the journal and are never skipped by it
+		gboolean remote = provider -> IsRemote ();
+		gboolean ready = timezone.Init (tzone, &error);
+		time_t today = ready ? timezone.GetCurrentTime () : 0;
+		ready = ready && (!remote || journal.Open (fname, calendar.GetLatestSession (today), &error));
+		Journal *log = remote ? &journal : NULL;
+
+		// Create array of marked tickers
+		GPtrArray *tickers = g_ptr_array_new_with_free_func (g_free);
+
+		// Collect tickers of marked stocks which are not synced for session
+		do {
+			// Get stock details
+			guint index;
+			gchar *ticker;
+			gtk_tree_model_get (GTK_TREE_MODEL (model), &iter, STOCK_TICKER_ID, &ticker, STOCK_INDEX_ID, &index, -1);
+
+			// Check if stock is marked
+			if (IsStockMarked (index) && !IsSynced (&journal, ticker))
+				g_ptr_array_add (tickers, ticker);
+			else
+				g_free (ticker);
+
+			// Change iterator position to next element
+		} while (gtk_tree_model_iter_next (GTK_TREE_MODEL (model), &iter));
+
+		// Restore iterator position
+		gtk_tree_model_get_iter_first (GTK_TREE_MODEL (model), &iter);
+
+		// Init quote provider
+		ready = ready && provider -> Init (&error) && provider -> Begin (reinterpret_cast <const gchar* const*> (tickers -> pdata), tickers -> len, &error);
+
+		// Release array of tickers
+		g_ptr_array_free (tickers, TRUE);
+
+		// Check if quote provider is ready
+		if (!ready)
 			ShowErrorMessage (GTK_WINDOW (parent), "Stock synchronization failed", error);
 		else
 		{
+			// Create list of staged quote files
+			GPtrArray *staged = NewStagedLists ();
+
+			// Open stock panel to extend it with new quotes
+			Panel panel;
+			panel.Open (fname, NULL);
+
 			// Create new sync list
 			GtkListStore *list = gtk_list_store_new (SYNC_COLUMNS, G_TYPE_STRING, G_TYPE_INT, G_TYPE_INT64, G_TYPE_INT64, G_TYPE_STRING);
 
-			// Create good and bad lists
-			GList *good = NULL;
-			GList *bad = NULL;
+			// Create results of processed stocks
+			Results results;
+
+			// Create arena for per-stock memory
+			Arena arena;
 
 			// Get stocks count
 			gint records = 0;
 			gint errors = 0;
 			gint i = 0;
-			gint size = GetTotalCount (GTK_TREE_MODEL (model));
+			gint size = GetSelectedCount ();
+
+			// Create queue of tickers to retry
+			GQueue *retries = g_queue_new ();
+			gint repeats = 0;
+			gint resumed = 0;
+			gint current = 0;
 
 			// Create progress dialog
 			gboolean terminate = FALSE;
+			gboolean failed = FALSE;
 			ProgressDialog pwin = CreateProgressDialog (parent, "Syncing stock quotes...", &terminate);
 
+			// Clear window pointer when user closes progress dialog
+			g_object_add_weak_pointer (G_OBJECT (pwin.window), reinterpret_cast <gpointer*> (&pwin.window));
+
+			// Process events of progress dialog while provider waits between requests
+			provider -> SetWaitFunc (WaitProgress, &terminate);
+
 			// Iterate through all elements
 			do {
 				// Get stock details
-				gboolean state;
-				gchar *ticker, *status = NULL;
-				gtk_tree_model_get (GTK_TREE_MODEL (model), &iter, STOCK_CHECK_ID, &state, STOCK_TICKER_ID, &ticker, -1);
+				guint index;
+				gchar *ticker;
+				gtk_tree_model_get (GTK_TREE_MODEL (model), &iter, STOCK_TICKER_ID, &ticker, STOCK_INDEX_ID, &index, -1);
+
+				// Check if marked stock was synced for session by previous run
+				if (IsStockMarked (index) && IsSynced (&journal, ticker))
+				{
+					// Restore sync result from journal
+					const JournalEntry *entry = journal.Find (ticker);
+					SyncResult result = {TRUE, entry -> count, entry -> start, entry -> end, FALSE};
+					AddSyncResult (GTK_LIST_STORE (list), &results, NULL, 0, index, ticker, &result, NULL);
+
+					// Add quotes to stock panel in case it was not updated
+					AddPanelQuotes (fname, ticker, &panel, &arena);
+
+					// Release per-stock memory
+					arena.Reset ();
+
+					// Increment records count
+					records++;
+					resumed++;
+
+					// Increment processed stocks count
+					i++;
+				}
 
 				// Check if stock is marked
-				if (state)
+				else if (IsStockMarked (index))
 				{
 					// Create error object
 					GError *error = NULL;
 
 					// Sync quotes
-					SyncResult result = SyncQuotes (fname, ticker, &timezone, &client, &error);
-					if (!result.status)
-					{
-						// Set status message
-						status = g_strdup (error -> message);
+					SyncResult result = SyncQuotes (fname, ticker, &timezone, &calendar, provider, staged, &panel, &arena, &error);
+					current += result.current;
+
+					// Release per-stock memory
+					arena.Reset ();
 
-						// Append new element to reference list
-						bad = g_list_append (bad, gtk_tree_row_reference_new (GTK_TREE_MODEL (model), gtk_tree_model_get_path (GTK_TREE_MODEL (model), &iter)));
+					// Check if sync failed because of transient error
+					if (!result.status && g_error_matches (error, G_FILE_ERROR, G_FILE_ERROR_AGAIN))
+					{
+						// Schedule ticker for retry at the end of sync
+						SyncRetry *retry = g_new (SyncRetry, 1);
+						retry -> ticker = ticker;
+						retry -> index = index;
+						retry -> attempts = 1;
+						g_queue_push_tail (retries, retry);
 
 						// Release error object
 						g_error_free (error);
 
-						// Increment errors count
-						errors++;
+						// Ticker is owned by retry queue
+						ticker = NULL;
 					}
 					else
 					{
-						// Set status message
-						status = g_strdup (STRING_OK);
-
-						// Append new element to reference list
-						good = g_list_append (good, gtk_tree_row_reference_new (GTK_TREE_MODEL (model), gtk_tree_model_get_path (GTK_TREE_MODEL (model), &iter)));
+						// Add sync result to report
+						if (!AddSyncResult (GTK_LIST_STORE (list), &results, log, 1, index, ticker, &result, error))
+							errors++;
+
+						// Increment records count
+						records++;
+
+						// Increment processed stocks count
+						i++;
+
+						// Commit batch of synced stocks and stop sync if it fails
+						if (staged -> len >= JOURNAL_BATCH && !CommitBatch (parent, staged, &journal))
+						{
+							failed = TRUE;
+							terminate = TRUE;
+						}
 					}
+				}
+
+				// Free temporary string buffer
+				g_free (ticker);
+
+				// Set current progress and process pending events at limited rate
+				UpdateProgress (&pwin, i, size);
+
+				// Change iterator position to next element
+			} while (!terminate && gtk_tree_model_iter_next (GTK_TREE_MODEL (model), &iter));
+
+			// Retry tickers which failed because of transient errors
+			while (!terminate && !g_queue_is_empty (retries))
+			{
+				// Create error object
+				GError *error = NULL;
+
+				// Get next ticker to retry
+				SyncRetry *retry = reinterpret_cast <SyncRetry*> (g_queue_pop_head (retries));
+
+				// Sync quotes again
+				SyncResult result = SyncQuotes (fname, retry -> ticker, &timezone, &calendar, provider, staged, &panel, &arena, &error);
+				current += result.current;
+
+				// Release per-stock memory
+				arena.Reset ();
+
+				// Check if sync failed again because of transient error
+				repeats++;
+				retry -> attempts++;
+				if (!result.status && g_error_matches (error, G_FILE_ERROR, G_FILE_ERROR_AGAIN) && retry -> attempts < SYNC_ATTEMPTS)
+				{
+					// Schedule ticker for one more retry
+					g_queue_push_tail (retries, retry);
+
+					// Release error object
+					g_error_free (error);
+				}
+				else
+				{
+					// Add sync result to report
+					if (!AddSyncResult (GTK_LIST_STORE (list), &results, log, retry -> attempts, retry -> index, retry -> ticker, &result, error))
+						errors++;
+
+					// Free retry structure
+					FreeRetry (retry);
 
 					// Increment records count
 					records++;
 
-					// Add new element to list store object
-					GtkTreeIter liter;
-					gtk_list_store_append (GTK_LIST_STORE (list), &liter);
-					gtk_list_store_set (GTK_LIST_STORE (list), &liter, SYNC_TICKER_ID, ticker, SYNC_QUOTES_ID, result.count, SYNC_START_ID, result.start, SYNC_END_ID, result.end, SYNC_STATUS_ID, status, -1);
-
-					// Set current progress
+					// Increment processed stocks count
 					i++;
-					gdouble fraction = static_cast <gdouble> (i) / size;
-					if (GTK_IS_PROGRESS_BAR (pwin.progress))
-						gtk_progress_bar_set_fraction (GTK_PROGRESS_BAR (pwin.progress), fraction);
 
-					// Check if termination flag is set
-					if (terminate)
+					// Commit batch of synced stocks and stop sync if it fails
+					if (staged -> len >= JOURNAL_BATCH && !CommitBatch (parent, staged, &journal))
 					{
-						// Clear check list
-						gtk_list_store_clear (GTK_LIST_STORE (list));
+						failed = TRUE;
+						terminate = TRUE;
+					}
+				}
+
+				// Set current progress and process pending events at limited rate
+				UpdateProgress (&pwin, i, size);
+			}
 
-						// Decrement reference count to check list
-						g_object_unref (GTK_LIST_STORE (list));
+			// Record tickers which were left for retry when sync was terminated
+			while (!g_queue_is_empty (retries))
+			{
+				// Get next ticker to retry
+				SyncRetry *retry = reinterpret_cast <SyncRetry*> (g_queue_pop_head (retries));
 
-						// Release lists of references
-						g_list_free_full (good, reinterpret_cast <GDestroyNotify> (gtk_tree_row_reference_free));
-						g_list_free_full (bad, reinterpret_cast <GDestroyNotify> (gtk_tree_row_reference_free));
+				// Add failed sync result to report
+				SyncResult result = {FALSE, -1, static_cast <time_t> (TIME_ERROR), static_cast <time_t> (TIME_ERROR), FALSE};
+				GError *error = g_error_new (G_FILE_ERROR, G_FILE_ERROR_AGAIN, "Sync was terminated before retry");
+				AddSyncResult (GTK_LIST_STORE (list), &results, log, retry -> attempts, retry -> index, retry -> ticker, &result, error);
+				errors++;
 
-						// Free temporary string buffers
-						g_free (ticker);
-						g_free (status);
+				// Free retry structure
+				FreeRetry (retry);
 
-						// Return terminate state
-						return FALSE;
-					}
+				// Increment records count
+				records++;
+			}
+
+			// Release queue of tickers to retry
+			g_queue_free (retries);
+
+			// Stop processing events of progress dialog
+			provider -> SetWaitFunc (NULL, NULL);
+
+			// Get request statistics of quote provider
+			gchar *stats = provider -> GetStatistics ();
+
+			// Finish batch of requests
+			GError *finish = NULL;
+			provider -> End (&finish);
+
+			// Check if termination flag is set
+			if (terminate)
+			{
+				// Close progress window if sync was stopped by failed commit
+				if (pwin.window)
+				{
+					// Close progress window
+					gtk_window_close (GTK_WINDOW (pwin.window));
+
+					// Process pending events while termination flag exists
+					while (gtk_events_pending ())
+						gtk_main_iteration ();
 				}
 
-				// Free temporary string buffers
-				g_free (ticker);
-				g_free (status);
+				// Clear sync list
+				gtk_list_store_clear (GTK_LIST_STORE (list));
 
-				// Process pending events
-				while (gtk_events_pending ())
-					gtk_main_iteration ();
+				// Decrement reference count to sync list
+				g_object_unref (GTK_LIST_STORE (list));
 
-				// Change iterator position to next element
-			} while (gtk_tree_model_iter_next (GTK_TREE_MODEL (model), &iter));
+				// Free request statistics
+				g_free (stats);
+
+				// Show error of finishing batch of requests
+				if (finish)
+					ShowErrorMessage (GTK_WINDOW (parent), "Validator cache was not saved", finish);
+
+				// Commit quote files which were synced before termination,
+				// unless committing is what stopped the sync
+				if (!failed && CommitBatch (parent, staged, &journal) && !panel.Flush (fname, &error))
+					ShowErrorMessage (GTK_WINDOW (parent), "Stock panel update failed", error);
+
+				// Release list of staged quote files
+				g_ptr_array_free (staged, TRUE);
+
+				// Return terminate state
+				return FALSE;
+			}
 
 			// Close progress window
 			gtk_window_close (GTK_WINDOW (pwin.window));
 
+			// Commit synced quote files of last batch
+			if (CommitBatch (parent, staged, &journal) && !panel.Flush (fname, &error))
+				ShowErrorMessage (GTK_WINDOW (parent), "Stock panel update failed", error);
+
+			// Release list of staged quote files
+			g_ptr_array_free (staged, TRUE);
+
+			// Compose sync statistics
+			gchar *details = stats ? g_strdup_printf ("%s, %i retries, %i resumed, %i up to date", stats, repeats, resumed, current) : g_strdup_printf ("%i retries, %i resumed, %i up to date", repeats, resumed, current);
+			g_free (stats);
+
+			// Append error of finishing batch of requests to sync statistics
+			if (finish)
+			{
+				gchar *temp = g_strdup_printf ("%s, validator cache was not saved: %s", details, finish -> message);
+				g_free (details);
+				details = temp;
+				g_error_free (finish);
+			}
+
+			// Append stage measurements to profile log
+			SaveProfile (fname, "sync", NULL);
+
 			// Process pending events
 			while (gtk_events_pending ())
 				gtk_main_iteration ();
 
 			// Show report dialog
-			return CreateReportDialog (parent, "Sync report", "SyncReport.tsv", GTK_TREE_MODEL (model), GTK_TREE_MODEL (list), good, bad, CreateSyncList, SaveSyncReport, records, errors);
+			status = CreateReportDialog (parent, "Sync report", "SyncReport.tsv", GTK_TREE_MODEL (list), &results, CreateSyncList, SaveSyncReport, records, errors, details);
+
+			// Free sync statistics
+			g_free (details);
 		}
 	}
 
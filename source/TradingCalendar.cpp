@@ -0,0 +1,261 @@
+/*                                                           TradingCalendar.cpp
+################################################################################
+# Encoding: UTF-8                                                  Tab size: 4 #
+#                                                                              #
+#                            TRADING CALENDAR CLASS                            #
+#                                                                              #
+# License: LGPLv3+                               Copyleft (Ɔ) 2014, Jack Black #
+################################################################################
+*/
+# include	<TradingCalendar.h>
+# include	<Dates.h>
+
+//****************************************************************************//
+//      Internal constants                                                    //
+//****************************************************************************//
+# define	CALENDAR_MONDAY		0			// Week day numbers
+# define	CALENDAR_THURSDAY	3
+# define	CALENDAR_SATURDAY	5
+# define	CALENDAR_SUNDAY		6
+
+//****************************************************************************//
+//      Time zones which follow NYSE calendar                                 //
+//****************************************************************************//
+static const gchar *zones [] = {"America/New_York", "US/Eastern", "EST5EDT", NULL};
+
+//****************************************************************************//
+//      Internal functions                                                    //
+//****************************************************************************//
+
+//============================================================================//
+//      Get day start of time stamp                                           //
+//============================================================================//
+static time_t GetDayStart (time_t time)
+{
+	// Round time stamp down to day start
+	time_t number = time / TIME_DAY;
+	if (time % TIME_DAY < 0)
+		number--;
+
+	// Return day start
+	return number * TIME_DAY;
+}
+
+//============================================================================//
+//      Get week day of date (Monday is 0, 1970-01-01 is Thursday)            //
+//============================================================================//
+static guint GetWeekDay (time_t date)
+{
+	// Return week day number of day start
+	return ((GetDayStart (date) / TIME_DAY + 3) % 7 + 7) % 7;
+}
+
+//============================================================================//
+//      Get n-th week day of month                                            //
+//============================================================================//
+static time_t GetNthWeekDay (gint64 year, guint mon, guint wday, guint n)
+{
+	// Get week day of first day of month
+	time_t first = MakeDate (year, mon, 1);
+	guint offset = (wday + 7 - GetWeekDay (first)) % 7;
+
+	// Return date of n-th week day
+	return first + (offset + 7 * (n - 1)) * TIME_DAY;
+}
+
+//============================================================================//
+//      Get last week day of month                                            //
+//============================================================================//
+static time_t GetLastWeekDay (gint64 year, guint mon, guint days, guint wday)
+{
+	// Get week day of last day of month
+	time_t last = MakeDate (year, mon, days);
+	guint offset = (GetWeekDay (last) + 7 - wday) % 7;
+
+	// Return date of last week day
+	return last - offset * TIME_DAY;
+}
+
+//============================================================================//
+//      Get observed date of fixed holiday                                    //
+//============================================================================//
+static time_t GetObserved (time_t date)
+{
+	// Saturday holiday is observed on Friday, Sunday holiday on Monday
+	switch (GetWeekDay (date))
+	{
+		case CALENDAR_SATURDAY:
+			return date - TIME_DAY;
+		case CALENDAR_SUNDAY:
+			return date + TIME_DAY;
+		default:
+			return date;
+	}
+}
+
+//============================================================================//
+//      Get Easter Sunday date (anonymous Gregorian algorithm)                //
+//============================================================================//
+static time_t GetEaster (gint64 year)
+{
+	// Compute paschal full moon and week day corrections
+	gint64 a = year % 19;
+	gint64 b = year / 100;
+	gint64 c = year % 100;
+	gint64 d = b / 4;
+	gint64 e = b % 4;
+	gint64 f = (b + 8) / 25;
+	gint64 g = (b - f + 1) / 3;
+	gint64 h = (19 * a + b - d - g + 15) % 30;
+	gint64 i = c / 4;
+	gint64 k = c % 4;
+	gint64 l = (32 + 2 * e + 2 * i - h - k) % 7;
+	gint64 m = (a + 11 * h + 22 * l) / 451;
+
+	// Return Easter date (month is x / 31, day is x % 31 + 1)
+	gint64 x = h + l - 7 * m + 114;
+	return MakeDate (year, x / 31, x % 31 + 1);
+}
+
+//****************************************************************************//
+//      Constructor                                                           //
+//****************************************************************************//
+TradingCalendar::TradingCalendar (void)
+{
+	// Set calendar elements to default values
+	exchange = FALSE;
+	year = 0;
+	count = 0;
+}
+
+//****************************************************************************//
+//      Compute holidays of year                                              //
+//****************************************************************************//
+void TradingCalendar::SetYear (gint64 year)
+{
+	// Set year of holiday table
+	this -> year = year;
+	count = 0;
+
+	// New Year's Day (not observed on Friday before when it is Saturday)
+	time_t date = MakeDate (year, 1, 1);
+	if (GetWeekDay (date) != CALENDAR_SATURDAY)
+		holidays [count++] = GetObserved (date);
+
+	// Martin Luther King Jr. Day (third Monday of January since 1998)
+	if (year >= 1998)
+		holidays [count++] = GetNthWeekDay (year, 1, CALENDAR_MONDAY, 3);
+
+	// Washington's Birthday (third Monday of February)
+	holidays [count++] = GetNthWeekDay (year, 2, CALENDAR_MONDAY, 3);
+
+	// Good Friday
+	holidays [count++] = GetEaster (year) - 2 * TIME_DAY;
+
+	// Memorial Day (last Monday of May)
+	holidays [count++] = GetLastWeekDay (year, 5, 31, CALENDAR_MONDAY);
+
+	// Juneteenth (since 2022)
+	if (year >= 2022)
+		holidays [count++] = GetObserved (MakeDate (year, 6, 19));
+
+	// Independence Day
+	holidays [count++] = GetObserved (MakeDate (year, 7, 4));
+
+	// Labor Day (first Monday of September)
+	holidays [count++] = GetNthWeekDay (year, 9, CALENDAR_MONDAY, 1);
+
+	// Thanksgiving Day (fourth Thursday of November)
+	holidays [count++] = GetNthWeekDay (year, 11, CALENDAR_THURSDAY, 4);
+
+	// Christmas Day
+	holidays [count++] = GetObserved (MakeDate (year, 12, 25));
+}
+
+//****************************************************************************//
+//      Select exchange rules by time zone file name                          //
+//****************************************************************************//
+void TradingCalendar::Init (const gchar *tzone)
+{
+	// Set calendar elements to default values
+	exchange = FALSE;
+	year = 0;
+	count = 0;
+
+	// Check if time zone file is one of NYSE time zones
+	for (guint i = 0; tzone && zones [i]; i++)
+		exchange |= g_str_has_suffix (tzone, zones [i]);
+}
+
+//****************************************************************************//
+//      Check if date is trading day                                          //
+//****************************************************************************//
+gboolean TradingCalendar::IsTradingDay (time_t date)
+{
+	// Week ends are never trading days
+	date = GetDayStart (date);
+	if (GetWeekDay (date) >= CALENDAR_SATURDAY)
+		return FALSE;
+
+	// Without exchange rules every week day is trading day
+	if (!exchange)
+		return TRUE;
+
+	// Compute holidays of date year if they are not cached
+	gint64 current = GetDate (date).year;
+	if (current != year || count == 0)
+		SetYear (current);
+
+	// Check if date is holiday
+	for (guint i = 0; i < count; i++)
+	{
+		if (holidays [i] == date)
+			return FALSE;
+	}
+
+	// Date is trading day
+	return TRUE;
+}
+
+//****************************************************************************//
+//      Get date of latest closed trading session                             //
+//****************************************************************************//
+time_t TradingCalendar::GetLatestSession (time_t time)
+{
+	// Session of current day is not closed yet
+	time_t date = GetDayStart (time);
+	if (time - date < CALENDAR_CLOSE_TIME)
+		date -= TIME_DAY;
+
+	// Step back over week ends and holidays
+	while (!IsTradingDay (date))
+		date -= TIME_DAY;
+
+	// Return session date
+	return date;
+}
+
+//****************************************************************************//
+//      Check if stored quotes already have latest session                    //
+//****************************************************************************//
+gboolean TradingCalendar::IsCovered (time_t last, time_t synctime, time_t time)
+{
+	// Check if quotes were ever synced
+	if (synctime == static_cast <time_t> (TIME_ERROR))
+		return FALSE;
+
+	// Get latest session and its close time
+	time_t session = GetLatestSession (time);
+	time_t close = session + CALENDAR_CLOSE_TIME;
+
+	// Session bar is stored and it was synced after session close, or
+	// provider was already asked when session quotes should be published
+	if (last != static_cast <time_t> (TIME_ERROR) && last >= session && synctime >= close)
+		return TRUE;
+	return synctime >= close + CALENDAR_SETTLE_TIME;
+}
+/*
+################################################################################
+#                                 END OF FILE                                  #
+################################################################################
+*/
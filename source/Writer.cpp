@@ -0,0 +1,442 @@
+/*                                                                    Writer.cpp
+################################################################################
+# Encoding: UTF-8                                                  Tab size: 4 #
+#                                                                              #
+#                                 WRITER CLASS                                 #
+#                                                                              #
+# License: LGPLv3+                               Copyleft (Ɔ) 2014, Jack Black #
+################################################################################
+*/
+# include	<Writer.h>
+# include	<Dates.h>
+# include	<glib/gstdio.h>
+# include	<string.h>
+# include	<math.h>
+# include	<float.h>
+# include	<errno.h>
+# include	<fcntl.h>
+# include	<unistd.h>
+
+//****************************************************************************//
+//      Internal functions                                                    //
+//****************************************************************************//
+
+//============================================================================//
+//      Format unsigned integer and return its length                         //
+//============================================================================//
+static gsize FormatUnsigned (guint64 value, gchar *buffer)
+{
+	// Write digits in reverse order
+	gchar digits [24];
+	gsize count = 0;
+	do {
+		digits [count++] = '0' + value % 10;
+		value /= 10;
+	} while (value);
+
+	// Copy digits into buffer
+	for (gsize i = 0; i < count; i++)
+		buffer [i] = digits [count - i - 1];
+
+	// Return length of number
+	return count;
+}
+
+//****************************************************************************//
+//      Constructor                                                           //
+//****************************************************************************//
+Writer::Writer (void)
+{
+	// Set writer elements to default values
+	fname = NULL;
+	temp = NULL;
+	fd = -1;
+	errnum = 0;
+	format = WRITER_TSV;
+	first = TRUE;
+	size = 0;
+}
+
+//****************************************************************************//
+//      Destructor                                                            //
+//****************************************************************************//
+Writer::~Writer (void)
+{
+	// Remove temporary file of unclosed writer
+	if (fd >= 0)
+	{
+		close (fd);
+		g_unlink (temp);
+	}
+
+	// Free writer elements
+	Free ();
+}
+
+//****************************************************************************//
+//      Free writer elements                                                  //
+//****************************************************************************//
+void Writer::Free (void)
+{
+	// Free writer elements
+	g_free (fname);
+	g_free (temp);
+
+	// Set writer elements to default values
+	fname = NULL;
+	temp = NULL;
+	fd = -1;
+	errnum = 0;
+	first = TRUE;
+	size = 0;
+}
+
+//****************************************************************************//
+//      Flush buffer into file                                                //
+//****************************************************************************//
+void Writer::Flush (void)
+{
+	// Write buffer content unless previous write failed
+	gsize bytes = 0;
+	while (errnum == 0 && bytes < size)
+	{
+		gssize count = write (fd, buffer + bytes, size - bytes);
+		if (count < 0 && errno == EINTR)
+			continue;
+		if (count <= 0)
+			errnum = count ? errno : EIO;
+		else
+			bytes += count;
+	}
+
+	// Mark buffer as empty
+	size = 0;
+}
+
+//****************************************************************************//
+//      Reserve space into buffer                                             //
+//****************************************************************************//
+gchar* Writer::Reserve (gsize bytes)
+{
+	// Flush buffer if it has not enough space
+	if (size + bytes > WRITER_BUFFER_SIZE)
+		Flush ();
+
+	// Return free space of buffer
+	return buffer + size;
+}
+
+//****************************************************************************//
+//      Start new field                                                       //
+//****************************************************************************//
+void Writer::StartField (void)
+{
+	// Put field separator before all fields except first one
+	if (!first && format != WRITER_BINARY)
+	{
+		*Reserve (sizeof (gchar)) = format == WRITER_CSV ? ',' : '\t';
+		size++;
+	}
+
+	// Next fields are not first
+	first = FALSE;
+}
+
+//****************************************************************************//
+//      Get writer format from file extension                                 //
+//****************************************************************************//
+guint Writer::GetFormat (const gchar *fname)
+{
+	// Check file extension
+	if (g_str_has_suffix (fname, ".bin"))
+		return WRITER_BINARY;
+	else
+		return GetTextFormat (fname);
+}
+
+//****************************************************************************//
+//      Get text writer format from file extension                            //
+//****************************************************************************//
+guint Writer::GetTextFormat (const gchar *fname)
+{
+	// Check file extension
+	if (g_str_has_suffix (fname, ".csv"))
+		return WRITER_CSV;
+	else
+		return WRITER_TSV;
+}
+
+//****************************************************************************//
+//      Open writer file                                                      //
+//****************************************************************************//
+gboolean Writer::Open (const gchar *fname, guint format, GError **error)
+{
+	// Remove temporary file of previous unclosed file
+	if (fd >= 0)
+	{
+		close (fd);
+		g_unlink (temp);
+	}
+
+	// Free writer elements
+	Free ();
+
+	// Try to create temporary file
+	gchar *name = g_strconcat (fname, WRITER_TEMP_EXT, NULL);
+	gint file = g_open (name, O_WRONLY | O_CREAT | O_TRUNC, 0666);
+	if (file < 0)
+	{
+		// Set error message
+		gint code = errno;
+		g_set_error (error, G_FILE_ERROR, g_file_error_from_errno (code), "Failed to create file '%s': %s", name, g_strerror (code));
+
+		// Free temporary string buffer
+		g_free (name);
+
+		// Return fail status
+		return FALSE;
+	}
+
+	// Set new writer elements
+	this -> fname = g_strdup (fname);
+	this -> temp = name;
+	this -> fd = file;
+	this -> format = format;
+
+	// Return success state
+	return TRUE;
+}
+
+//****************************************************************************//
+//      Close writer file                                                     //
+//****************************************************************************//
+gboolean Writer::Close (GError **error)
+{
+	// Operation status
+	gboolean status = TRUE;
+
+	// Write rest of buffer
+	Flush ();
+
+	// Close temporary file
+	if (close (fd) != 0 && errnum == 0)
+		errnum = errno;
+	fd = -1;
+
+	// Check if all writes were successful
+	if (errnum)
+	{
+		// Set error message
+		g_set_error (error, G_FILE_ERROR, g_file_error_from_errno (errnum), "Failed to write file '%s': %s", temp, g_strerror (errnum));
+
+		// Remove temporary file
+		g_unlink (temp);
+
+		// Set fail status
+		status = FALSE;
+	}
+
+	// Replace target file by temporary file
+	else if (g_rename (temp, fname) != 0)
+	{
+		// Set error message
+		gint code = errno;
+		g_set_error (error, G_FILE_ERROR, g_file_error_from_errno (code), "Failed to rename file '%s' to '%s': %s", temp, fname, g_strerror (code));
+
+		// Remove temporary file
+		g_unlink (temp);
+
+		// Set fail status
+		status = FALSE;
+	}
+
+	// Free writer elements
+	Free ();
+
+	// Return file operation status
+	return status;
+}
+
+//****************************************************************************//
+//      Add string field                                                      //
+//****************************************************************************//
+void Writer::AddString (const gchar *string)
+{
+	// Start new field
+	StartField ();
+
+	// Write missing string as empty field
+	if (string == NULL)
+		return;
+
+	// Check if string should be quoted for CSV format
+	gboolean quote = format == WRITER_CSV && strpbrk (string, ",\"\n") != NULL;
+	if (quote)
+	{
+		*Reserve (sizeof (gchar)) = '"';
+		size++;
+	}
+
+	// Copy string into buffer
+	while (*string)
+	{
+		// Double quotes inside quoted string
+		if (quote && *string == '"')
+		{
+			*Reserve (sizeof (gchar)) = '"';
+			size++;
+		}
+
+		// Copy string symbol
+		*Reserve (sizeof (gchar)) = *string++;
+		size++;
+	}
+
+	// Close quoted string
+	if (quote)
+	{
+		*Reserve (sizeof (gchar)) = '"';
+		size++;
+	}
+}
+
+//****************************************************************************//
+//      Add date field                                                        //
+//****************************************************************************//
+void Writer::AddDate (time_t date)
+{
+	// Start new field
+	StartField ();
+
+	// Format date into buffer
+	size += FormatDate (date, Reserve (DATE_SIZE));
+}
+
+//****************************************************************************//
+//      Add integer field                                                     //
+//****************************************************************************//
+void Writer::AddInt (gint64 value)
+{
+	// Start new field
+	StartField ();
+
+	// Reserve space into buffer
+	gchar *pos = Reserve (WRITER_FIELD_SIZE);
+
+	// Put sign of negative number
+	guint64 number = value;
+	if (value < 0)
+	{
+		*pos++ = '-';
+		size++;
+		number = -number;
+	}
+
+	// Format absolute value of number
+	size += FormatUnsigned (number, pos);
+}
+
+//****************************************************************************//
+//      Add number field with fixed count of fraction digits                  //
+//****************************************************************************//
+void Writer::AddNumber (gdouble value, guint digits)
+{
+	// Start new field
+	StartField ();
+
+	// Reserve space into buffer
+	gchar *pos = Reserve (WRITER_FIELD_SIZE);
+
+	// Get scale of fraction part
+	guint64 scale = 1;
+	digits = MIN (digits, WRITER_MAX_DIGITS);
+	for (guint i = 0; i < digits; i++)
+		scale *= 10;
+
+	// Use printf formatting for special and very large numbers
+	gdouble absolute = fabs (value);
+	gdouble scaled = absolute * scale;
+	if (!(scaled < WRITER_EXACT_LIMIT))
+	{
+		size += g_snprintf (pos, WRITER_FIELD_SIZE, "%.*g", DBL_DIG, value);
+		return;
+	}
+
+	// Get exact error of scaled value and split it into whole and fraction parts
+	gdouble error = fma (absolute, static_cast <gdouble> (scale), -scaled);
+	gdouble whole = floor (scaled);
+	gdouble part = scaled - whole;
+
+	// Round exact value like printf does (ties go to even number)
+	if (part > 0.5 || (part == 0.5 && (error > 0.0 || (error == 0.0 && fmod (whole, 2.0) != 0.0))))
+		whole += 1.0;
+	guint64 number = whole;
+
+	// Put sign of negative number like printf does
+	if (signbit (value))
+	{
+		*pos++ = '-';
+		size++;
+	}
+
+	// Format integer part
+	gsize length = FormatUnsigned (number / scale, pos);
+	pos += length;
+	size += length;
+
+	// Format fraction part
+	if (digits)
+	{
+		*pos++ = '.';
+		guint64 fraction = number % scale;
+		for (guint i = digits; i > 0; i--)
+		{
+			pos [i - 1] = '0' + fraction % 10;
+			fraction /= 10;
+		}
+		size += digits + 1;
+	}
+}
+
+//****************************************************************************//
+//      Add raw binary data                                                   //
+//****************************************************************************//
+void Writer::AddData (gconstpointer data, gsize bytes)
+{
+	// Copy data into buffer by parts
+	const gchar *ptr = reinterpret_cast <const gchar*> (data);
+	while (bytes)
+	{
+		// Flush buffer if it is full
+		if (size == WRITER_BUFFER_SIZE)
+			Flush ();
+
+		// Copy part of data
+		gsize count = MIN (bytes, WRITER_BUFFER_SIZE - size);
+		memcpy (buffer + size, ptr, count);
+		size += count;
+		ptr += count;
+		bytes -= count;
+	}
+}
+
+//****************************************************************************//
+//      End of row                                                            //
+//****************************************************************************//
+void Writer::EndRow (void)
+{
+	// Put end of line for text formats
+	if (format != WRITER_BINARY)
+	{
+		*Reserve (sizeof (gchar)) = '\n';
+		size++;
+	}
+
+	// Next field is first field of new row
+	first = TRUE;
+}
+/*
+################################################################################
+#                                 END OF FILE                                  #
+################################################################################
+*/